@@ -0,0 +1,87 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___ATLAS_PRIVATE_H
+#define ___CNVX___ATLAS_PRIVATE_H
+
+#include "cnvx/renderer/renderer.h"
+
+#include "sprx/core/essentials.h"
+
+#define CNVX_ATLAS_PADDING 1 //texels of extruded border around every image, keeps filtering from bleeding
+#define CNVX_ATLAS_SHELF_COUNT_MAX 256
+#define CNVX_ATLAS_ENTRY_CAPACITY_MIN 64
+
+//a row of images sharing a height, filled from left to right
+typedef struct CNVX_Atlas_Shelf_PRIVATE
+{
+    uint32_t y;
+    uint32_t height;
+    uint32_t width_used;
+} CNVX_Atlas_Shelf_PRIVATE;
+
+typedef struct CNVX_Atlas_Page_PRIVATE
+{
+    bool live_is;
+    uint32_t texture_index;
+    uint64_t use_serial; //frame that last drew from the page, eviction picks the oldest
+    uint32_t height_used;
+    uint32_t shelf_count;
+    CNVX_Atlas_Shelf_PRIVATE shelf_all[CNVX_ATLAS_SHELF_COUNT_MAX];
+} CNVX_Atlas_Page_PRIVATE;
+
+//x and y point at the padded cell, the image starts CNVX_ATLAS_PADDING texels inside
+typedef struct CNVX_Atlas_Entry_PRIVATE
+{
+    bool used_is;
+    uint64_t key;
+    uint32_t page;
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+} CNVX_Atlas_Entry_PRIVATE;
+
+typedef struct CNVX_Atlas_PRIVATE
+{
+    uint32_t page_size;
+    uint32_t page_count;
+    CNVX_Atlas_Page_PRIVATE page_all[CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX];
+    CNVX_Atlas_Entry_PRIVATE* entry_all; //open addressing with linear probing, the capacity is a power of two
+    size_t entry_capacity;
+    size_t entry_count;
+} CNVX_Atlas_PRIVATE;
+
+void canvas_atlas_create(CNVX_Atlas_PRIVATE* const atlas, const uint32_t page_size);
+void canvas_atlas_destroy(CNVX_Atlas_PRIVATE* const atlas);
+
+//=NULL if the key is not in the atlas
+CNVX_Atlas_Entry_PRIVATE* canvas_atlas_find(CNVX_Atlas_PRIVATE* const atlas, const uint64_t key);
+//the key must not be in the atlas yet, width and height include the padding
+CNVX_Atlas_Entry_PRIVATE* canvas_atlas_insert(CNVX_Atlas_PRIVATE* const atlas, const uint64_t key, const uint32_t page, const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height);
+
+//best height fit among the shelves, opens a new shelf if none fits well, returns false if the page is full
+bool canvas_atlas_page_pack(CNVX_Atlas_PRIVATE* const atlas, const uint32_t page, const uint32_t width, const uint32_t height, uint32_t* const x, uint32_t* const y);
+//forgets every entry of the page and empties it
+void canvas_atlas_page_evict(CNVX_Atlas_PRIVATE* const atlas, const uint32_t page);
+
+#endif // ___CNVX___ATLAS_PRIVATE_H
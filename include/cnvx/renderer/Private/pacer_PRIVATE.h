@@ -0,0 +1,54 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___PACER_PRIVATE_H
+#define ___CNVX___PACER_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#define CNVX_PACER_SLACK_MIN 100000 //ns, sleeps are never trusted closer than this
+#define CNVX_PACER_SLACK_DEFAULT 1000000
+
+//times in nanoseconds of the monotonic clock
+typedef struct CNVX_Pacer_PRIVATE
+{
+    int64_t period; //=0 disables pacing
+    int64_t deadline; //submission of the next frame, =0 until the first one
+    int64_t wake;
+    int64_t work_estimate; //decaying maximum of wake up to submission
+    int64_t slack; //decaying maximum of the sleep overshoot, covered by spinning
+    size_t frame_count;
+    size_t missed_count;
+    bool waited_is; //the wait of the next frame is done, later calls return until the submission
+} CNVX_Pacer_PRIVATE;
+
+int64_t canvas_pacer_now(void);
+
+void canvas_pacer_reset(CNVX_Pacer_PRIVATE* const pacer, const int64_t period);
+//keeps the counters and estimates, the next submission starts a new deadline chain
+void canvas_pacer_period_set(CNVX_Pacer_PRIVATE* const pacer, const int64_t period);
+//sleeps until the frame has to start to meet its deadline, the last stretch is spun, once per frame
+void canvas_pacer_wait(CNVX_Pacer_PRIVATE* const pacer);
+//called right after the submission, a late frame moves the deadlines instead of catching up
+void canvas_pacer_submitted(CNVX_Pacer_PRIVATE* const pacer);
+
+#endif // ___CNVX___PACER_PRIVATE_H
@@ -24,16 +24,60 @@
 #define ___CNVX___RENDERER_PRIVATE_H
 
 #include "cnvx/renderer/renderer.h"
+#include "cnvx/renderer/Private/atlas_PRIVATE.h"
+#include "cnvx/renderer/Private/pacer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_descriptor_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_graph_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_pipeline_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_readback_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_reload_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_texture_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_timestamp_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_transfer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_uniform_PRIVATE.h"
+#include "cnvx/renderer/Private/worker_PRIVATE.h"
 
 #include "vulkan/vulkan.h"
 
+#define CNVX_RENDERER_DRAW_GROWTH 64
+//below this many draws per list recording is not worth a worker round trip
+#define CNVX_RENDERER_RECORD_DRAW_COUNT_MIN 256
+
 typedef struct CNVX_Renderer_Shader_PRIVATE
 {
     CNVX_Renderer_Shader_Type type;
     uint32_t size;
     const char* data;
+    void* path; //spore string of the loaded file
+    bool owned_is; //data was allocated by a reload, otherwise it is mmapped
 } CNVX_Renderer_Shader_PRIVATE;
 
+typedef enum CNVX_Renderer_Pipeline_PRIVATE
+{
+    CNVX_RENDERER_PIPELINE_GEOMETRY,
+    CNVX_RENDERER_PIPELINE_QUAD,
+    ___CNVX_RENDERER_PIPELINE_MAX,
+} CNVX_Renderer_Pipeline_PRIVATE;
+
+//offsets are in elements of the frame arena buffer
+typedef struct CNVX_Renderer_Draw_PRIVATE
+{
+    CNVX_Renderer_Pipeline_PRIVATE pipeline;
+    uint32_t variant; //index into pipeline_variant_all
+    VkBuffer buffer;
+    VkBuffer index_buffer; //=VK_NULL_HANDLE if not indexed or the pipeline brings its own indices
+    uint32_t vertex_first;
+    uint32_t vertex_count;
+    uint32_t index_first;
+    uint32_t index_count; //=0 for a non indexed draw
+    uint32_t instance_first;
+    uint32_t instance_count;
+    uint32_t uniform_offset; //=CNVX_VULKAN_UNIFORM_OFFSET_NONE reads the frame block
+    CNVX_Vulkan_Push_Constant_PRIVATE push_constant;
+} CNVX_Renderer_Draw_PRIVATE;
+
 typedef struct CNVX_Renderer_PRIVATE
 {
     size_t id;
@@ -45,8 +89,12 @@ typedef struct CNVX_Renderer_PRIVATE
     size_t width;
     size_t height;
     void* shader_vec;
+    void* draw_vec;
     void* logger;
     void* window;
+    void* worker;
+    CNVX_Pacer_PRIVATE pacer;
+    CNVX_Atlas_PRIVATE atlas;
     bool started_is;
     bool prepared_is;
     CNVX_Renderer_Settings settings;
@@ -62,40 +110,165 @@ typedef struct CNVX_Renderer_PRIVATE
         VkPhysicalDeviceProperties* physical_device_properties_all;
         VkPhysicalDeviceFeatures* physical_device_features_all;
         VkPhysicalDeviceMemoryProperties* physical_device_memory_properties_all;
+        uint32_t* physical_device_extension_count_all;
+        VkExtensionProperties** physical_device_extension_all;
 
         uint32_t queue_family_count;
         VkQueueFamilyProperties* queue_family_properties;
         VkDevice device;
         VkQueue queue;
         uint32_t queue_family_use_index;
+        VkQueue queue_transfer;
+        uint32_t queue_family_transfer_index;
+        bool timeline_semaphore_is;
+        bool descriptor_indexing_is;
+        bool transfer_dedicated_is; //separate queue family, handed off with a timeline semaphore
+
+        uint32_t device_extension_count;
+        VkExtensionProperties* device_extension_all; //of the device in use, owned by physical_device_extension_all
+
+        bool pipeline_creation_feedback_is;
+        bool dynamic_rendering_is; //=false renders through renderer_pass and framebuffer_all
+        PFN_vkCmdBeginRenderingKHR cmd_begin_rendering;
+        PFN_vkCmdEndRenderingKHR cmd_end_rendering;
+        void* memory_mutex;
+        uint32_t memory_allocation_count;
+        CNVX_Vulkan_Memory_Page_PRIVATE* memory_page_first_all[VK_MAX_MEMORY_TYPES][2][CNVX_VULKAN_MEMORY_CLASS_COUNT]; //[type][linear][class]
+        CNVX_Renderer_Memory_Stats memory_stats;
+        VkBuffer* memory_linear_buffer_all;
+        CNVX_Vulkan_Allocation_PRIVATE* memory_linear_allocation_all;
+        VkDeviceSize memory_linear_size;
+        VkDeviceSize memory_linear_head;
+
+        void* deferred_mutex;
+        void* deferred_vec;
+        void* deferred_spare_vec;
+
+        VkDescriptorSetLayout descriptor_set_layout;
+        VkDescriptorPool descriptor_pool; //update after bind pool of the bindless set
+        VkDescriptorSet descriptor_set;
+        uint32_t descriptor_count_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX];
+        uint32_t* descriptor_free_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX];
+        uint32_t descriptor_free_count_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX];
+        void* descriptor_mutex;
+        VkSampler descriptor_sampler_all[___CNVX_VULKAN_DESCRIPTOR_SAMPLER_MAX];
+        void* descriptor_frame_pool_vec_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX];
+        uint32_t descriptor_frame_pool_index_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX];
+
+        VkPipelineCache pipeline_cache;
+        void* pipeline_cache_mutex;
+        CNVX_Renderer_Pipeline_Cache_Stats pipeline_cache_stats;
 
         VkSurfaceKHR surface;
         VkBool32 surface_support_is;
         VkSurfaceCapabilitiesKHR surface_capabilities;
         VkSurfaceFormatKHR* surface_format_all;
+        uint32_t surface_present_mode_all_count;
         VkPresentModeKHR* surface_present_mode_all;
+        CNVX_Renderer_Present_Mode present_mode_use;
 
         VkSwapchainKHR swapchain;
         uint32_t swapchain_image_all_count;
         VkImage* swapchain_image_all;
+        CNVX_Vulkan_Allocation_PRIVATE* headless_allocation_all; //backs swapchain_image_all in headless mode, one image per frame
 
         VkImageView* image_view_all;
 
         uint32_t shader_module_count;
         VkShaderModule* shader_module_all;
+        CNVX_Worker_Job_PRIVATE* shader_job_all;
 
         VkPipelineLayout pipeline_layout;
         VkRenderPass renderer_pass;
-        VkPipeline pipeline;
+        CNVX_Vulkan_Pipeline_Variant_PRIVATE pipeline_variant_all[CNVX_VULKAN_PIPELINE_VARIANT_COUNT_MAX];
+        uint32_t pipeline_variant_count;
+        uint32_t pipeline_variant_wait_count; //variants below are built
+        uint32_t pipeline_variant_slot_all[CNVX_VULKAN_PIPELINE_SLOT_COUNT]; //hashed keys, =CNVX_VULKAN_PIPELINE_VARIANT_NONE if empty
+        CNVX_Renderer_Draw_State pipeline_draw_state; //selects the variant of the following draws
+
+        int reload_fd; //inotify instance, =-1 if shader reload is off
+        CNVX_Vulkan_Reload_Shader_PRIVATE* reload_shader_all; //per shader module
+        CNVX_Worker_Job_PRIVATE reload_job;
+        bool reload_pending_is; //reload_job was submitted and is not swapped in yet
+        VkResult reload_result; //of reload_job, the old shaders are kept on failure
+        uint32_t reload_variant_count; //variants that existed when reload_job was submitted
+        VkPipeline reload_pipeline_all[CNVX_VULKAN_PIPELINE_VARIANT_COUNT_MAX]; //rebuilt variants, =VK_NULL_HANDLE if unaffected
+
+        VkBuffer quad_buffer; //unit quad corners followed by its indices
+        CNVX_Vulkan_Allocation_PRIVATE quad_allocation;
 
         VkFramebuffer* framebuffer_all;
 
-        VkCommandPool commandpool;
+        VkCommandPool* commandpool_all; //per frame, reset as a whole once the frame fence signaled
+
+        uint32_t frame_count;
+        uint32_t frame_index;
+        bool frame_begun_is;
 
         VkCommandBuffer* commandbuffer_all;
 
-        VkSemaphore semaphore_image_available;
-        VkSemaphore semaphore_rendering_done;
+        //secondary recording, one pool and buffer per draw list and frame at [frame * record_list_count + list]
+        uint32_t record_list_count;
+        uint32_t record_list_use_count;
+        uint32_t record_image_index;
+        VkCommandPool* record_commandpool_all;
+        VkCommandBuffer* record_commandbuffer_all;
+        CNVX_Worker_Job_PRIVATE record_job_all[CNVX_WORKER_THREAD_COUNT_MAX];
+
+        VkSemaphore* semaphore_image_available_all;
+        VkSemaphore* semaphore_rendering_done_all;
+
+        VkFence* fence_frame_all;
+        uint64_t frame_serial;
+        uint64_t frame_serial_submitted_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX];
+        uint64_t frame_serial_done_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX];
+
+        CNVX_Vulkan_Readback_Slot_PRIVATE readback_slot_all[CNVX_RENDERER_READBACK_RING_COUNT];
+        CNVX_Vulkan_Readback_Slot_PRIVATE* readback_slot_record; //reserved for the frame being recorded
+        bool readback_requested_is;
+        bool readback_supported_is; //=false if the swapchain images can not be a transfer source
+
+        VkQueryPool timestamp_querypool; //=VK_NULL_HANDLE if timestamps are not supported, ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX per frame
+        uint64_t timestamp_mask;
+        float timestamp_period; //nanoseconds per tick
+        CNVX_Vulkan_Timestamp_History_PRIVATE timestamp_history_all[CNVX_VULKAN_TIMESTAMP_SERIES_COUNT];
+        size_t timestamp_region_draw_first_all[CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX];
+        size_t timestamp_region_draw_last_all[CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX];
+        uint32_t timestamp_region_begun_mask;
+        uint32_t timestamp_region_ended_mask;
+
+        CNVX_Vulkan_Texture_PRIVATE* texture_all; //indexed like the texture binding of the bindless set
+        void* texture_upload_vec; //recorded into the next frame
+        bool texture_mip_is; //=false if the format can not be blitted with linear filtering
+
+        VkDescriptorSetLayout uniform_set_layout;
+        VkDescriptorPool uniform_pool;
+        VkDescriptorSet uniform_set_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX]; //bound to the frame arena buffer of the same index
+        VkDeviceSize uniform_alignment;
+        CNVX_Renderer_Frame_Uniform uniform_frame;
+        void* uniform_frame_data; //reserved at the start of the frame arena
+        uint32_t uniform_frame_offset;
+        uint32_t uniform_draw_offset;
+
+        CNVX_Vulkan_Graph_PRIVATE graph;
+        uint32_t graph_backbuffer; //the swapchain image of the frame, bound before execution
+        uint32_t graph_pass_main;
+        uint32_t graph_pass_readback; //enabled only in frames that capture the image
+
+        VkCommandPool transfer_commandpool;
+        CNVX_Vulkan_Transfer_Batch_PRIVATE transfer_batch_all[CNVX_VULKAN_TRANSFER_BATCH_COUNT];
+        uint32_t transfer_batch_index;
+        uint32_t transfer_batch_retire_index;
+        bool transfer_batch_open_is;
+        VkSemaphore transfer_semaphore;
+        uint64_t transfer_value;
+        uint64_t transfer_value_waited;
+        VkBuffer transfer_staging_buffer;
+        CNVX_Vulkan_Allocation_PRIVATE transfer_staging_allocation;
+        void* transfer_staging_data;
+        VkDeviceSize transfer_staging_size;
+        VkDeviceSize transfer_staging_head;
+        VkDeviceSize transfer_staging_used;
     } vk;
 } CNVX_Renderer_PRIVATE;
 
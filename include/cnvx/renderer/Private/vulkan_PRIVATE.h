@@ -23,6 +23,10 @@
 #ifndef ___CNVX___VULKAN_PRIVATE_H
 #define ___CNVX___VULKAN_PRIVATE_H
 
+#include "cnvx/renderer/renderer.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_pipeline_PRIVATE.h"
+
 #include "sprx/core/essentials.h"
 #include "sprx/core/terminate.h"
 
@@ -54,25 +58,48 @@ void canvas_vulkan_instance_destroy(void* const renderer);
 
 void canvas_vulkan_physical_devices_enumerate(void* const renderer);
 void canvas_vulkan_physical_devices_denumerate(void* const renderer);
+void canvas_vulkan_physical_device_select(void* const renderer);
 
 void canvas_vulkan_device_create(void* const renderer);
 void canvas_vulkan_device_destroy(void* const renderer);
 
+bool canvas_vulkan_device_extension_available_is(void* const renderer, const char* const name);
+
+void canvas_vulkan_pipeline_cache_create(void* const renderer);
+void canvas_vulkan_pipeline_cache_destroy(void* const renderer);
+
+//must be created after the transfer and destroyed after it was drained
+void canvas_vulkan_quad_create(void* const renderer);
+void canvas_vulkan_quad_destroy(void* const renderer);
+
 //start/stop
 void canvas_vulkan_surface_create(void* const renderer);
 void canvas_vulkan_surface_destroy(void* const renderer);
 
+VkPresentModeKHR canvas_vulkan_present_mode_select(void* const renderer);
 void canvas_vulkan_swapchain_create(void* const renderer);
 void canvas_vulkan_swapchain_destroy(void* const renderer);
+//releases the per image resources to the deferred queue, the swapchain itself is released by the next creation
+void canvas_vulkan_swapchain_retire(void* const renderer);
+
+//stands in for surface and swapchain, the images are used like swapchain images
+void canvas_vulkan_headless_create(void* const renderer);
+void canvas_vulkan_headless_destroy(void* const renderer);
 
 void canvas_vulkan_imageviews_create(void* const renderer);
 void canvas_vulkan_imageviews_destroy(void* const renderer);
 
 void canvas_vulkan_shader_create(void* const renderer);
 void canvas_vulkan_shader_destroy(void* const renderer);
+void canvas_vulkan_shader_wait(void* const renderer);
 
 void canvas_vulkan_pipeline_create(void* const renderer);
 void canvas_vulkan_pipeline_destroy(void* const renderer);
+void canvas_vulkan_pipeline_wait(void* const renderer);
+
+CNVX_Renderer_Pipeline_PRIVATE canvas_vulkan_shader_pipeline_get(const CNVX_Renderer_Shader_Type type);
+//builds the pipeline of key from shader_module_all without touching the variants, =VK_NULL_HANDLE if the shader set has no shaders
+VkResult canvas_vulkan_pipeline_variant_build(void* const renderer, const CNVX_Vulkan_Pipeline_Key_PRIVATE* const key, const VkShaderModule* const shader_module_all, VkPipeline* const pipeline);
 
 void canvas_vulkan_framebuffer_create(void* const renderer);
 void canvas_vulkan_framebuffer_destroy(void* const renderer);
@@ -83,12 +110,26 @@ void canvas_vulkan_commandpool_destroy(void* const renderer);
 void canvas_vulkan_commandbuffer_create(void* const renderer);
 void canvas_vulkan_commandbuffer_destroy(void* const renderer);
 
-void canvas_vulkan_commandbuffer_record(void* const renderer);
+//declares the passes of a frame, the graph derives every barrier between them
+void canvas_vulkan_frame_graph_create(void* const renderer);
+//the transient images are released into the deferred queue
+void canvas_vulkan_frame_graph_destroy(void* const renderer);
+
+void canvas_vulkan_commandbuffer_record(void* const renderer, const uint32_t image_index);
 
 void canvas_vulkan_semaphore_create(void* const renderer);
 void canvas_vulkan_semaphore_destroy(void* const renderer);
+void canvas_vulkan_semaphore_rendering_done_create(void* const renderer);
+void canvas_vulkan_semaphore_rendering_done_destroy(void* const renderer);
+
+void canvas_vulkan_fence_create(void* const renderer);
+void canvas_vulkan_fence_destroy(void* const renderer);
 
 //update
+void canvas_vulkan_frame_begin(void* const renderer);
 void canvas_vulkan_frame_draw(void* const renderer);
 
+void canvas_vulkan_geometry_submit(void* const renderer, const CNVX_Renderer_Vertex* const vertex_all, const size_t vertex_count, const uint32_t* const index_all, const size_t index_count, const uint32_t texture_index);
+void canvas_vulkan_quad_submit(void* const renderer, const CNVX_Renderer_Quad* const quad_all, const size_t quad_count);
+
 #endif // ___CNVX___VULKAN_PRIVATE_H
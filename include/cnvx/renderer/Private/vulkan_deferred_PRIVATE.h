@@ -0,0 +1,89 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_DEFERRED_PRIVATE_H
+#define ___CNVX___VULKAN_DEFERRED_PRIVATE_H
+
+#include "cnvx/renderer/renderer.h"
+#include "cnvx/renderer/Private/vulkan_descriptor_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_DEFERRED_GROWTH 32
+
+typedef enum CNVX_Vulkan_Deferred_Type_PRIVATE
+{
+    CNVX_VULKAN_DEFERRED_TYPE_BUFFER,
+    CNVX_VULKAN_DEFERRED_TYPE_IMAGE,
+    CNVX_VULKAN_DEFERRED_TYPE_IMAGE_VIEW,
+    CNVX_VULKAN_DEFERRED_TYPE_FRAMEBUFFER,
+    CNVX_VULKAN_DEFERRED_TYPE_PIPELINE,
+    CNVX_VULKAN_DEFERRED_TYPE_SEMAPHORE,
+    CNVX_VULKAN_DEFERRED_TYPE_SWAPCHAIN,
+    CNVX_VULKAN_DEFERRED_TYPE_DESCRIPTOR, //a bindless slot, returned to its free list instead of destroyed
+    ___CNVX_VULKAN_DEFERRED_TYPE_MAX,
+} CNVX_Vulkan_Deferred_Type_PRIVATE;
+
+//an object released while frames in flight may still use it
+typedef struct CNVX_Vulkan_Deferred_PRIVATE
+{
+    uint64_t frame_serial_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX]; //last submission per frame at release
+    CNVX_Vulkan_Deferred_Type_PRIVATE type;
+    union {
+        VkBuffer buffer;
+        VkImage image;
+        VkImageView image_view;
+        VkFramebuffer framebuffer;
+        VkPipeline pipeline;
+        VkSemaphore semaphore;
+        VkSwapchainKHR swapchain;
+        struct
+        {
+            CNVX_Vulkan_Descriptor_Binding_PRIVATE descriptor_binding;
+            uint32_t descriptor_index;
+        };
+    };
+    bool allocation_is; //buffers and images free their memory after being destroyed
+    CNVX_Vulkan_Allocation_PRIVATE allocation;
+} CNVX_Vulkan_Deferred_PRIVATE;
+
+void canvas_vulkan_deferred_create(void* const renderer);
+//destroys everything still queued, the device has to be idle
+void canvas_vulkan_deferred_destroy(void* const renderer);
+
+//allocation is allowed to be =NULL, callable from any thread
+void canvas_vulkan_deferred_buffer_release(void* const renderer, const VkBuffer buffer, const CNVX_Vulkan_Allocation_PRIVATE* const allocation);
+void canvas_vulkan_deferred_image_release(void* const renderer, const VkImage image, const CNVX_Vulkan_Allocation_PRIVATE* const allocation);
+void canvas_vulkan_deferred_image_view_release(void* const renderer, const VkImageView image_view);
+void canvas_vulkan_deferred_framebuffer_release(void* const renderer, const VkFramebuffer framebuffer);
+void canvas_vulkan_deferred_pipeline_release(void* const renderer, const VkPipeline pipeline);
+void canvas_vulkan_deferred_semaphore_release(void* const renderer, const VkSemaphore semaphore);
+void canvas_vulkan_deferred_swapchain_release(void* const renderer, const VkSwapchainKHR swapchain);
+void canvas_vulkan_deferred_descriptor_release(void* const renderer, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding, const uint32_t index);
+
+//destroys the objects whose frames are done, all_is=true destroys everything and requires an idle device
+void canvas_vulkan_deferred_collect(void* const renderer, const bool all_is);
+
+#endif // ___CNVX___VULKAN_DEFERRED_PRIVATE_H
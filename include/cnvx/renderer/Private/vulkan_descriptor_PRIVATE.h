@@ -0,0 +1,78 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_DESCRIPTOR_PRIVATE_H
+#define ___CNVX___VULKAN_DESCRIPTOR_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_DESCRIPTOR_TEXTURE_COUNT_MAX 4096 //further limited by the device
+#define CNVX_VULKAN_DESCRIPTOR_BUFFER_COUNT_MAX 1024
+#define CNVX_VULKAN_DESCRIPTOR_FRAME_SET_COUNT 64 //sets per frame pool, more pools are chained when it runs out
+#define CNVX_VULKAN_DESCRIPTOR_FRAME_POOL_GROWTH 4
+
+//bindings of the global set 0, shaders index them with the push constants
+typedef enum CNVX_Vulkan_Descriptor_Binding_PRIVATE
+{
+    CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE, //sampler2D texture_all[]
+    CNVX_VULKAN_DESCRIPTOR_BINDING_BUFFER, //readonly buffer buffer_all[]
+    ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX,
+} CNVX_Vulkan_Descriptor_Binding_PRIVATE;
+
+typedef enum CNVX_Vulkan_Descriptor_Sampler_PRIVATE
+{
+    CNVX_VULKAN_DESCRIPTOR_SAMPLER_LINEAR,
+    CNVX_VULKAN_DESCRIPTOR_SAMPLER_NEAREST,
+    ___CNVX_VULKAN_DESCRIPTOR_SAMPLER_MAX,
+} CNVX_Vulkan_Descriptor_Sampler_PRIVATE;
+
+//pushed per draw, only when it differs from the previous one
+typedef struct CNVX_Vulkan_Push_Constant_PRIVATE
+{
+    uint32_t texture_index;
+    uint32_t buffer_index;
+    uint32_t reserved[2];
+} CNVX_Vulkan_Push_Constant_PRIVATE;
+
+void canvas_vulkan_descriptor_create(void* const renderer);
+//slots still waiting in the deferred queue have to be collected before
+void canvas_vulkan_descriptor_destroy(void* const renderer);
+
+//returns the index into the binding, callable from any thread
+uint32_t canvas_vulkan_descriptor_texture_register(void* const renderer, const VkImageView image_view, const VkImageLayout layout, const VkSampler sampler);
+uint32_t canvas_vulkan_descriptor_buffer_register(void* const renderer, const VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range);
+//the slot is handed out again once no frame in flight can read it
+void canvas_vulkan_descriptor_release(void* const renderer, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding, const uint32_t index);
+//called by the deferred queue
+void canvas_vulkan_descriptor_free(void* const renderer, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding, const uint32_t index);
+
+//secondary command buffers do not inherit bound sets, so every recorded list binds it
+void canvas_vulkan_descriptor_bind(void* const renderer, const VkCommandBuffer commandbuffer);
+
+//the set lives until the current frame slot comes around again
+VkDescriptorSet canvas_vulkan_descriptor_frame_allocate(void* const renderer, const VkDescriptorSetLayout layout);
+//resets the pools of the current frame, its fence has to be signaled
+void canvas_vulkan_descriptor_frame_reset(void* const renderer);
+
+#endif // ___CNVX___VULKAN_DESCRIPTOR_PRIVATE_H
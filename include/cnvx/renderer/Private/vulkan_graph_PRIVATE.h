@@ -0,0 +1,119 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_GRAPH_PRIVATE_H
+#define ___CNVX___VULKAN_GRAPH_PRIVATE_H
+
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_GRAPH_PASS_COUNT_MAX 16
+#define CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX 16
+#define CNVX_VULKAN_GRAPH_ACCESS_COUNT_MAX 8 //per pass
+
+//what a pass does with an image, the graph derives layouts and barriers from it
+typedef enum CNVX_Vulkan_Graph_Access_Type_PRIVATE
+{
+    CNVX_VULKAN_GRAPH_ACCESS_TYPE_COLOR_WRITE, //color attachment, render passes keep it in COLOR_ATTACHMENT_OPTIMAL
+    CNVX_VULKAN_GRAPH_ACCESS_TYPE_SAMPLED_READ,
+    CNVX_VULKAN_GRAPH_ACCESS_TYPE_TRANSFER_READ,
+    CNVX_VULKAN_GRAPH_ACCESS_TYPE_TRANSFER_WRITE,
+    ___CNVX_VULKAN_GRAPH_ACCESS_TYPE_MAX,
+} CNVX_Vulkan_Graph_Access_Type_PRIVATE;
+
+typedef void (*CNVX_Vulkan_Graph_Record_PRIVATE)(void* const renderer, const VkCommandBuffer commandbuffer, void* const data);
+
+typedef struct CNVX_Vulkan_Graph_Access_PRIVATE
+{
+    uint32_t resource;
+    CNVX_Vulkan_Graph_Access_Type_PRIVATE type;
+} CNVX_Vulkan_Graph_Access_PRIVATE;
+
+typedef struct CNVX_Vulkan_Graph_Resource_PRIVATE
+{
+    bool imported_is; //owned elsewhere and bound every frame, transient images are owned by the graph
+    VkImage image;
+    VkImageView image_view;
+    VkFormat format;
+    uint32_t width; //=0 follows the extent of the renderer
+    uint32_t height;
+    VkImageUsageFlags usage; //gathered from the accesses
+    VkPipelineStageFlags stage_initial; //imported images, stages the image is handed over from
+    VkImageLayout layout_final; //imported images are handed back in this layout
+    VkDeviceSize alias_offset; //inside the block shared by all transient images
+    uint32_t pass_first; //lifetime of transient images, overlapping lifetimes never share memory
+    uint32_t pass_last;
+    VkImageLayout layout; //state while executing
+    VkPipelineStageFlags stage; //readers since the last write, or the writer
+    VkAccessFlags access;
+    bool written_is;
+    bool needed_is; //read by a pass that is not culled
+} CNVX_Vulkan_Graph_Resource_PRIVATE;
+
+typedef struct CNVX_Vulkan_Graph_Pass_PRIVATE
+{
+    const char* name;
+    CNVX_Vulkan_Graph_Record_PRIVATE record;
+    void* data;
+    bool enabled_is;
+    bool side_effect_is; //never culled, like copies read by the host
+    bool alive_is;
+    uint32_t access_count;
+    CNVX_Vulkan_Graph_Access_PRIVATE access_all[CNVX_VULKAN_GRAPH_ACCESS_COUNT_MAX];
+} CNVX_Vulkan_Graph_Pass_PRIVATE;
+
+//passes execute in declaration order, culling only removes them
+typedef struct CNVX_Vulkan_Graph_PRIVATE
+{
+    uint32_t pass_count;
+    CNVX_Vulkan_Graph_Pass_PRIVATE pass_all[CNVX_VULKAN_GRAPH_PASS_COUNT_MAX];
+    uint32_t resource_count;
+    CNVX_Vulkan_Graph_Resource_PRIVATE resource_all[CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX];
+    bool allocation_is;
+    CNVX_Vulkan_Allocation_PRIVATE allocation; //one block for all transient images
+} CNVX_Vulkan_Graph_PRIVATE;
+
+void canvas_vulkan_graph_create(void* const renderer);
+//transient images are released into the deferred queue
+void canvas_vulkan_graph_destroy(void* const renderer);
+
+uint32_t canvas_vulkan_graph_image_import(void* const renderer, const VkFormat format, const VkPipelineStageFlags stage_initial, const VkImageLayout layout_final);
+//imported images change every frame, like the acquired swapchain image
+void canvas_vulkan_graph_image_bind(void* const renderer, const uint32_t resource, const VkImage image, const VkImageView image_view);
+//width=0 and height=0 follow the extent of the renderer
+uint32_t canvas_vulkan_graph_image_transient(void* const renderer, const VkFormat format, const uint32_t width, const uint32_t height);
+void canvas_vulkan_graph_image_get(void* const renderer, const uint32_t resource, VkImage* const image, VkImageView* const image_view);
+
+uint32_t canvas_vulkan_graph_pass_add(void* const renderer, const char* const name, const CNVX_Vulkan_Graph_Record_PRIVATE record, void* const data, const bool side_effect_is);
+void canvas_vulkan_graph_pass_access_add(void* const renderer, const uint32_t pass, const uint32_t resource, const CNVX_Vulkan_Graph_Access_Type_PRIVATE type);
+//disabled passes are culled together with everything only they depend on
+void canvas_vulkan_graph_pass_enable(void* const renderer, const uint32_t pass, const bool enabled_is);
+
+//(re)creates the transient images after declaring the graph and on every resize
+void canvas_vulkan_graph_allocate(void* const renderer);
+//culls, inserts the barriers in front of every pass and hands imported images back in their final layout
+void canvas_vulkan_graph_execute(void* const renderer, const VkCommandBuffer commandbuffer);
+
+#endif // ___CNVX___VULKAN_GRAPH_PRIVATE_H
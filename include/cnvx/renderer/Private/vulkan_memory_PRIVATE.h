@@ -0,0 +1,72 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_MEMORY_PRIVATE_H
+#define ___CNVX___VULKAN_MEMORY_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_MEMORY_CLASS_SIZE_MIN 256
+#define CNVX_VULKAN_MEMORY_CLASS_COUNT 13 //256B up to 1MiB, larger requests get their own allocation
+#define CNVX_VULKAN_MEMORY_CLASS_DEDICATED UINT32_MAX
+
+#define CNVX_VULKAN_MEMORY_PAGE_SIZE_MIN (2 * 1024 * 1024)
+#define CNVX_VULKAN_MEMORY_PAGE_SIZE_MAX (16 * 1024 * 1024)
+
+//one vkAllocateMemory split into equally sized slots of a single size class
+typedef struct CNVX_Vulkan_Memory_Page_PRIVATE
+{
+    VkDeviceMemory memory;
+    void* data;
+    uint32_t slot_count;
+    uint32_t free_count;
+    uint32_t* free_all;
+    struct CNVX_Vulkan_Memory_Page_PRIVATE* next;
+} CNVX_Vulkan_Memory_Page_PRIVATE;
+
+typedef struct CNVX_Vulkan_Allocation_PRIVATE
+{
+    VkDeviceMemory memory;
+    VkDeviceSize offset;
+    VkDeviceSize size;
+    void* data; //=NULL if the memory is not host visible
+    uint32_t type_index;
+    uint32_t class_index;
+    bool linear_is;
+    CNVX_Vulkan_Memory_Page_PRIVATE* page;
+    uint32_t slot;
+} CNVX_Vulkan_Allocation_PRIVATE;
+
+void canvas_vulkan_memory_create(void* const renderer);
+void canvas_vulkan_memory_destroy(void* const renderer);
+
+//required flags must match, preferred flags are dropped if no memory type offers them
+void canvas_vulkan_memory_allocate(void* const renderer, const VkMemoryRequirements* const requirements, const VkMemoryPropertyFlags required, const VkMemoryPropertyFlags preferred, const bool linear_is, CNVX_Vulkan_Allocation_PRIVATE* const allocation);
+void canvas_vulkan_memory_free(void* const renderer, CNVX_Vulkan_Allocation_PRIVATE* const allocation);
+
+//per frame bump allocator, reset once the frame fence has been waited for
+void canvas_vulkan_memory_linear_reset(void* const renderer);
+void* canvas_vulkan_memory_linear_allocate(void* const renderer, const VkDeviceSize size, const VkDeviceSize alignment, VkBuffer* const buffer, VkDeviceSize* const offset);
+
+#endif // ___CNVX___VULKAN_MEMORY_PRIVATE_H
@@ -0,0 +1,63 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_PIPELINE_PRIVATE_H
+#define ___CNVX___VULKAN_PIPELINE_PRIVATE_H
+
+#include "cnvx/renderer/renderer.h"
+#include "cnvx/renderer/Private/worker_PRIVATE.h"
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_PIPELINE_VARIANT_COUNT_MAX 64
+#define CNVX_VULKAN_PIPELINE_SLOT_COUNT 128 //power of two, at most half full
+#define CNVX_VULKAN_PIPELINE_VARIANT_NONE UINT32_MAX
+
+//only 32 bit fields, so keys compare and hash as plain bytes
+typedef struct CNVX_Vulkan_Pipeline_Key_PRIVATE
+{
+    uint32_t shader_set; //CNVX_Renderer_Pipeline_PRIVATE
+    uint32_t blend; //CNVX_Renderer_Blend
+    uint32_t topology; //CNVX_Renderer_Topology
+    uint32_t cull; //CNVX_Renderer_Cull
+    uint32_t color_format; //VkFormat of the attachment
+} CNVX_Vulkan_Pipeline_Key_PRIVATE;
+
+typedef struct CNVX_Vulkan_Pipeline_Variant_PRIVATE
+{
+    CNVX_Vulkan_Pipeline_Key_PRIVATE key;
+    VkPipeline pipeline; //=VK_NULL_HANDLE while building or if the shader set has no shaders
+    CNVX_Worker_Job_PRIVATE job;
+} CNVX_Vulkan_Pipeline_Variant_PRIVATE;
+
+void canvas_vulkan_pipeline_variant_create(void* const renderer);
+//the variants have to be finished, their pipelines are destroyed immediately
+void canvas_vulkan_pipeline_variant_destroy(void* const renderer);
+
+//returns the variant of the key, a new one is built by build on the worker and joined by canvas_vulkan_pipeline_variant_wait
+//=CNVX_VULKAN_PIPELINE_VARIANT_NONE if CNVX_VULKAN_PIPELINE_VARIANT_COUNT_MAX variants exist
+uint32_t canvas_vulkan_pipeline_variant_get(void* const renderer, const CNVX_Vulkan_Pipeline_Key_PRIVATE* const key, const CNVX_Worker_Function_PRIVATE build);
+void canvas_vulkan_pipeline_variant_wait(void* const renderer);
+
+#endif // ___CNVX___VULKAN_PIPELINE_PRIVATE_H
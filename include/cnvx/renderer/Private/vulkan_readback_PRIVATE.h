@@ -0,0 +1,70 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_READBACK_PRIVATE_H
+#define ___CNVX___VULKAN_READBACK_PRIVATE_H
+
+#include "cnvx/renderer/renderer.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+typedef enum CNVX_Vulkan_Readback_State_PRIVATE
+{
+    CNVX_VULKAN_READBACK_STATE_FREE,
+    CNVX_VULKAN_READBACK_STATE_PENDING, //copy recorded into a frame that may still be in flight
+    CNVX_VULKAN_READBACK_STATE_READY,
+    CNVX_VULKAN_READBACK_STATE_HELD, //handed out to the caller
+    ___CNVX_VULKAN_READBACK_STATE_MAX,
+} CNVX_Vulkan_Readback_State_PRIVATE;
+
+//one host visible buffer of the ring, grown when the image gets larger
+typedef struct CNVX_Vulkan_Readback_Slot_PRIVATE
+{
+    CNVX_Vulkan_Readback_State_PRIVATE state;
+    VkBuffer buffer;
+    CNVX_Vulkan_Allocation_PRIVATE allocation;
+    VkDeviceSize size;
+    uint32_t frame_index;
+    uint64_t frame_serial;
+    uint32_t width;
+    uint32_t height;
+    uint32_t texel_size;
+    VkFormat format;
+} CNVX_Vulkan_Readback_Slot_PRIVATE;
+
+void canvas_vulkan_readback_create(void* const renderer);
+//the device has to be idle, captures not yet fetched are lost
+void canvas_vulkan_readback_destroy(void* const renderer);
+
+//consumes a capture request and reserves a ring buffer for it, returns false if nothing is to be copied this frame
+bool canvas_vulkan_readback_prepare(void* const renderer);
+//records the copy of the reserved buffer, the image has to be in TRANSFER_SRC_OPTIMAL already
+void canvas_vulkan_readback_record(void* const renderer, const VkCommandBuffer commandbuffer, const VkImage image);
+
+//never waits, returns false if no capture is finished, the previously held capture is released
+bool canvas_vulkan_readback_get(void* const renderer, CNVX_Renderer_Readback* const readback);
+void canvas_vulkan_readback_release(void* const renderer);
+
+#endif // ___CNVX___VULKAN_READBACK_PRIVATE_H
@@ -0,0 +1,53 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_RELOAD_PRIVATE_H
+#define ___CNVX___VULKAN_RELOAD_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_RELOAD_EVENT_BUFFER_SIZE 4096
+#define CNVX_VULKAN_RELOAD_SPIRV_MAGIC 0x07230203
+
+//per loaded shader, at the same index as shader_vec
+typedef struct CNVX_Vulkan_Reload_Shader_PRIVATE
+{
+    int watch; //inotify watch of the directory holding the file, =-1 if not watched
+    bool changed_is; //written since the last rebuild was started
+    bool rebuild_is; //part of the running rebuild
+    uint32_t size;
+    char* data; //code of the running rebuild, owned until it is swapped in
+    VkShaderModule shader_module; //built from data by the rebuild
+} CNVX_Vulkan_Reload_Shader_PRIVATE;
+
+//watches the files of the loaded shaders if settings.shader_reload_is, has to be created after the pipelines
+void canvas_vulkan_reload_create(void* const renderer);
+//a running rebuild is joined and discarded
+void canvas_vulkan_reload_destroy(void* const renderer);
+
+//called at the frame boundary before anything is recorded
+//changed files start a rebuild of their modules and the affected variants on the worker, a finished rebuild is swapped in
+void canvas_vulkan_reload_update(void* const renderer);
+
+#endif // ___CNVX___VULKAN_RELOAD_PRIVATE_H
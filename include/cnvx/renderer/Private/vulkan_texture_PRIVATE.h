@@ -0,0 +1,72 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_TEXTURE_PRIVATE_H
+#define ___CNVX___VULKAN_TEXTURE_PRIVATE_H
+
+#include "cnvx/renderer/renderer.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_TEXTURE_FORMAT VK_FORMAT_R8G8B8A8_UNORM
+#define CNVX_VULKAN_TEXTURE_UPLOAD_GROWTH 32
+
+typedef struct CNVX_Vulkan_Texture_PRIVATE
+{
+    bool live_is;
+    bool defined_is; //=false until the first upload, its layout is undefined before
+    bool shared_is; //written by the transfer queue while frames sample it, kept in the general layout
+    VkImage image;
+    VkImageView image_view;
+    CNVX_Vulkan_Allocation_PRIVATE allocation;
+    uint32_t width;
+    uint32_t height;
+    uint32_t mip_count;
+} CNVX_Vulkan_Texture_PRIVATE;
+
+//mip 0 copied by the transfer queue, acquired and blitted by the next frame ahead of its render pass
+typedef struct CNVX_Vulkan_Texture_Upload_PRIVATE
+{
+    uint32_t texture_index;
+    VkImage image; //skipped if the texture was destroyed in the meantime
+} CNVX_Vulkan_Texture_Upload_PRIVATE;
+
+void canvas_vulkan_texture_create(void* const renderer);
+//releases every texture still alive into the deferred queue
+void canvas_vulkan_texture_destroy(void* const renderer);
+
+//rgba8 pixels with tightly packed rows, the index addresses both the texture and its bindless slot
+uint32_t canvas_vulkan_texture_new(void* const renderer, const void* const pixel_all, const uint32_t width, const uint32_t height, const bool mip_is, const CNVX_Renderer_Texture_Filter filter);
+void canvas_vulkan_texture_delete(void* const renderer, const uint32_t texture_index);
+
+bool canvas_vulkan_texture_atlas_insert(void* const renderer, const uint64_t key, const void* const pixel_all, const uint32_t width, const uint32_t height, CNVX_Renderer_Atlas_Region* const region);
+bool canvas_vulkan_texture_atlas_get(void* const renderer, const uint64_t key, CNVX_Renderer_Atlas_Region* const region);
+
+//acquires, mip blits and layout transitions of the pending uploads, outside of any render pass
+void canvas_vulkan_texture_record(void* const renderer, const VkCommandBuffer commandbuffer);
+//called right after the submission of the recorded uploads
+void canvas_vulkan_texture_submitted(void* const renderer);
+
+#endif // ___CNVX___VULKAN_TEXTURE_PRIVATE_H
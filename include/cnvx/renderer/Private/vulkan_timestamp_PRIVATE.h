@@ -0,0 +1,76 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_TIMESTAMP_PRIVATE_H
+#define ___CNVX___VULKAN_TIMESTAMP_PRIVATE_H
+
+#include "cnvx/renderer/renderer.h"
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+//queries of one frame, even ones are written at the top of the pipe and odd ones at the bottom
+typedef enum CNVX_Vulkan_Timestamp_Query_PRIVATE
+{
+    CNVX_VULKAN_TIMESTAMP_QUERY_FRAME_BEGIN,
+    CNVX_VULKAN_TIMESTAMP_QUERY_FRAME_END,
+    CNVX_VULKAN_TIMESTAMP_QUERY_PASS_BEGIN,
+    CNVX_VULKAN_TIMESTAMP_QUERY_PASS_END,
+    CNVX_VULKAN_TIMESTAMP_QUERY_REGION_FIRST, //begin and end of every region follow
+    ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX = CNVX_VULKAN_TIMESTAMP_QUERY_REGION_FIRST + 2 * CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX,
+} CNVX_Vulkan_Timestamp_Query_PRIVATE;
+
+#define CNVX_VULKAN_TIMESTAMP_SERIES_COUNT (2 + CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX) //frame, pass, regions
+
+//rolling window of gpu durations in milliseconds
+typedef struct CNVX_Vulkan_Timestamp_History_PRIVATE
+{
+    float sample_all[CNVX_RENDERER_TIMESTAMP_HISTORY_COUNT];
+    uint32_t sample_count;
+    uint32_t sample_index;
+} CNVX_Vulkan_Timestamp_History_PRIVATE;
+
+//does nothing if the graphics queue can not write timestamps
+void canvas_vulkan_timestamp_create(void* const renderer);
+void canvas_vulkan_timestamp_destroy(void* const renderer);
+
+//resets the queries of the current frame, has to be recorded outside of a render pass before any write
+void canvas_vulkan_timestamp_reset(void* const renderer, const VkCommandBuffer commandbuffer);
+void canvas_vulkan_timestamp_write(void* const renderer, const VkCommandBuffer commandbuffer, const CNVX_Vulkan_Timestamp_Query_PRIVATE query);
+//writes the region boundaries placed before draw_index, called for every recorded draw and once past the last
+void canvas_vulkan_timestamp_region_write(void* const renderer, const VkCommandBuffer commandbuffer, const size_t draw_index);
+
+//reads the results of the current frame slot without waiting, its fence has to be signaled
+void canvas_vulkan_timestamp_collect(void* const renderer);
+
+//regions are placed between the draws submitted in the current frame
+void canvas_vulkan_timestamp_region_begin(void* const renderer, const uint32_t region);
+void canvas_vulkan_timestamp_region_end(void* const renderer, const uint32_t region);
+//drops the regions of the current frame along with its draws
+void canvas_vulkan_timestamp_region_clear(void* const renderer);
+//true if a region starts or ends at draw_index, draws must not be merged across it
+bool canvas_vulkan_timestamp_region_boundary_is(void* const renderer, const size_t draw_index);
+
+CNVX_Renderer_Timestamp_Stats canvas_vulkan_timestamp_stats_get(void* const renderer);
+
+#endif // ___CNVX___VULKAN_TIMESTAMP_PRIVATE_H
@@ -0,0 +1,61 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_TRANSFER_PRIVATE_H
+#define ___CNVX___VULKAN_TRANSFER_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_TRANSFER_BATCH_COUNT 4
+
+//one submission to the transfer queue, its staging range is reused once the fence is signaled
+typedef struct CNVX_Vulkan_Transfer_Batch_PRIVATE
+{
+    VkCommandBuffer commandbuffer;
+    VkFence fence;
+    VkDeviceSize staging_size;
+    bool pending_is;
+} CNVX_Vulkan_Transfer_Batch_PRIVATE;
+
+void canvas_vulkan_transfer_create(void* const renderer);
+void canvas_vulkan_transfer_destroy(void* const renderer);
+
+//copies data into the staging ring and records the copy, large uploads are split over several batches
+void canvas_vulkan_transfer_buffer_upload(void* const renderer, const VkBuffer buffer, const VkDeviceSize offset, const void* const data, const VkDeviceSize size);
+//copies tightly packed rows into mip 0, the mip_count levels go from layout_old to layout ahead of the copy
+//release_is=true hands an exclusive image over to the graphics queue, which has to take it with canvas_vulkan_transfer_image_acquire
+void canvas_vulkan_transfer_image_upload(void* const renderer, const VkImage image, const uint32_t mip_count, const VkImageLayout layout_old, const VkImageLayout layout, const bool release_is, const uint32_t x, const uint32_t y, const uint32_t width, const uint32_t height, const uint32_t texel_size, const void* const data);
+//records the acquire matching a release into a command buffer of the graphics queue, nothing is needed without a dedicated transfer queue
+void canvas_vulkan_transfer_image_acquire(void* const renderer, const VkCommandBuffer commandbuffer, const VkImage image, const uint32_t mip_count, const VkImageLayout layout);
+
+//submits the recorded copies, the next graphics submission waits for them
+void canvas_vulkan_transfer_flush(void* const renderer);
+
+//fills the semaphore the graphics submission has to wait on, returns false if there is nothing to wait for
+bool canvas_vulkan_transfer_wait_get(void* const renderer, VkSemaphore* const semaphore, uint64_t* const value, VkPipelineStageFlags* const stage_mask);
+
+//queue families a resource touched by both queues has to be shared between
+uint32_t canvas_vulkan_transfer_queue_family_indices_get(void* const renderer, uint32_t* const queue_family_index_all);
+
+#endif // ___CNVX___VULKAN_TRANSFER_PRIVATE_H
@@ -0,0 +1,59 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___VULKAN_UNIFORM_PRIVATE_H
+#define ___CNVX___VULKAN_UNIFORM_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#include "vulkan/vulkan.h"
+
+#define CNVX_VULKAN_UNIFORM_SET 1 //after the bindless set 0
+#define CNVX_VULKAN_UNIFORM_OFFSET_NONE UINT32_MAX //draws without a block of their own read the frame block
+#define CNVX_VULKAN_UNIFORM_OFFSET_INVALID (UINT32_MAX - 1) //the last block did not fit, draws are dropped until one is set again
+
+//dynamic uniform buffers of set 1, both point into the frame arena
+typedef enum CNVX_Vulkan_Uniform_Binding_PRIVATE
+{
+    CNVX_VULKAN_UNIFORM_BINDING_FRAME, //CNVX_Renderer_Frame_Uniform
+    CNVX_VULKAN_UNIFORM_BINDING_DRAW, //set with canvas_renderer_draw_uniform_set
+    ___CNVX_VULKAN_UNIFORM_BINDING_MAX,
+} CNVX_Vulkan_Uniform_Binding_PRIVATE;
+
+//one set per frame arena buffer, written once, only the dynamic offsets change
+void canvas_vulkan_uniform_create(void* const renderer);
+void canvas_vulkan_uniform_destroy(void* const renderer);
+
+//slice of the frame arena aligned to minUniformBufferOffsetAlignment, =NULL if the arena is full
+void* canvas_vulkan_uniform_allocate(void* const renderer, const size_t size, uint32_t* const offset);
+//reserves the frame block, called whenever the frame arena was reset
+void canvas_vulkan_uniform_frame_reset(void* const renderer);
+//fills in the viewport and copies the frame block, right before recording
+void canvas_vulkan_uniform_frame_write(void* const renderer);
+
+//copies the block into the current frame, the draws submitted afterwards read it
+//a full arena leaves CNVX_VULKAN_UNIFORM_OFFSET_INVALID, which the submissions drop their draws on
+void canvas_vulkan_uniform_draw_set(void* const renderer, const void* const data, const size_t size);
+
+void canvas_vulkan_uniform_bind(void* const renderer, const VkCommandBuffer commandbuffer, const uint32_t offset_draw);
+
+#endif // ___CNVX___VULKAN_UNIFORM_PRIVATE_H
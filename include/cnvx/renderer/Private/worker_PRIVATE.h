@@ -0,0 +1,53 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#ifndef ___CNVX___WORKER_PRIVATE_H
+#define ___CNVX___WORKER_PRIVATE_H
+
+#include "sprx/core/essentials.h"
+
+#define CNVX_WORKER_THREAD_COUNT_MAX 64
+
+typedef void (*CNVX_Worker_Function_PRIVATE)(void* const argument, const size_t index);
+
+//owned by the submitter and must stay alive until the job is done
+typedef struct CNVX_Worker_Job_PRIVATE
+{
+    CNVX_Worker_Function_PRIVATE function;
+    void* argument;
+    size_t index;
+    bool done_is;
+    struct CNVX_Worker_Job_PRIVATE* next;
+} CNVX_Worker_Job_PRIVATE;
+
+void* canvas_worker_new(const size_t thread_count, const size_t id, void* const logger);
+void canvas_worker_delete(void* const worker);
+
+size_t canvas_worker_thread_count_get(void* const worker);
+
+void canvas_worker_submit(void* const worker, CNVX_Worker_Job_PRIVATE* const job, const CNVX_Worker_Function_PRIVATE function, void* const argument, const size_t index);
+bool canvas_worker_done_is(void* const worker, CNVX_Worker_Job_PRIVATE* const job);
+
+//runs queued jobs on the calling thread while waiting, so jobs may wait on other jobs
+void canvas_worker_wait(void* const worker, CNVX_Worker_Job_PRIVATE* const job);
+
+#endif // ___CNVX___WORKER_PRIVATE_H
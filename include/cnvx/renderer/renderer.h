@@ -26,28 +26,273 @@
 #include "sprx/core/essentials.h"
 #include "sprx/core/info.h"
 
+#define CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_DEFAULT 2
+#define CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX 8
+
+#define CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_DEFAULT 3
+#define CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_MIN 2
+#define CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_MAX 3
+
+#define CNVX_RENDERER_TRANSFER_STAGING_SIZE_DEFAULT (16 * 1024 * 1024)
+
+#define CNVX_RENDERER_MEMORY_LINEAR_SIZE_DEFAULT (16 * 1024 * 1024)
+#define CNVX_RENDERER_MEMORY_HEAP_COUNT_MAX 16
+
+#define CNVX_RENDERER_READBACK_RING_COUNT 4
+
+#define CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX 8
+#define CNVX_RENDERER_TIMESTAMP_HISTORY_COUNT 128
+
+#define CNVX_RENDERER_UNIFORM_SIZE_MAX 256 //range of the dynamic uniform buffers, slices are aligned to minUniformBufferOffsetAlignment
+
+#define CNVX_RENDERER_ATLAS_PAGE_SIZE 1024
+#define CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX 8
+
 typedef enum CNVX_Renderer_Shader_Type
 {
     CNVX_RENDERER_SHADER_TYPE_FRAGMENT,
     CNVX_RENDERER_SHADER_TYPE_VERTEX,
+    CNVX_RENDERER_SHADER_TYPE_QUAD_FRAGMENT,
+    CNVX_RENDERER_SHADER_TYPE_QUAD_VERTEX,
     ___CNVX_RENDERER_SHADER_TYPE_MAX,
 } CNVX_Renderer_Shader_Type;
 
+//falls back to the next mode the surface supports, ending at fifo which is always available
+typedef enum CNVX_Renderer_Present_Mode
+{
+    CNVX_RENDERER_PRESENT_MODE_AUTO, //fifo with vsync_is, otherwise mailbox, immediate, fifo
+    CNVX_RENDERER_PRESENT_MODE_FIFO,
+    CNVX_RENDERER_PRESENT_MODE_FIFO_RELAXED, //fifo_relaxed, fifo
+    CNVX_RENDERER_PRESENT_MODE_MAILBOX, //mailbox, fifo
+    CNVX_RENDERER_PRESENT_MODE_IMMEDIATE, //immediate, mailbox, fifo
+    ___CNVX_RENDERER_PRESENT_MODE_MAX,
+} CNVX_Renderer_Present_Mode;
+
+typedef struct CNVX_Renderer_Vertex
+{
+    float position[2];
+    float uv[2];
+    float color[4];
+} CNVX_Renderer_Vertex;
+
+typedef enum CNVX_Renderer_Texture_Filter
+{
+    CNVX_RENDERER_TEXTURE_FILTER_LINEAR,
+    CNVX_RENDERER_TEXTURE_FILTER_NEAREST,
+    ___CNVX_RENDERER_TEXTURE_FILTER_MAX,
+} CNVX_Renderer_Texture_Filter;
+
+typedef enum CNVX_Renderer_Blend
+{
+    CNVX_RENDERER_BLEND_ALPHA,
+    CNVX_RENDERER_BLEND_PREMULTIPLIED,
+    CNVX_RENDERER_BLEND_ADDITIVE,
+    CNVX_RENDERER_BLEND_OPAQUE,
+    ___CNVX_RENDERER_BLEND_MAX,
+} CNVX_Renderer_Blend;
+
+typedef enum CNVX_Renderer_Topology
+{
+    CNVX_RENDERER_TOPOLOGY_TRIANGLE_LIST,
+    CNVX_RENDERER_TOPOLOGY_LINE_LIST,
+    CNVX_RENDERER_TOPOLOGY_POINT_LIST, //the vertex shader has to write gl_PointSize
+    ___CNVX_RENDERER_TOPOLOGY_MAX,
+} CNVX_Renderer_Topology;
+
+typedef enum CNVX_Renderer_Cull
+{
+    CNVX_RENDERER_CULL_BACK, //clockwise triangles face the viewer
+    CNVX_RENDERER_CULL_NONE,
+    CNVX_RENDERER_CULL_FRONT,
+    ___CNVX_RENDERER_CULL_MAX,
+} CNVX_Renderer_Cull;
+
+//fixed function state of the following draws, zero initialised is the default
+typedef struct CNVX_Renderer_Draw_State
+{
+    CNVX_Renderer_Blend blend;
+    CNVX_Renderer_Topology topology; //quads are always drawn as triangle lists
+    CNVX_Renderer_Cull cull;
+} CNVX_Renderer_Draw_State;
+
+//one instance of the unit quad [0,1]x[0,1]
+typedef struct CNVX_Renderer_Quad
+{
+    float transform[6]; //x axis, y axis and translation of a 2x3 affine transform
+    float uv[4]; //u min, v min, u max, v max
+    float color[4];
+    uint32_t texture_index;
+    uint32_t reserved;
+} CNVX_Renderer_Quad;
+
 typedef struct CNVX_Renderer_Settings
 {
     bool vsync_is;
+    CNVX_Renderer_Present_Mode present_mode;
+    size_t swapchain_buffer_count; //requested depth of 2 or 3 clamped to the surface, =0 selects CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_DEFAULT
+    size_t frame_in_flight_count; //=0 selects CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_DEFAULT
+    const char* pipeline_cache_path; //=NULL keeps the pipeline cache in memory only
+    size_t worker_count; //=0 starts one worker thread per online processor
+    bool physical_device_override_is; //=false selects the physical device with the highest score
+    size_t physical_device_override_index;
+    size_t transfer_staging_size; //=0 selects CNVX_RENDERER_TRANSFER_STAGING_SIZE_DEFAULT
+    size_t memory_linear_size; //per frame in flight, =0 selects CNVX_RENDERER_MEMORY_LINEAR_SIZE_DEFAULT
+    bool headless_is; //renders into renderer owned images without window, surface or swapchain, start takes window=NULL
+    uint32_t headless_width;
+    uint32_t headless_height;
+    uint32_t headless_format; //a VkFormat usable as color attachment, =0 selects VK_FORMAT_B8G8R8A8_UNORM
+    bool frame_pacing_is; //sleeps before every frame so it starts as late as its deadline allows
+    size_t frame_pacing_time_us; //target frame time, =0 follows the refresh rate of the monitor showing the window
+    bool dynamic_rendering_is; //renders straight into image views without render pass and framebuffers where VK_KHR_dynamic_rendering is available
+    bool shader_reload_is; //watches the loaded shader files with inotify and swaps rewritten ones in at a frame boundary, linux only
 } CNVX_Renderer_Settings;
 
+//tightly packed rows of the rendered image, owned by the renderer
+typedef struct CNVX_Renderer_Readback
+{
+    const void* data;
+    size_t width;
+    size_t height;
+    size_t row_size;
+    uint32_t format; //VkFormat of the image
+    uint64_t frame; //serial of the captured frame, increasing
+} CNVX_Renderer_Readback;
+
+//std140 block at set 1 binding 0, the per draw block set with canvas_renderer_draw_uniform_set is at binding 1
+typedef struct CNVX_Renderer_Frame_Uniform
+{
+    float transform[16]; //column major view transform, identity by default
+    float viewport[4]; //x, y, width and height in pixels, filled in by the renderer
+    float time; //seconds, left to the application
+    float time_delta;
+    float reserved[2];
+} CNVX_Renderer_Frame_Uniform;
+
+//where an image lives inside the shared atlas pages, fits CNVX_Renderer_Quad
+typedef struct CNVX_Renderer_Atlas_Region
+{
+    uint32_t texture_index;
+    float uv[4]; //u min, v min, u max, v max
+} CNVX_Renderer_Atlas_Region;
+
+typedef struct CNVX_Renderer_Pipeline_Cache_Stats
+{
+    size_t hit_count;
+    size_t miss_count;
+    size_t unknown_count; //pipelines created without creation feedback support
+    size_t loaded_size;
+    size_t variant_count; //pipeline state variants requested, every start builds them anew
+} CNVX_Renderer_Pipeline_Cache_Stats;
+
+//milliseconds of gpu time, all zero without samples
+typedef struct CNVX_Renderer_Timestamp_Series_Stats
+{
+    size_t sample_count;
+    double min;
+    double avg;
+    double p99;
+} CNVX_Renderer_Timestamp_Series_Stats;
+
+typedef struct CNVX_Renderer_Timestamp_Stats
+{
+    bool supported_is; //=false if the graphics queue can not write timestamps
+    CNVX_Renderer_Timestamp_Series_Stats frame; //whole command buffer
+    CNVX_Renderer_Timestamp_Series_Stats pass; //render pass
+    CNVX_Renderer_Timestamp_Series_Stats region_all[CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX];
+} CNVX_Renderer_Timestamp_Stats;
+
+typedef struct CNVX_Renderer_Frame_Pacing_Stats
+{
+    double frame_time; //target in milliseconds, =0 if frames are not paced
+    double work_time; //estimated milliseconds from wake up to submission
+    size_t frame_count;
+    size_t missed_count; //frames submitted after their deadline
+} CNVX_Renderer_Frame_Pacing_Stats;
+
+typedef struct CNVX_Renderer_Memory_Heap_Stats
+{
+    size_t size;
+    bool device_local_is;
+    size_t allocation_count; //live vkAllocateMemory blocks
+    size_t allocated_size;
+    size_t used_size; //handed out to resources, rounded up to the size class
+} CNVX_Renderer_Memory_Heap_Stats;
+
+typedef struct CNVX_Renderer_Memory_Stats
+{
+    size_t heap_count;
+    CNVX_Renderer_Memory_Heap_Stats heap_all[CNVX_RENDERER_MEMORY_HEAP_COUNT_MAX];
+    size_t linear_size;
+    size_t linear_used_size_peak;
+} CNVX_Renderer_Memory_Stats;
+
 void* canvas_renderer_new(const CNVX_Renderer_Settings settings, const char* const app_name, const SPRX_VERSION app_version, const char* const engine_name, const SPRX_VERSION engine_version, const size_t id, void* const logger);
 void canvas_renderer_delete(void* const renderer);
 
 void canvas_renderer_start(void* const renderer, void* const window);
 void canvas_renderer_stop(void* const renderer);
 
+//records, submits and presents the frame, then waits for the pacing of the next one before returning
+//input polled after the return is sampled as late as the frame can start
 void canvas_renderer_update(void* const renderer);
 
+//waits for the pacing unless frame_end or update already did, then until the frame slot is free and recycles its command pool
+//call it before polling input, submits only begin the frame slot implicitly and never wait for the pacing
+void canvas_renderer_frame_begin(void* const renderer);
+//records, submits and presents the begun frame and waits for the pacing of the next one, same as canvas_renderer_update
+void canvas_renderer_frame_end(void* const renderer);
+
 void canvas_renderer_resize(void* const renderer);
 
+//recreates the swapchain if started, the mode in use is reported by canvas_renderer_present_mode_get
+void canvas_renderer_present_mode_set(void* const renderer, const CNVX_Renderer_Present_Mode present_mode);
+CNVX_Renderer_Present_Mode canvas_renderer_present_mode_get(void* const renderer);
+//image count of the current swapchain, may differ from the requested buffer count, =0 if not started
+size_t canvas_renderer_swapchain_image_count_get(void* const renderer);
+
+//copies the next drawn frame into a host visible ring buffer, dropped if all CNVX_RENDERER_READBACK_RING_COUNT are in use
+void canvas_renderer_readback_request(void* const renderer);
+//never waits, returns the oldest finished capture which stays valid until the next get or release
+bool canvas_renderer_readback_get(void* const renderer, CNVX_Renderer_Readback* const readback);
+void canvas_renderer_readback_release(void* const renderer);
+
+CNVX_Renderer_Pipeline_Cache_Stats canvas_renderer_pipeline_cache_stats_get(void* const renderer);
+//gpu durations of the last CNVX_RENDERER_TIMESTAMP_HISTORY_COUNT frames, results arrive frame_in_flight_count frames late
+CNVX_Renderer_Timestamp_Stats canvas_renderer_timestamp_stats_get(void* const renderer);
+CNVX_Renderer_Memory_Stats canvas_renderer_memory_stats_get(void* const renderer);
+CNVX_Renderer_Frame_Pacing_Stats canvas_renderer_frame_pacing_stats_get(void* const renderer);
+
+//read by every draw of the following frames, copied into the frame arena right before recording
+void canvas_renderer_frame_uniform_set(void* const renderer, const CNVX_Renderer_Frame_Uniform* const uniform);
+//up to CNVX_RENDERER_UNIFORM_SIZE_MAX bytes read by the draws submitted afterwards, until the next call or the end of the frame
+void canvas_renderer_draw_uniform_set(void* const renderer, const void* const data, const size_t size);
+//kept until the next call, every new combination builds its pipeline once on first use
+void canvas_renderer_draw_state_set(void* const renderer, const CNVX_Renderer_Draw_State* const state);
+
+//rgba8 pixels with tightly packed rows, uploaded through a staging buffer ahead of the next frame
+//mip_is=true generates the mip chain on the gpu, returns the index into the bindless texture array
+uint32_t canvas_renderer_texture_create(void* const renderer, const void* const pixel_all, const size_t width, const size_t height, const bool mip_is, const CNVX_Renderer_Texture_Filter filter);
+//frames in flight may still sample it, the memory is freed once they are done
+void canvas_renderer_texture_destroy(void* const renderer, const uint32_t texture_index);
+
+//packs a small rgba8 image into one of the shared atlas pages, an existing key keeps its region
+//the least recently drawn page is evicted when all are full, returns false if even that is not possible
+bool canvas_renderer_atlas_insert(void* const renderer, const uint64_t key, const void* const pixel_all, const size_t width, const size_t height, CNVX_Renderer_Atlas_Region* const region);
+//returns false if the key was never inserted or got evicted, has to be called every frame the region is drawn
+bool canvas_renderer_atlas_get(void* const renderer, const uint64_t key, CNVX_Renderer_Atlas_Region* const region);
+
 void canvas_renderer_shader_load(void* const renderer, const CNVX_Renderer_Shader_Type shader_type, const char* const path);
 
+//copied into the current frame, index_all=NULL draws the vertices in order
+void canvas_renderer_geometry_submit(void* const renderer, const CNVX_Renderer_Vertex* const vertex_all, const size_t vertex_count, const uint32_t* const index_all, const size_t index_count);
+//texture_index selects the texture from the bindless array through the push constants, no descriptor set is rebound
+void canvas_renderer_geometry_textured_submit(void* const renderer, const CNVX_Renderer_Vertex* const vertex_all, const size_t vertex_count, const uint32_t* const index_all, const size_t index_count, const uint32_t texture_index);
+
+//drawn with the quad shaders, consecutive submissions are merged into a single instanced draw
+void canvas_renderer_quad_submit(void* const renderer, const CNVX_Renderer_Quad* const quad_all, const size_t quad_count);
+
+//times the gpu work of the draws submitted in between, every region can be used once per frame
+void canvas_renderer_timestamp_region_begin(void* const renderer, const uint32_t region);
+void canvas_renderer_timestamp_region_end(void* const renderer, const uint32_t region);
+
 #endif // ___CNVX___RENDERER_H
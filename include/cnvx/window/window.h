@@ -71,6 +71,9 @@ void canvas_window_resize(void* const window, const size_t width, const size_t h
 
 void canvas_window_framebuffer_size_get(void* const window, size_t* const width_dest, size_t* const height_dest);
 
+//of the monitor containing the window center, =0 if unknown
+double canvas_window_refresh_rate_get(void* const window);
+
 void canvas_window_position_get(void* const window, size_t* const x_dest, size_t* const y_dest);
 void canvas_window_reposition(void* const window, const size_t x, const size_t y);
 
@@ -0,0 +1,228 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/renderer/Private/atlas_PRIVATE.h"
+
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CNVX_ATLAS_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("atlas", NULL, NULL)
+#define CNVX_ATLAS_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "atlas", info, care)
+#define CNVX_ATLAS_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("atlas", NULL, care)
+#define CNVX_ATLAS_ERROR_NULL(info) SPRX_ERROR_NULL("atlas", info)
+
+//splitmix64 finalizer, keys are often small consecutive ids
+size_t canvas_atlas_hash_PRIVATE(const uint64_t key_)
+{
+    uint64_t hash = key_ + 0x9E3779B97F4A7C15ull;
+    hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+    hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EBull;
+
+    return (size_t)(hash ^ (hash >> 31));
+}
+
+void canvas_atlas_rehash_PRIVATE(CNVX_Atlas_PRIVATE* const atlas_, const size_t capacity_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+
+    CNVX_Atlas_Entry_PRIVATE* const entry_all = atlas_->entry_all;
+    const size_t entry_capacity = atlas_->entry_capacity;
+
+    atlas_->entry_all = calloc(capacity_, sizeof(*atlas_->entry_all));
+    SPRX_ASSERT(NULL != atlas_->entry_all, CNVX_ATLAS_ERROR_ALLOCATION);
+
+    atlas_->entry_capacity = capacity_;
+    atlas_->entry_count = 0;
+
+    for (size_t i = 0; i < entry_capacity; i++)
+    {
+        //evicted pages are dropped by marking their entries unused before the rehash
+        if (entry_all[i].used_is)
+        {
+            canvas_atlas_insert(atlas_, entry_all[i].key, entry_all[i].page, entry_all[i].x, entry_all[i].y, entry_all[i].width, entry_all[i].height);
+        }
+    }
+
+    free(entry_all);
+}
+
+void canvas_atlas_create(CNVX_Atlas_PRIVATE* const atlas_, const uint32_t page_size_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+    SPRX_ASSERT(2 * CNVX_ATLAS_PADDING < page_size_, CNVX_ATLAS_ERROR_ARGUMENT("page_size has to be >2*CNVX_ATLAS_PADDING"));
+
+    memset(atlas_, 0, sizeof(*atlas_));
+
+    atlas_->page_size = page_size_;
+
+    canvas_atlas_rehash_PRIVATE(atlas_, CNVX_ATLAS_ENTRY_CAPACITY_MIN);
+}
+
+void canvas_atlas_destroy(CNVX_Atlas_PRIVATE* const atlas_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+
+    free(atlas_->entry_all);
+
+    atlas_->entry_all = NULL;
+    atlas_->entry_capacity = 0;
+    atlas_->entry_count = 0;
+}
+
+CNVX_Atlas_Entry_PRIVATE* canvas_atlas_find(CNVX_Atlas_PRIVATE* const atlas_, const uint64_t key_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+
+    const size_t mask = atlas_->entry_capacity - 1;
+
+    //the load factor stays below one half, so there is always an unused slot ending the probe
+    for (size_t i = canvas_atlas_hash_PRIVATE(key_) & mask;; i = (i + 1) & mask)
+    {
+        if (!atlas_->entry_all[i].used_is)
+        {
+            return NULL;
+        }
+
+        if (key_ == atlas_->entry_all[i].key)
+        {
+            return &atlas_->entry_all[i];
+        }
+    }
+}
+
+CNVX_Atlas_Entry_PRIVATE* canvas_atlas_insert(CNVX_Atlas_PRIVATE* const atlas_, const uint64_t key_, const uint32_t page_, const uint32_t x_, const uint32_t y_, const uint32_t width_, const uint32_t height_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+    SPRX_ASSERT(CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX > page_, CNVX_ATLAS_ERROR_ARGUMENT("page has to be <CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX"));
+
+    if (2 * (atlas_->entry_count + 1) > atlas_->entry_capacity)
+    {
+        canvas_atlas_rehash_PRIVATE(atlas_, 2 * atlas_->entry_capacity);
+    }
+
+    const size_t mask = atlas_->entry_capacity - 1;
+
+    size_t i = canvas_atlas_hash_PRIVATE(key_) & mask;
+
+    while (atlas_->entry_all[i].used_is)
+    {
+        SPRX_ASSERT(key_ != atlas_->entry_all[i].key, CNVX_ATLAS_ERROR_LOGIC("failed to insert into atlas", "key is already in the atlas", NULL));
+
+        i = (i + 1) & mask;
+    }
+
+    CNVX_Atlas_Entry_PRIVATE* const entry = &atlas_->entry_all[i];
+    entry->used_is = true;
+    entry->key = key_;
+    entry->page = page_;
+    entry->x = x_;
+    entry->y = y_;
+    entry->width = width_;
+    entry->height = height_;
+
+    atlas_->entry_count++;
+
+    return entry;
+}
+
+bool canvas_atlas_page_pack(CNVX_Atlas_PRIVATE* const atlas_, const uint32_t page_, const uint32_t width_, const uint32_t height_, uint32_t* const x_, uint32_t* const y_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+    SPRX_ASSERT(CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX > page_, CNVX_ATLAS_ERROR_ARGUMENT("page has to be <CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX"));
+    SPRX_ASSERT(NULL != x_, CNVX_ATLAS_ERROR_NULL("x"));
+    SPRX_ASSERT(NULL != y_, CNVX_ATLAS_ERROR_NULL("y"));
+
+    CNVX_Atlas_Page_PRIVATE* const page = &atlas_->page_all[page_];
+
+    if (width_ > atlas_->page_size || height_ > atlas_->page_size)
+    {
+        return false;
+    }
+
+    CNVX_Atlas_Shelf_PRIVATE* best = NULL;
+
+    for (uint32_t i = 0; i < page->shelf_count; i++)
+    {
+        CNVX_Atlas_Shelf_PRIVATE* const shelf = &page->shelf_all[i];
+
+        if (height_ <= shelf->height && width_ <= atlas_->page_size - shelf->width_used && (NULL == best || shelf->height < best->height))
+        {
+            best = shelf;
+        }
+    }
+
+    //a shelf more than twice as high as the image wastes too much, a new one is opened while there is room
+    const bool open_is = height_ <= atlas_->page_size - page->height_used && CNVX_ATLAS_SHELF_COUNT_MAX > page->shelf_count;
+
+    if (NULL == best || (best->height > 2 * height_ && open_is))
+    {
+        if (!open_is)
+        {
+            return false;
+        }
+
+        best = &page->shelf_all[page->shelf_count++];
+        best->y = page->height_used;
+        best->height = height_;
+        best->width_used = 0;
+
+        page->height_used += height_;
+    }
+
+    *x_ = best->width_used;
+    *y_ = best->y;
+
+    best->width_used += width_;
+
+    return true;
+}
+
+void canvas_atlas_page_evict(CNVX_Atlas_PRIVATE* const atlas_, const uint32_t page_)
+{
+    SPRX_ASSERT(NULL != atlas_, CNVX_ATLAS_ERROR_NULL("atlas"));
+    SPRX_ASSERT(CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX > page_, CNVX_ATLAS_ERROR_ARGUMENT("page has to be <CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX"));
+
+    CNVX_Atlas_Page_PRIVATE* const page = &atlas_->page_all[page_];
+
+    page->height_used = 0;
+    page->shelf_count = 0;
+
+    size_t evict_count = 0;
+
+    for (size_t i = 0; i < atlas_->entry_capacity; i++)
+    {
+        if (atlas_->entry_all[i].used_is && page_ == atlas_->entry_all[i].page)
+        {
+            atlas_->entry_all[i].used_is = false;
+            evict_count++;
+        }
+    }
+
+    //probe chains may run through the freed slots, rebuilding is cheap next to a page upload
+    if (0 != evict_count)
+    {
+        canvas_atlas_rehash_PRIVATE(atlas_, atlas_->entry_capacity);
+    }
+}
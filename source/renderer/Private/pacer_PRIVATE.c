@@ -0,0 +1,138 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/renderer/Private/pacer_PRIVATE.h"
+
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <time.h>
+
+#define CNVX_PACER_ERROR_NULL(info) SPRX_ERROR_NULL("pacer", info)
+
+int64_t canvas_pacer_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void canvas_pacer_reset(CNVX_Pacer_PRIVATE* const pacer_, const int64_t period_)
+{
+    SPRX_ASSERT(NULL != pacer_, CNVX_PACER_ERROR_NULL("pacer"));
+
+    pacer_->period = period_;
+    pacer_->deadline = 0;
+    pacer_->wake = canvas_pacer_now();
+    pacer_->work_estimate = 0;
+    pacer_->slack = CNVX_PACER_SLACK_DEFAULT;
+    pacer_->frame_count = 0;
+    pacer_->missed_count = 0;
+    pacer_->waited_is = false;
+}
+
+void canvas_pacer_period_set(CNVX_Pacer_PRIVATE* const pacer_, const int64_t period_)
+{
+    SPRX_ASSERT(NULL != pacer_, CNVX_PACER_ERROR_NULL("pacer"));
+
+    pacer_->period = period_;
+    pacer_->deadline = 0;
+}
+
+void canvas_pacer_wait(CNVX_Pacer_PRIVATE* const pacer_)
+{
+    SPRX_ASSERT(NULL != pacer_, CNVX_PACER_ERROR_NULL("pacer"));
+
+    //a second call would restart the work measured for this frame
+    if (pacer_->waited_is)
+    {
+        return;
+    }
+
+    pacer_->waited_is = true;
+
+    if (0 == pacer_->period || 0 == pacer_->deadline)
+    {
+        pacer_->wake = canvas_pacer_now();
+        return;
+    }
+
+    //starting as late as possible keeps the input sampled for this frame fresh
+    const int64_t target = pacer_->deadline - pacer_->work_estimate;
+
+    int64_t now = canvas_pacer_now();
+
+    if (target - pacer_->slack > now)
+    {
+        const int64_t sleep = target - pacer_->slack - now;
+
+        struct timespec duration;
+        duration.tv_sec = (time_t)(sleep / 1000000000);
+        duration.tv_nsec = (long)(sleep % 1000000000);
+
+        nanosleep(&duration, NULL);
+
+        now = canvas_pacer_now();
+
+        const int64_t overshoot = now - (target - pacer_->slack);
+
+        pacer_->slack = SPRX_MAX(SPRX_MAX(overshoot, pacer_->slack - pacer_->slack / 16), CNVX_PACER_SLACK_MIN);
+    }
+
+    while (target > now)
+    {
+        now = canvas_pacer_now();
+    }
+
+    pacer_->wake = now;
+}
+
+void canvas_pacer_submitted(CNVX_Pacer_PRIVATE* const pacer_)
+{
+    SPRX_ASSERT(NULL != pacer_, CNVX_PACER_ERROR_NULL("pacer"));
+
+    const int64_t now = canvas_pacer_now();
+
+    pacer_->work_estimate = SPRX_MAX(now - pacer_->wake, pacer_->work_estimate - pacer_->work_estimate / 16);
+    pacer_->frame_count++;
+    pacer_->waited_is = false;
+
+    if (0 == pacer_->period)
+    {
+        return;
+    }
+
+    if (0 == pacer_->deadline)
+    {
+        pacer_->deadline = now + pacer_->period;
+    }
+    else if (now > pacer_->deadline)
+    {
+        pacer_->missed_count++;
+        pacer_->deadline = now + pacer_->period;
+    }
+    else
+    {
+        pacer_->deadline += pacer_->period;
+    }
+}
@@ -23,6 +23,11 @@
 #include "cnvx/logger/logger.h"
 #include "cnvx/renderer/Private/renderer_PRIVATE.h"
 #include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_reload_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_transfer_PRIVATE.h"
+#include "cnvx/renderer/Private/worker_PRIVATE.h"
 #include "cnvx/window/window.h"
 
 #include "sprx/container/string.h"
@@ -30,15 +35,27 @@
 #include "sprx/core/assert.h"
 #include "sprx/core/core.h"
 #include "sprx/core/terminate.h"
+#include "sprx/file/file.h"
+#include "sprx/thread/mutex.h"
 
 #include "GLFW/glfw3.h"
 
+#include <stddef.h>
+#include <string.h>
+
 #define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
 #define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
 #define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
 #define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
 #define CNVX_VULKAN_ERROR_ENUM(info) SPRX_ERROR_ENUM("vulkan", info, NULL)
 
+#define CNVX_VULKAN_DEVICE_EXTENSION_COUNT_MAX 8
+
+#define CNVX_VULKAN_QUAD_INDEX_OFFSET (4 * 2 * sizeof(float))
+#define CNVX_VULKAN_QUAD_INDEX_COUNT 6
+
+#define CNVX_VULKAN_PIPELINE_CACHE_MAGIC 0x58564E43 //"CNVX"
+
 #ifdef ___CNVX_DEBUG
     #define CNVX_VULKAN_SURFACE_LAYER_VALIDATION "VK_LAYER_KHRONOS_validation"
     #define CNVX_VULKAN_SURFACE_LAYER_VALIDATION_COUNT 1
@@ -47,6 +64,17 @@
     #define CNVX_VULKAN_SURFACE_LAYER_VALIDATION_COUNT 0
 #endif // ___CNVX_DEBUG
 
+typedef struct CNVX_Vulkan_Pipeline_Cache_Header_PRIVATE
+{
+    uint32_t magic;
+    uint32_t header_size;
+    uint32_t vendor_id;
+    uint32_t device_id;
+    uint32_t driver_version;
+    uint8_t uuid[VK_UUID_SIZE];
+    uint64_t data_size;
+} CNVX_Vulkan_Pipeline_Cache_Header_PRIVATE;
+
 const char* canvas_vulkan_result_name_get_PRIVATE(const VkResult result_)
 {
     SPRX_ASSERT(VK_RESULT_MAX_ENUM > result_, CNVX_VULKAN_ERROR_ENUM("invalid value of result"));
@@ -141,8 +169,10 @@ VkShaderStageFlagBits canvas_vulkan_shader_stage_flag_bit_get_PRIVATE(const CNVX
     switch (type_)
     {
     case CNVX_RENDERER_SHADER_TYPE_VERTEX:
+    case CNVX_RENDERER_SHADER_TYPE_QUAD_VERTEX:
         return VK_SHADER_STAGE_VERTEX_BIT;
     case CNVX_RENDERER_SHADER_TYPE_FRAGMENT:
+    case CNVX_RENDERER_SHADER_TYPE_QUAD_FRAGMENT:
         return VK_SHADER_STAGE_FRAGMENT_BIT;
     default:
         SPRX_ABORT_ERROR(SPRX_ERROR_BOUNDS("vulkan", "invalid type", NULL));
@@ -150,6 +180,129 @@ VkShaderStageFlagBits canvas_vulkan_shader_stage_flag_bit_get_PRIVATE(const CNVX
     }
 }
 
+CNVX_Renderer_Pipeline_PRIVATE canvas_vulkan_shader_pipeline_get(const CNVX_Renderer_Shader_Type type_)
+{
+    SPRX_ASSERT(___CNVX_RENDERER_SHADER_TYPE_MAX > type_, CNVX_VULKAN_ERROR_ENUM("invalid value of type"));
+
+    switch (type_)
+    {
+    case CNVX_RENDERER_SHADER_TYPE_VERTEX:
+    case CNVX_RENDERER_SHADER_TYPE_FRAGMENT:
+        return CNVX_RENDERER_PIPELINE_GEOMETRY;
+    case CNVX_RENDERER_SHADER_TYPE_QUAD_VERTEX:
+    case CNVX_RENDERER_SHADER_TYPE_QUAD_FRAGMENT:
+        return CNVX_RENDERER_PIPELINE_QUAD;
+    default:
+        SPRX_ABORT_ERROR(SPRX_ERROR_BOUNDS("vulkan", "invalid type", NULL));
+        break;
+    }
+}
+
+VkPrimitiveTopology canvas_vulkan_topology_get_PRIVATE(const CNVX_Renderer_Topology topology_)
+{
+    SPRX_ASSERT(___CNVX_RENDERER_TOPOLOGY_MAX > topology_, CNVX_VULKAN_ERROR_ENUM("invalid value of topology"));
+
+    switch (topology_)
+    {
+    case CNVX_RENDERER_TOPOLOGY_TRIANGLE_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    case CNVX_RENDERER_TOPOLOGY_LINE_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+    case CNVX_RENDERER_TOPOLOGY_POINT_LIST:
+        return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+    default:
+        SPRX_ABORT_ERROR(SPRX_ERROR_BOUNDS("vulkan", "invalid topology", NULL));
+        break;
+    }
+}
+
+VkCullModeFlags canvas_vulkan_cull_mode_get_PRIVATE(const CNVX_Renderer_Cull cull_)
+{
+    SPRX_ASSERT(___CNVX_RENDERER_CULL_MAX > cull_, CNVX_VULKAN_ERROR_ENUM("invalid value of cull"));
+
+    switch (cull_)
+    {
+    case CNVX_RENDERER_CULL_BACK:
+        return VK_CULL_MODE_BACK_BIT;
+    case CNVX_RENDERER_CULL_NONE:
+        return VK_CULL_MODE_NONE;
+    case CNVX_RENDERER_CULL_FRONT:
+        return VK_CULL_MODE_FRONT_BIT;
+    default:
+        SPRX_ABORT_ERROR(SPRX_ERROR_BOUNDS("vulkan", "invalid cull", NULL));
+        break;
+    }
+}
+
+VkPipelineColorBlendAttachmentState canvas_vulkan_blend_attachment_get_PRIVATE(const CNVX_Renderer_Blend blend_)
+{
+    SPRX_ASSERT(___CNVX_RENDERER_BLEND_MAX > blend_, CNVX_VULKAN_ERROR_ENUM("invalid value of blend"));
+
+    VkPipelineColorBlendAttachmentState pipeline_color_blend_attachment_state;
+    pipeline_color_blend_attachment_state.blendEnable = VK_TRUE;
+    pipeline_color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+    pipeline_color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    pipeline_color_blend_attachment_state.colorBlendOp = VK_BLEND_OP_ADD;
+    pipeline_color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+    pipeline_color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+    pipeline_color_blend_attachment_state.alphaBlendOp = VK_BLEND_OP_ADD;
+    pipeline_color_blend_attachment_state.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    switch (blend_)
+    {
+    case CNVX_RENDERER_BLEND_ALPHA:
+        break;
+    case CNVX_RENDERER_BLEND_PREMULTIPLIED:
+        pipeline_color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        pipeline_color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        break;
+    case CNVX_RENDERER_BLEND_ADDITIVE:
+        //the destination alpha is kept
+        pipeline_color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+        pipeline_color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        pipeline_color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        break;
+    case CNVX_RENDERER_BLEND_OPAQUE:
+        pipeline_color_blend_attachment_state.blendEnable = VK_FALSE;
+        break;
+    default:
+        SPRX_ABORT_ERROR(SPRX_ERROR_BOUNDS("vulkan", "invalid blend", NULL));
+        break;
+    }
+
+    return pipeline_color_blend_attachment_state;
+}
+
+void canvas_vulkan_pipeline_cache_feedback_PRIVATE(void* const renderer_, const VkPipelineCreationFeedbackEXT* const feedback_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != feedback_, CNVX_VULKAN_ERROR_NULL("feedback"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //pipelines are built on the worker, so the counters may be touched concurrently
+    spore_mutex_lock(renderer->vk.pipeline_cache_mutex);
+
+    if (!renderer->vk.pipeline_creation_feedback_is || !(VK_PIPELINE_CREATION_FEEDBACK_VALID_BIT_EXT & feedback_->flags))
+    {
+        renderer->vk.pipeline_cache_stats.unknown_count++;
+    }
+    else if (VK_PIPELINE_CREATION_FEEDBACK_APPLICATION_PIPELINE_CACHE_HIT_BIT_EXT & feedback_->flags)
+    {
+        renderer->vk.pipeline_cache_stats.hit_count++;
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache hit after %lluns", (unsigned long long)feedback_->duration);
+    }
+    else
+    {
+        renderer->vk.pipeline_cache_stats.miss_count++;
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache miss after %lluns", (unsigned long long)feedback_->duration);
+    }
+
+    spore_mutex_unlock(renderer->vk.pipeline_cache_mutex);
+}
+
 void canvas_vulkan_assert(void* const renderer_, bool suppress_is_, const VkResult result_, const char* const file_, const char* const func_, const int line_, const char* const date_, const char* const time_, const char* const what_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
@@ -241,7 +394,13 @@ void canvas_vulkan_instance_create(void* const renderer_)
     const char* enabled_layers[] = { CNVX_VULKAN_SURFACE_LAYER_VALIDATION };
 
     uint32_t enabled_extentions_count = 0;
-    const char** enabled_extentions = glfwGetRequiredInstanceExtensions(&enabled_extentions_count);
+    const char** enabled_extentions = NULL;
+
+    //headless mode has to work without a display, where glfw can not provide surface extensions
+    if (!renderer->settings.headless_is)
+    {
+        enabled_extentions = glfwGetRequiredInstanceExtensions(&enabled_extentions_count);
+    }
 
     VkInstanceCreateInfo instance_create_info;
     instance_create_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -298,14 +457,29 @@ void canvas_vulkan_physical_devices_enumerate(void* const renderer_)
     renderer->vk.physical_device_memory_properties_all = malloc(sizeof(*renderer->vk.physical_device_memory_properties_all) * renderer->vk.physical_device_count);
     SPRX_ASSERT(NULL != renderer->vk.physical_device_memory_properties_all, CNVX_VULKAN_ERROR_ALLOCATION);
 
+    renderer->vk.physical_device_extension_count_all = malloc(sizeof(*renderer->vk.physical_device_extension_count_all) * renderer->vk.physical_device_count);
+    SPRX_ASSERT(NULL != renderer->vk.physical_device_extension_count_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    renderer->vk.physical_device_extension_all = malloc(sizeof(*renderer->vk.physical_device_extension_all) * renderer->vk.physical_device_count);
+    SPRX_ASSERT(NULL != renderer->vk.physical_device_extension_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
     for (uint32_t i = 0; i < renderer->vk.physical_device_count; i++)
     {
         vkGetPhysicalDeviceProperties(renderer->vk.physical_device_all[i], &renderer->vk.physical_device_properties_all[i]);
         vkGetPhysicalDeviceFeatures(renderer->vk.physical_device_all[i], &renderer->vk.physical_device_features_all[i]);
         vkGetPhysicalDeviceMemoryProperties(renderer->vk.physical_device_all[i], &renderer->vk.physical_device_memory_properties_all[i]);
-    }
 
-    renderer->vk.physical_device_use_index = 0; //@TODO
+        //read once here, the selection and the device creation both look them up
+        renderer->vk.physical_device_extension_count_all[i] = 0;
+        result = vkEnumerateDeviceExtensionProperties(renderer->vk.physical_device_all[i], NULL, &renderer->vk.physical_device_extension_count_all[i], NULL);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkEnumerateDeviceExtensionProperties (1/2) of physical device %u", i);
+
+        renderer->vk.physical_device_extension_all[i] = malloc(sizeof(*renderer->vk.physical_device_extension_all[i]) * SPRX_MAX(renderer->vk.physical_device_extension_count_all[i], 1));
+        SPRX_ASSERT(NULL != renderer->vk.physical_device_extension_all[i], CNVX_VULKAN_ERROR_ALLOCATION);
+
+        result = vkEnumerateDeviceExtensionProperties(renderer->vk.physical_device_all[i], NULL, &renderer->vk.physical_device_extension_count_all[i], renderer->vk.physical_device_extension_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkEnumerateDeviceExtensionProperties (2/2) of physical device %u", i);
+    }
 }
 
 void canvas_vulkan_physical_devices_denumerate(void* const renderer_)
@@ -314,353 +488,1786 @@ void canvas_vulkan_physical_devices_denumerate(void* const renderer_)
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
+    for (uint32_t i = 0; i < renderer->vk.physical_device_count; i++)
+    {
+        free(renderer->vk.physical_device_extension_all[i]);
+    }
+
+    free(renderer->vk.physical_device_extension_all);
+    free(renderer->vk.physical_device_extension_count_all);
+    free(renderer->vk.physical_device_memory_properties_all);
+    free(renderer->vk.physical_device_features_all);
+    free(renderer->vk.physical_device_properties_all);
     free(renderer->vk.physical_device_all);
 
     CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: physical device denumeration");
 }
 
-void canvas_vulkan_device_create(void* const renderer_)
+const char* canvas_vulkan_physical_device_type_name_get_PRIVATE(const VkPhysicalDeviceType type_)
 {
-    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    switch (type_)
+    {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+        return "discrete gpu";
 
-    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+        return "integrated gpu";
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: device creation");
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+        return "virtual gpu";
 
-    renderer->vk.queue_family_count = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(renderer->vk.physical_device_all[0], &renderer->vk.queue_family_count, NULL); //@TODO
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        return "cpu";
 
-    SPRX_ASSERT(0 != renderer->vk.queue_family_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "queue family count has to be >0", NULL));
+    default:
+        return "other";
+    }
+}
 
-    renderer->vk.queue_family_properties = malloc(sizeof(*renderer->vk.queue_family_properties) * renderer->vk.queue_family_count);
-    SPRX_ASSERT(NULL != renderer->vk.queue_family_properties, CNVX_VULKAN_ERROR_ALLOCATION);
+uint64_t canvas_vulkan_physical_device_type_score_get_PRIVATE(const VkPhysicalDeviceType type_)
+{
+    switch (type_)
+    {
+    case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
+        return 4;
 
-    vkGetPhysicalDeviceQueueFamilyProperties(renderer->vk.physical_device_all[0], &renderer->vk.queue_family_count, renderer->vk.queue_family_properties); //@TODO
+    case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU:
+        return 3;
 
-    const float queue_priorities[] = { 1.0f };
+    case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:
+        return 2;
 
-    renderer->vk.queue_family_use_index = 0; //@TOD
+    case VK_PHYSICAL_DEVICE_TYPE_CPU:
+        return 1;
 
-    VkDeviceQueueCreateInfo device_queue_create_info;
-    device_queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    device_queue_create_info.pNext = NULL;
-    device_queue_create_info.flags = 0;
-    device_queue_create_info.queueFamilyIndex = renderer->vk.queue_family_use_index;
-    device_queue_create_info.queueCount = 1;//@TODO
-    device_queue_create_info.pQueuePriorities = queue_priorities;
+    default:
+        return 0;
+    }
+}
 
-    uint32_t enabled_layers_count = 0;
-    const char* enabled_layers[] = { "" };
+VkDeviceSize canvas_vulkan_physical_device_local_heap_size_get_PRIVATE(void* const renderer_, const size_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
-    uint32_t enabled_extentions_count = 1;
-    const char* enabled_extentions[] = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    VkPhysicalDeviceFeatures enabled_physical_device_features = { VK_FALSE };
+    const VkPhysicalDeviceMemoryProperties* const memory_properties = &renderer->vk.physical_device_memory_properties_all[index_];
 
-    VkDeviceCreateInfo device_create_info;
-    device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
-    device_create_info.pNext = NULL;
-    device_create_info.flags = 0;
-    device_create_info.queueCreateInfoCount = 1;
-    device_create_info.pQueueCreateInfos = &device_queue_create_info;
-    device_create_info.enabledLayerCount = enabled_layers_count;
-    device_create_info.ppEnabledLayerNames = enabled_layers;
-    device_create_info.enabledExtensionCount = enabled_extentions_count;
-    device_create_info.ppEnabledExtensionNames = enabled_extentions;
-    device_create_info.pEnabledFeatures = &enabled_physical_device_features;
+    VkDeviceSize size = 0;
 
-    VkResult result = vkCreateDevice(renderer->vk.physical_device_all[0], &device_create_info, NULL, &renderer->vk.device);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDevice");
+    for (uint32_t i = 0; i < memory_properties->memoryHeapCount; i++)
+    {
+        if (VK_MEMORY_HEAP_DEVICE_LOCAL_BIT & memory_properties->memoryHeaps[i].flags)
+        {
+            size = SPRX_MAX(size, memory_properties->memoryHeaps[i].size);
+        }
+    }
 
-    vkGetDeviceQueue(renderer->vk.device, renderer->vk.queue_family_use_index, 0, &renderer->vk.queue); //@TODO
+    return size;
 }
 
-void canvas_vulkan_device_destroy(void* const renderer_)
+bool canvas_vulkan_physical_device_swapchain_support_is_PRIVATE(void* const renderer_, const size_t index_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    vkDestroyDevice(renderer->vk.device, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyDevice");
+    const VkExtensionProperties* const extension_all = renderer->vk.physical_device_extension_all[index_];
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: device destruction");
+    for (uint32_t i = 0; i < renderer->vk.physical_device_extension_count_all[index_]; i++)
+    {
+        if (0 == strcmp(VK_KHR_SWAPCHAIN_EXTENSION_NAME, extension_all[i].extensionName))
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-void canvas_vulkan_surface_create(void* const renderer_)
+//the subset the bindless set relies on, =false below vulkan 1.2
+bool canvas_vulkan_physical_device_descriptor_indexing_is_PRIVATE(void* const renderer_, const size_t index_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: surface creation");
-
-    VkResult result = glfwCreateWindowSurface(renderer->vk.instance, canvas_window_handle_get(renderer->window), NULL, &renderer->vk.surface);
-    CNVX_VULKAN_ASSERT(renderer, result, "glfwCreateWindowSurface");
-
-    result = vkGetPhysicalDeviceSurfaceSupportKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.queue_family_use_index, renderer->vk.surface, &renderer->vk.surface_support_is);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceSupportKHR");
-
-    if (renderer->vk.surface_support_is)
-    {
-        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: surface support is available");
-    }
-    else
+    if (VK_API_VERSION_1_2 > renderer->vk.physical_device_properties_all[index_].apiVersion)
     {
-        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: no surface support is not available");
+        return false;
     }
 
-    result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &renderer->vk.surface_capabilities);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
-
-    uint32_t surface_formats_count = 0;
-    result = vkGetPhysicalDeviceSurfaceFormatsKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &surface_formats_count, NULL);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceFormatsKHR (1/2)");
+    VkPhysicalDeviceVulkan12Features physical_device_vulkan12_features;
+    memset(&physical_device_vulkan12_features, 0, sizeof(physical_device_vulkan12_features));
+    physical_device_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
 
-    SPRX_ASSERT(0 != surface_formats_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "surface formats count has to be >0", NULL));
+    VkPhysicalDeviceFeatures2 physical_device_features2;
+    physical_device_features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    physical_device_features2.pNext = &physical_device_vulkan12_features;
 
-    renderer->vk.surface_format_all = malloc(sizeof(*renderer->vk.surface_format_all) * surface_formats_count);
-    SPRX_ASSERT(NULL != renderer->vk.surface_format_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    vkGetPhysicalDeviceFeatures2(renderer->vk.physical_device_all[index_], &physical_device_features2);
 
-    result = vkGetPhysicalDeviceSurfaceFormatsKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &surface_formats_count, renderer->vk.surface_format_all);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceFormatsKHR (2/2)");
+    return VK_TRUE == physical_device_vulkan12_features.runtimeDescriptorArray && VK_TRUE == physical_device_vulkan12_features.descriptorBindingPartiallyBound && VK_TRUE == physical_device_vulkan12_features.descriptorBindingUpdateUnusedWhilePending && VK_TRUE == physical_device_vulkan12_features.descriptorBindingSampledImageUpdateAfterBind && VK_TRUE == physical_device_vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind && VK_TRUE == physical_device_vulkan12_features.shaderSampledImageArrayNonUniformIndexing;
+}
 
-    renderer->vk.format_use = VK_FORMAT_B8G8R8A8_UNORM;
+//returns false if no queue family supports both graphics and present, present is not required in headless mode
+bool canvas_vulkan_physical_device_queue_family_find_PRIVATE(void* const renderer_, const size_t index_, uint32_t* const queue_family_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != queue_family_index_, CNVX_VULKAN_ERROR_NULL("queue_family_index"));
 
-    uint32_t surface_present_modes_count = 0;
-    vkGetPhysicalDeviceSurfacePresentModesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &surface_present_modes_count, NULL);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfacePresentModesKHR (1/2)");
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    SPRX_ASSERT(0 != surface_present_modes_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "surface present modes count has to be >0", NULL));
+    uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(renderer->vk.physical_device_all[index_], &queue_family_count, NULL);
 
-    renderer->vk.surface_present_mode_all = malloc(sizeof(*renderer->vk.surface_present_mode_all) * surface_present_modes_count);
-    SPRX_ASSERT(NULL != renderer->vk.surface_present_mode_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    VkQueueFamilyProperties* const queue_family_properties = malloc(sizeof(*queue_family_properties) * SPRX_MAX(queue_family_count, 1));
+    SPRX_ASSERT(NULL != queue_family_properties, CNVX_VULKAN_ERROR_ALLOCATION);
 
-    vkGetPhysicalDeviceSurfacePresentModesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &surface_present_modes_count, renderer->vk.surface_present_mode_all);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfacePresentModesKHR (2/2)");
-}
+    vkGetPhysicalDeviceQueueFamilyProperties(renderer->vk.physical_device_all[index_], &queue_family_count, queue_family_properties);
 
-void canvas_vulkan_surface_destroy(void* const renderer_)
-{
-    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    bool found_is = false;
 
-    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    for (uint32_t i = 0; i < queue_family_count; i++)
+    {
+        if (0 == queue_family_properties[i].queueCount || !(VK_QUEUE_GRAPHICS_BIT & queue_family_properties[i].queueFlags))
+        {
+            continue;
+        }
 
-    free(renderer->vk.surface_present_mode_all);
-    free(renderer->vk.surface_format_all);
+        if (renderer->settings.headless_is || GLFW_TRUE == glfwGetPhysicalDevicePresentationSupport(renderer->vk.instance, renderer->vk.physical_device_all[index_], i))
+        {
+            *queue_family_index_ = i;
+            found_is = true;
+            break;
+        }
+    }
 
-    vkDestroySurfaceKHR(renderer->vk.instance, renderer->vk.surface, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySurfaceKHR");
+    free(queue_family_properties);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: surface destruction");
+    return found_is;
 }
 
-void canvas_vulkan_swapchain_create(void* const renderer_)
+void canvas_vulkan_physical_device_select(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: swapchain creation");
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: physical device selection");
 
-    VkSwapchainCreateInfoKHR swapchain_create_info;
-    swapchain_create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    swapchain_create_info.pNext = NULL;
-    swapchain_create_info.flags = 0;
-    swapchain_create_info.surface = renderer->vk.surface;
-    swapchain_create_info.minImageCount = 1; //@TODO
-    swapchain_create_info.imageFormat = renderer->vk.format_use;
-    swapchain_create_info.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR; //@TODO
+    bool found_is = false;
+    uint64_t score_best = 0;
 
-    swapchain_create_info.imageExtent.width = renderer->width;
-    swapchain_create_info.imageExtent.height = renderer->height;
-    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: image extend is %ux%u", renderer->width, renderer->height);
+    for (uint32_t i = 0; i < renderer->vk.physical_device_count; i++)
+    {
+        const VkPhysicalDeviceProperties* const properties = &renderer->vk.physical_device_properties_all[i];
+        const VkDeviceSize heap_size = canvas_vulkan_physical_device_local_heap_size_get_PRIVATE(renderer, i);
 
-    swapchain_create_info.imageArrayLayers = 1;
-    swapchain_create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT; //@TODO
-    swapchain_create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE; //@TODO
-    swapchain_create_info.queueFamilyIndexCount = 0; //@TODO
-    swapchain_create_info.pQueueFamilyIndices = NULL; //@TODO
-    swapchain_create_info.preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
-    swapchain_create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
-    swapchain_create_info.presentMode = VK_PRESENT_MODE_FIFO_KHR; //@TODO
-    swapchain_create_info.clipped = VK_TRUE;
-    swapchain_create_info.oldSwapchain = renderer->vk.swapchain;
+        uint32_t queue_family_index = 0;
 
-    VkResult result = vkCreateSwapchainKHR(renderer->vk.device, &swapchain_create_info, NULL, &renderer->vk.swapchain);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateSwapchainKHR");
+        if (!canvas_vulkan_physical_device_queue_family_find_PRIVATE(renderer, i, &queue_family_index))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: physical device %u '%s' rejected: no queue family with graphics and present support", i, properties->deviceName);
+            continue;
+        }
 
-    renderer->vk.swapchain_image_all_count = 0;
-    result = vkGetSwapchainImagesKHR(renderer->vk.device, renderer->vk.swapchain, &renderer->vk.swapchain_image_all_count, NULL);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetSwapchainImagesKHR (1/2)");
+        if (!renderer->settings.headless_is && !canvas_vulkan_physical_device_swapchain_support_is_PRIVATE(renderer, i))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: physical device %u '%s' rejected: no swapchain support", i, properties->deviceName);
+            continue;
+        }
 
-    SPRX_ASSERT(0 != renderer->vk.swapchain_image_all_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "swapchain image count has to be >0", NULL));
+        if (!canvas_vulkan_physical_device_descriptor_indexing_is_PRIVATE(renderer, i))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: physical device %u '%s' rejected: no vulkan 1.2 descriptor indexing support", i, properties->deviceName);
+            continue;
+        }
 
-    renderer->vk.swapchain_image_all = malloc(sizeof(*renderer->vk.swapchain_image_all) * renderer->vk.swapchain_image_all_count);
-    SPRX_ASSERT(NULL != renderer->vk.swapchain_image_all, CNVX_VULKAN_ERROR_ALLOCATION);
+        //device type dominates, the largest device local heap (in MiB) breaks ties
+        const uint64_t score = (canvas_vulkan_physical_device_type_score_get_PRIVATE(properties->deviceType) << 48) + (heap_size >> 20) + 1;
 
-    vkGetSwapchainImagesKHR(renderer->vk.device, renderer->vk.swapchain, &renderer->vk.swapchain_image_all_count, renderer->vk.swapchain_image_all);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkGetSwapchainImagesKHR (2/2)");
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: physical device %u '%s' (%s, %lluMiB device local, queue family %u) scored %llu", i, properties->deviceName, canvas_vulkan_physical_device_type_name_get_PRIVATE(properties->deviceType), (unsigned long long)(heap_size >> 20), queue_family_index, (unsigned long long)score);
+
+        if (renderer->settings.physical_device_override_is)
+        {
+            if (renderer->settings.physical_device_override_index == i)
+            {
+                renderer->vk.physical_device_use_index = i;
+                renderer->vk.queue_family_use_index = queue_family_index;
+                found_is = true;
+            }
+        }
+        else if (score > score_best)
+        {
+            score_best = score;
+            renderer->vk.physical_device_use_index = i;
+            renderer->vk.queue_family_use_index = queue_family_index;
+            found_is = true;
+        }
+    }
+
+    if (renderer->settings.physical_device_override_is)
+    {
+        SPRX_ASSERT(renderer->vk.physical_device_count > renderer->settings.physical_device_override_index, CNVX_VULKAN_ERROR_ARGUMENT("settings.physical_device_override_index has to be <physical device count"));
+        SPRX_ASSERT(found_is, CNVX_VULKAN_ERROR_LOGIC("could not continue", "overridden physical device is not suitable", NULL));
+    }
+    else
+    {
+        SPRX_ASSERT(found_is, CNVX_VULKAN_ERROR_LOGIC("could not continue", "no suitable physical device found", NULL));
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: using physical device %u '%s' (%s), queue family %u%s", (unsigned)renderer->vk.physical_device_use_index, renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index].deviceName, canvas_vulkan_physical_device_type_name_get_PRIVATE(renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index].deviceType), renderer->vk.queue_family_use_index, renderer->settings.physical_device_override_is ? " as overridden by settings" : " as highest score");
 }
 
-void canvas_vulkan_swapchain_destroy(void* const renderer_)
+void canvas_vulkan_device_create(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    free(renderer->vk.swapchain_image_all);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: device creation");
 
-    vkDestroySwapchainKHR(renderer->vk.device, renderer->vk.swapchain, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySwapchainKHR");
+    renderer->vk.queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], &renderer->vk.queue_family_count, NULL);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: swapchain destruction");
-}
+    SPRX_ASSERT(0 != renderer->vk.queue_family_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "queue family count has to be >0", NULL));
 
-void canvas_vulkan_imageviews_create(void* const renderer_)
-{
-    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    renderer->vk.queue_family_properties = malloc(sizeof(*renderer->vk.queue_family_properties) * renderer->vk.queue_family_count);
+    SPRX_ASSERT(NULL != renderer->vk.queue_family_properties, CNVX_VULKAN_ERROR_ALLOCATION);
 
-    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    vkGetPhysicalDeviceQueueFamilyProperties(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], &renderer->vk.queue_family_count, renderer->vk.queue_family_properties);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: imageviews creation");
+    const float queue_priorities[] = { 1.0f };
+
+    VkPhysicalDeviceVulkan12Features physical_device_vulkan12_features;
+    memset(&physical_device_vulkan12_features, 0, sizeof(physical_device_vulkan12_features));
+    physical_device_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    renderer->vk.timeline_semaphore_is = false;
+
+    if (VK_API_VERSION_1_2 <= renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index].apiVersion)
+    {
+        VkPhysicalDeviceFeatures2 physical_device_features2;
+        physical_device_features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        physical_device_features2.pNext = &physical_device_vulkan12_features;
+
+        vkGetPhysicalDeviceFeatures2(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], &physical_device_features2);
+
+        renderer->vk.timeline_semaphore_is = VK_TRUE == physical_device_vulkan12_features.timelineSemaphore;
+    }
+
+    //the selection already skipped devices without it
+    renderer->vk.descriptor_indexing_is = canvas_vulkan_physical_device_descriptor_indexing_is_PRIVATE(renderer, renderer->vk.physical_device_use_index);
+
+    SPRX_ASSERT(renderer->vk.descriptor_indexing_is, CNVX_VULKAN_ERROR_LOGIC("could not continue", "physical device has to support descriptor indexing", NULL));
+
+    //prefer a transfer only family, then one without graphics, graphics queues can always transfer
+    renderer->vk.queue_family_transfer_index = renderer->vk.queue_family_use_index;
+    uint32_t transfer_rank_best = 0;
+
+    for (uint32_t i = 0; i < renderer->vk.queue_family_count; i++)
+    {
+        const VkQueueFlags flags = renderer->vk.queue_family_properties[i].queueFlags;
+
+        if (0 == renderer->vk.queue_family_properties[i].queueCount || !(VK_QUEUE_TRANSFER_BIT & flags) || (VK_QUEUE_GRAPHICS_BIT & flags))
+        {
+            continue;
+        }
+
+        const uint32_t transfer_rank = (VK_QUEUE_COMPUTE_BIT & flags) ? 1 : 2;
+
+        if (transfer_rank > transfer_rank_best)
+        {
+            transfer_rank_best = transfer_rank;
+            renderer->vk.queue_family_transfer_index = i;
+        }
+    }
+
+    renderer->vk.transfer_dedicated_is = renderer->vk.timeline_semaphore_is && renderer->vk.queue_family_transfer_index != renderer->vk.queue_family_use_index;
+
+    if (!renderer->vk.transfer_dedicated_is)
+    {
+        renderer->vk.queue_family_transfer_index = renderer->vk.queue_family_use_index;
+
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: no dedicated transfer queue family or timeline semaphore support, uploads fall back to the graphics queue");
+    }
+    else
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: using queue family %u for transfers", renderer->vk.queue_family_transfer_index);
+    }
+
+    uint32_t device_queue_create_info_count = 0;
+    VkDeviceQueueCreateInfo device_queue_create_info_all[2];
+
+    VkDeviceQueueCreateInfo device_queue_create_info;
+    device_queue_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+    device_queue_create_info.pNext = NULL;
+    device_queue_create_info.flags = 0;
+    device_queue_create_info.queueFamilyIndex = renderer->vk.queue_family_use_index;
+    device_queue_create_info.queueCount = 1;
+    device_queue_create_info.pQueuePriorities = queue_priorities;
+
+    device_queue_create_info_all[device_queue_create_info_count++] = device_queue_create_info;
+
+    if (renderer->vk.transfer_dedicated_is)
+    {
+        device_queue_create_info.queueFamilyIndex = renderer->vk.queue_family_transfer_index;
+
+        device_queue_create_info_all[device_queue_create_info_count++] = device_queue_create_info;
+    }
+
+    uint32_t enabled_layers_count = 0;
+    const char* enabled_layers[] = { "" };
+
+    //enumerated with the physical devices
+    renderer->vk.device_extension_count = renderer->vk.physical_device_extension_count_all[renderer->vk.physical_device_use_index];
+    renderer->vk.device_extension_all = renderer->vk.physical_device_extension_all[renderer->vk.physical_device_use_index];
+
+    uint32_t enabled_extentions_count = 0;
+    const char* enabled_extentions[CNVX_VULKAN_DEVICE_EXTENSION_COUNT_MAX];
+
+    if (!renderer->settings.headless_is)
+    {
+        enabled_extentions[enabled_extentions_count++] = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+    }
+
+    renderer->vk.pipeline_creation_feedback_is = canvas_vulkan_device_extension_available_is(renderer, VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME);
+    if (renderer->vk.pipeline_creation_feedback_is)
+    {
+        enabled_extentions[enabled_extentions_count++] = VK_EXT_PIPELINE_CREATION_FEEDBACK_EXTENSION_NAME;
+    }
+    else
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline creation feedback is not available, pipeline cache hits can not be counted");
+    }
+
+    renderer->vk.dynamic_rendering_is = false;
+
+    if (renderer->settings.dynamic_rendering_is && canvas_vulkan_device_extension_available_is(renderer, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME))
+    {
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR physical_device_dynamic_rendering_features;
+        physical_device_dynamic_rendering_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+        physical_device_dynamic_rendering_features.pNext = NULL;
+        physical_device_dynamic_rendering_features.dynamicRendering = VK_FALSE;
+
+        VkPhysicalDeviceFeatures2 physical_device_features2;
+        physical_device_features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        physical_device_features2.pNext = &physical_device_dynamic_rendering_features;
+
+        vkGetPhysicalDeviceFeatures2(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], &physical_device_features2);
+
+        renderer->vk.dynamic_rendering_is = VK_TRUE == physical_device_dynamic_rendering_features.dynamicRendering;
+    }
+
+    //the device is at least 1.2, which covers the dependencies of the extension
+    if (renderer->vk.dynamic_rendering_is)
+    {
+        enabled_extentions[enabled_extentions_count++] = VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+    }
+    else if (renderer->settings.dynamic_rendering_is)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: dynamic rendering is not available, falling back to render pass and framebuffers");
+    }
+
+    VkPhysicalDeviceFeatures enabled_physical_device_features = { VK_FALSE };
+
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR enabled_physical_device_dynamic_rendering_features;
+    enabled_physical_device_dynamic_rendering_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    enabled_physical_device_dynamic_rendering_features.pNext = NULL;
+    enabled_physical_device_dynamic_rendering_features.dynamicRendering = VK_TRUE;
+
+    VkPhysicalDeviceVulkan12Features enabled_physical_device_vulkan12_features;
+    memset(&enabled_physical_device_vulkan12_features, 0, sizeof(enabled_physical_device_vulkan12_features));
+    enabled_physical_device_vulkan12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    enabled_physical_device_vulkan12_features.pNext = renderer->vk.dynamic_rendering_is ? &enabled_physical_device_dynamic_rendering_features : NULL;
+    enabled_physical_device_vulkan12_features.timelineSemaphore = renderer->vk.timeline_semaphore_is ? VK_TRUE : VK_FALSE;
+    enabled_physical_device_vulkan12_features.runtimeDescriptorArray = VK_TRUE;
+    enabled_physical_device_vulkan12_features.descriptorBindingPartiallyBound = VK_TRUE;
+    enabled_physical_device_vulkan12_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+    enabled_physical_device_vulkan12_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    enabled_physical_device_vulkan12_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    enabled_physical_device_vulkan12_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+
+    VkDeviceCreateInfo device_create_info;
+    device_create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    device_create_info.pNext = &enabled_physical_device_vulkan12_features;
+    device_create_info.flags = 0;
+    device_create_info.queueCreateInfoCount = device_queue_create_info_count;
+    device_create_info.pQueueCreateInfos = device_queue_create_info_all;
+    device_create_info.enabledLayerCount = enabled_layers_count;
+    device_create_info.ppEnabledLayerNames = enabled_layers;
+    device_create_info.enabledExtensionCount = enabled_extentions_count;
+    device_create_info.ppEnabledExtensionNames = enabled_extentions;
+    device_create_info.pEnabledFeatures = &enabled_physical_device_features;
+
+    VkResult result = vkCreateDevice(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], &device_create_info, NULL, &renderer->vk.device);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDevice");
+
+    vkGetDeviceQueue(renderer->vk.device, renderer->vk.queue_family_use_index, 0, &renderer->vk.queue);
+
+    renderer->vk.cmd_begin_rendering = NULL;
+    renderer->vk.cmd_end_rendering = NULL;
+
+    //extension commands are not exported by the loader
+    if (renderer->vk.dynamic_rendering_is)
+    {
+        renderer->vk.cmd_begin_rendering = (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(renderer->vk.device, "vkCmdBeginRenderingKHR");
+        renderer->vk.cmd_end_rendering = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(renderer->vk.device, "vkCmdEndRenderingKHR");
+
+        SPRX_ASSERT(NULL != renderer->vk.cmd_begin_rendering && NULL != renderer->vk.cmd_end_rendering, CNVX_VULKAN_ERROR_LOGIC("could not continue", "dynamic rendering commands could not be loaded", NULL));
+
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: using dynamic rendering");
+    }
+
+    if (renderer->vk.transfer_dedicated_is)
+    {
+        vkGetDeviceQueue(renderer->vk.device, renderer->vk.queue_family_transfer_index, 0, &renderer->vk.queue_transfer);
+    }
+    else
+    {
+        renderer->vk.queue_transfer = renderer->vk.queue;
+    }
+}
+
+void canvas_vulkan_device_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    vkDestroyDevice(renderer->vk.device, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyDevice");
+
+    free(renderer->vk.queue_family_properties);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: device destruction");
+}
+
+bool canvas_vulkan_device_extension_available_is(void* const renderer_, const char* const name_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != name_, CNVX_VULKAN_ERROR_NULL("name"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.device_extension_count; i++)
+    {
+        if (0 == strcmp(renderer->vk.device_extension_all[i].extensionName, name_))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void canvas_vulkan_pipeline_cache_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache creation");
+
+    renderer->vk.pipeline_cache_mutex = spore_mutex_new();
+
+    renderer->vk.pipeline_cache_stats.hit_count = 0;
+    renderer->vk.pipeline_cache_stats.miss_count = 0;
+    renderer->vk.pipeline_cache_stats.unknown_count = 0;
+    renderer->vk.pipeline_cache_stats.loaded_size = 0;
+    renderer->vk.pipeline_cache_stats.variant_count = 0;
+
+    const VkPhysicalDeviceProperties* const properties = &renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index];
+
+    const void* data = NULL;
+    size_t data_size = 0;
+
+    //read the same way canvas_renderer_shader_load does, the mapping stays open until the driver copied the blob
+    void* file = NULL;
+    size_t file_size = 0;
+    const char* mapped = NULL;
+
+    if (NULL != renderer->settings.pipeline_cache_path)
+    {
+        file = spore_file_new();
+
+        if (SPRX_FILE_RESULT_SUCCESS != spore_file_open(file, renderer->settings.pipeline_cache_path, SPRX_FILE_MODE_READ, SPRX_FILE_FLAG_NONE))
+        {
+            spore_file_delete(file);
+            file = NULL;
+        }
+        else if (SPRX_FILE_RESULT_SUCCESS != spore_file_size_get(file, &file_size) || 0 == file_size || SPRX_FILE_RESULT_SUCCESS != spore_file_mmap(file, &mapped))
+        {
+            file_size = 0;
+            mapped = NULL;
+        }
+    }
+
+    if (NULL != file)
+    {
+        CNVX_Vulkan_Pipeline_Cache_Header_PRIVATE header;
+        memset(&header, 0, sizeof(header));
+
+        if (NULL != mapped && sizeof(header) <= file_size)
+        {
+            memcpy(&header, mapped, sizeof(header));
+        }
+
+        //the blob starts with the header vulkan defines for every cache
+        VkPipelineCacheHeaderVersionOne header_vulkan;
+        memset(&header_vulkan, 0, sizeof(header_vulkan));
+
+        if (sizeof(header) + sizeof(header_vulkan) <= file_size)
+        {
+            memcpy(&header_vulkan, mapped + sizeof(header), sizeof(header_vulkan));
+        }
+
+        if (sizeof(header) > file_size)
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache %s is truncated, discarding", renderer->settings.pipeline_cache_path);
+        }
+        else if (CNVX_VULKAN_PIPELINE_CACHE_MAGIC != header.magic || sizeof(header) != header.header_size)
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache %s has an unknown format, discarding", renderer->settings.pipeline_cache_path);
+        }
+        else if (properties->vendorID != header.vendor_id || properties->deviceID != header.device_id || properties->driverVersion != header.driver_version || 0 != memcmp(properties->pipelineCacheUUID, header.uuid, VK_UUID_SIZE))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache %s was written by another device or driver, discarding", renderer->settings.pipeline_cache_path);
+        }
+        else if (header.data_size != file_size - sizeof(header))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache %s is truncated, discarding", renderer->settings.pipeline_cache_path);
+        }
+        else if (0 != header.data_size && (sizeof(header_vulkan) > header.data_size || sizeof(header_vulkan) > header_vulkan.headerSize || header_vulkan.headerSize > header.data_size || VK_PIPELINE_CACHE_HEADER_VERSION_ONE != header_vulkan.headerVersion))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache %s has an unknown format, discarding", renderer->settings.pipeline_cache_path);
+        }
+        else if (0 != header.data_size)
+        {
+            data = mapped + sizeof(header);
+            data_size = header.data_size;
+        }
+    }
+
+    VkPipelineCacheCreateInfo pipeline_cache_create_info;
+    pipeline_cache_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    pipeline_cache_create_info.pNext = NULL;
+    pipeline_cache_create_info.flags = 0;
+    pipeline_cache_create_info.initialDataSize = data_size;
+    pipeline_cache_create_info.pInitialData = data;
+
+    VkResult result = vkCreatePipelineCache(renderer->vk.device, &pipeline_cache_create_info, NULL, &renderer->vk.pipeline_cache);
+
+    if (VK_SUCCESS != result && 0 != data_size)
+    {
+        //the driver refused the blob, start over with an empty cache
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache data was rejected by the driver, discarding");
+
+        data_size = 0;
+        pipeline_cache_create_info.initialDataSize = 0;
+        pipeline_cache_create_info.pInitialData = NULL;
+
+        result = vkCreatePipelineCache(renderer->vk.device, &pipeline_cache_create_info, NULL, &renderer->vk.pipeline_cache);
+    }
+
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreatePipelineCache");
+
+    if (NULL != file)
+    {
+        spore_file_close(file);
+        spore_file_delete(file);
+    }
+
+    renderer->vk.pipeline_cache_stats.loaded_size = data_size;
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache loaded with %llu bytes", (unsigned long long)data_size);
+}
+
+void canvas_vulkan_pipeline_cache_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (NULL != renderer->settings.pipeline_cache_path)
+    {
+        size_t data_size = 0;
+        VkResult result = vkGetPipelineCacheData(renderer->vk.device, renderer->vk.pipeline_cache, &data_size, NULL);
+        CNVX_VULKAN_ASSERT(renderer, result, "vkGetPipelineCacheData (1/2)");
+
+        void* const data = malloc(SPRX_MAX(data_size, 1));
+        SPRX_ASSERT(NULL != data, CNVX_VULKAN_ERROR_ALLOCATION);
+
+        result = vkGetPipelineCacheData(renderer->vk.device, renderer->vk.pipeline_cache, &data_size, data);
+        CNVX_VULKAN_ASSERT(renderer, result, "vkGetPipelineCacheData (2/2)");
+
+        const VkPhysicalDeviceProperties* const properties = &renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index];
+
+        CNVX_Vulkan_Pipeline_Cache_Header_PRIVATE header;
+        memset(&header, 0, sizeof(header));
+        header.magic = CNVX_VULKAN_PIPELINE_CACHE_MAGIC;
+        header.header_size = sizeof(header);
+        header.vendor_id = properties->vendorID;
+        header.device_id = properties->deviceID;
+        header.driver_version = properties->driverVersion;
+        memcpy(header.uuid, properties->pipelineCacheUUID, VK_UUID_SIZE);
+        header.data_size = data_size;
+
+        //a torn write leaves data_size disagreeing with the file, which the next load discards
+        void* file = spore_file_new();
+
+        if (SPRX_FILE_RESULT_SUCCESS == spore_file_open(file, renderer->settings.pipeline_cache_path, SPRX_FILE_MODE_WRITE, SPRX_FILE_FLAG_NONE))
+        {
+            const bool written_is = SPRX_FILE_RESULT_SUCCESS == spore_file_write(file, &header, sizeof(header)) && (0 == data_size || SPRX_FILE_RESULT_SUCCESS == spore_file_write(file, data, data_size));
+            const bool closed_is = SPRX_FILE_RESULT_SUCCESS == spore_file_close(file);
+
+            if (written_is && closed_is)
+            {
+                CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache stored with %llu bytes", (unsigned long long)data_size);
+            }
+            else
+            {
+                CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: failed to store pipeline cache at %s", renderer->settings.pipeline_cache_path);
+            }
+        }
+        else
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: failed to open %s for writing", renderer->settings.pipeline_cache_path);
+        }
+
+        spore_file_delete(file);
+        free(data);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache hits %llu, misses %llu, unknown %llu", (unsigned long long)renderer->vk.pipeline_cache_stats.hit_count, (unsigned long long)renderer->vk.pipeline_cache_stats.miss_count, (unsigned long long)renderer->vk.pipeline_cache_stats.unknown_count);
+
+    vkDestroyPipelineCache(renderer->vk.device, renderer->vk.pipeline_cache, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyPipelineCache");
+
+    spore_mutex_delete(renderer->vk.pipeline_cache_mutex);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline cache destruction");
+}
+
+void canvas_vulkan_quad_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: quad creation");
+
+    const float corner_all[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+    const uint32_t index_all[CNVX_VULKAN_QUAD_INDEX_COUNT] = { 0, 1, 2, 2, 3, 0 };
+
+    uint32_t queue_family_index_all[2];
+    const uint32_t queue_family_index_count = canvas_vulkan_transfer_queue_family_indices_get(renderer, queue_family_index_all);
+
+    VkBufferCreateInfo buffer_create_info;
+    buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_create_info.pNext = NULL;
+    buffer_create_info.flags = 0;
+    buffer_create_info.size = CNVX_VULKAN_QUAD_INDEX_OFFSET + sizeof(index_all);
+    buffer_create_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer_create_info.sharingMode = 1 < queue_family_index_count ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    buffer_create_info.queueFamilyIndexCount = queue_family_index_count;
+    buffer_create_info.pQueueFamilyIndices = queue_family_index_all;
+
+    VkResult result = vkCreateBuffer(renderer->vk.device, &buffer_create_info, NULL, &renderer->vk.quad_buffer);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateBuffer");
+
+    VkMemoryRequirements memory_requirements;
+    vkGetBufferMemoryRequirements(renderer->vk.device, renderer->vk.quad_buffer, &memory_requirements);
+
+    canvas_vulkan_memory_allocate(renderer, &memory_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, true, &renderer->vk.quad_allocation);
+
+    result = vkBindBufferMemory(renderer->vk.device, renderer->vk.quad_buffer, renderer->vk.quad_allocation.memory, renderer->vk.quad_allocation.offset);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkBindBufferMemory");
+
+    canvas_vulkan_transfer_buffer_upload(renderer, renderer->vk.quad_buffer, 0, corner_all, sizeof(corner_all));
+    canvas_vulkan_transfer_buffer_upload(renderer, renderer->vk.quad_buffer, CNVX_VULKAN_QUAD_INDEX_OFFSET, index_all, sizeof(index_all));
+}
+
+void canvas_vulkan_quad_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    vkDestroyBuffer(renderer->vk.device, renderer->vk.quad_buffer, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyBuffer");
+
+    canvas_vulkan_memory_free(renderer, &renderer->vk.quad_allocation);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: quad destruction");
+}
+
+void canvas_vulkan_surface_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: surface creation");
+
+    VkResult result = glfwCreateWindowSurface(renderer->vk.instance, canvas_window_handle_get(renderer->window), NULL, &renderer->vk.surface);
+    CNVX_VULKAN_ASSERT(renderer, result, "glfwCreateWindowSurface");
+
+    result = vkGetPhysicalDeviceSurfaceSupportKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.queue_family_use_index, renderer->vk.surface, &renderer->vk.surface_support_is);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceSupportKHR");
+
+    if (renderer->vk.surface_support_is)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: surface support is available");
+    }
+    else
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: no surface support is not available");
+    }
+
+    result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &renderer->vk.surface_capabilities);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
+
+    uint32_t surface_formats_count = 0;
+    result = vkGetPhysicalDeviceSurfaceFormatsKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &surface_formats_count, NULL);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceFormatsKHR (1/2)");
+
+    SPRX_ASSERT(0 != surface_formats_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "surface formats count has to be >0", NULL));
+
+    renderer->vk.surface_format_all = malloc(sizeof(*renderer->vk.surface_format_all) * surface_formats_count);
+    SPRX_ASSERT(NULL != renderer->vk.surface_format_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    result = vkGetPhysicalDeviceSurfaceFormatsKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &surface_formats_count, renderer->vk.surface_format_all);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceFormatsKHR (2/2)");
+
+    renderer->vk.format_use = VK_FORMAT_B8G8R8A8_UNORM;
+
+    renderer->vk.surface_present_mode_all_count = 0;
+    result = vkGetPhysicalDeviceSurfacePresentModesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &renderer->vk.surface_present_mode_all_count, NULL);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfacePresentModesKHR (1/2)");
+
+    SPRX_ASSERT(0 != renderer->vk.surface_present_mode_all_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "surface present modes count has to be >0", NULL));
+
+    renderer->vk.surface_present_mode_all = malloc(sizeof(*renderer->vk.surface_present_mode_all) * renderer->vk.surface_present_mode_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.surface_present_mode_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    result = vkGetPhysicalDeviceSurfacePresentModesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &renderer->vk.surface_present_mode_all_count, renderer->vk.surface_present_mode_all);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfacePresentModesKHR (2/2)");
+}
+
+void canvas_vulkan_surface_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    free(renderer->vk.surface_present_mode_all);
+    free(renderer->vk.surface_format_all);
+
+    vkDestroySurfaceKHR(renderer->vk.instance, renderer->vk.surface, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySurfaceKHR");
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: surface destruction");
+}
+
+bool canvas_vulkan_present_mode_supported_is_PRIVATE(void* const renderer_, const VkPresentModeKHR present_mode_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.surface_present_mode_all_count; i++)
+    {
+        if (present_mode_ == renderer->vk.surface_present_mode_all[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+VkPresentModeKHR canvas_vulkan_present_mode_select(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //fallback chains, fifo is required to be supported and ends every chain
+    static const CNVX_Renderer_Present_Mode preference_all[___CNVX_RENDERER_PRESENT_MODE_MAX][3] = {
+        { CNVX_RENDERER_PRESENT_MODE_MAILBOX, CNVX_RENDERER_PRESENT_MODE_IMMEDIATE, CNVX_RENDERER_PRESENT_MODE_FIFO },
+        { CNVX_RENDERER_PRESENT_MODE_FIFO, CNVX_RENDERER_PRESENT_MODE_FIFO, CNVX_RENDERER_PRESENT_MODE_FIFO },
+        { CNVX_RENDERER_PRESENT_MODE_FIFO_RELAXED, CNVX_RENDERER_PRESENT_MODE_FIFO, CNVX_RENDERER_PRESENT_MODE_FIFO },
+        { CNVX_RENDERER_PRESENT_MODE_MAILBOX, CNVX_RENDERER_PRESENT_MODE_FIFO, CNVX_RENDERER_PRESENT_MODE_FIFO },
+        { CNVX_RENDERER_PRESENT_MODE_IMMEDIATE, CNVX_RENDERER_PRESENT_MODE_MAILBOX, CNVX_RENDERER_PRESENT_MODE_FIFO },
+    };
+    static const VkPresentModeKHR vk_present_mode_all[___CNVX_RENDERER_PRESENT_MODE_MAX] = { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+    static const char* const name_all[___CNVX_RENDERER_PRESENT_MODE_MAX] = { "auto", "fifo", "fifo relaxed", "mailbox", "immediate" };
+
+    CNVX_Renderer_Present_Mode present_mode = renderer->settings.present_mode;
+
+    if (CNVX_RENDERER_PRESENT_MODE_AUTO == present_mode && renderer->settings.vsync_is)
+    {
+        present_mode = CNVX_RENDERER_PRESENT_MODE_FIFO;
+    }
+
+    renderer->vk.present_mode_use = CNVX_RENDERER_PRESENT_MODE_FIFO;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        const CNVX_Renderer_Present_Mode candidate = preference_all[present_mode][i];
+
+        if (CNVX_RENDERER_PRESENT_MODE_FIFO == candidate || canvas_vulkan_present_mode_supported_is_PRIVATE(renderer, vk_present_mode_all[candidate]))
+        {
+            renderer->vk.present_mode_use = candidate;
+
+            break;
+        }
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: present mode %s is not supported by the surface", name_all[candidate]);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: present mode %s selected for %s", name_all[renderer->vk.present_mode_use], name_all[renderer->settings.present_mode]);
+
+    return vk_present_mode_all[renderer->vk.present_mode_use];
+}
+
+void canvas_vulkan_swapchain_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: swapchain creation");
+
+    //image count limits may change with the surface, e.g. when moved to another display
+    VkResult result = vkGetPhysicalDeviceSurfaceCapabilitiesKHR(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.surface, &renderer->vk.surface_capabilities);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetPhysicalDeviceSurfaceCapabilitiesKHR");
+
+    //requested images beyond the minimum are the ones the app can render into ahead of the presentation engine
+    uint32_t image_count = 0 != renderer->settings.swapchain_buffer_count ? (uint32_t)renderer->settings.swapchain_buffer_count : CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_DEFAULT;
+    image_count = SPRX_MAX(image_count, renderer->vk.surface_capabilities.minImageCount);
+
+    //=0 means there is no upper limit
+    if (0 != renderer->vk.surface_capabilities.maxImageCount)
+    {
+        image_count = SPRX_MIN(image_count, renderer->vk.surface_capabilities.maxImageCount);
+    }
+
+    //frames in flight may still present from the old swapchain, so its destruction is deferred
+    const VkSwapchainKHR swapchain_old = renderer->vk.swapchain;
+
+    VkSwapchainCreateInfoKHR swapchain_create_info;
+    swapchain_create_info.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
+    swapchain_create_info.pNext = NULL;
+    swapchain_create_info.flags = 0;
+    swapchain_create_info.surface = renderer->vk.surface;
+    swapchain_create_info.minImageCount = image_count;
+    swapchain_create_info.imageFormat = renderer->vk.format_use;
+    swapchain_create_info.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR; //@TODO
+
+    swapchain_create_info.imageExtent.width = renderer->width;
+    swapchain_create_info.imageExtent.height = renderer->height;
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: image extend is %ux%u", renderer->width, renderer->height);
+
+    swapchain_create_info.imageArrayLayers = 1;
+    //transfer source only where the surface allows it, readback is unavailable otherwise
+    swapchain_create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (renderer->vk.surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    renderer->vk.readback_supported_is = 0 != (renderer->vk.surface_capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    swapchain_create_info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE; //@TODO
+    swapchain_create_info.queueFamilyIndexCount = 0; //@TODO
+    swapchain_create_info.pQueueFamilyIndices = NULL; //@TODO
+    swapchain_create_info.preTransform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR;
+    swapchain_create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    swapchain_create_info.presentMode = canvas_vulkan_present_mode_select(renderer);
+    swapchain_create_info.clipped = VK_TRUE;
+    swapchain_create_info.oldSwapchain = swapchain_old;
+
+    result = vkCreateSwapchainKHR(renderer->vk.device, &swapchain_create_info, NULL, &renderer->vk.swapchain);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateSwapchainKHR");
+
+    if (VK_NULL_HANDLE != swapchain_old)
+    {
+        canvas_vulkan_deferred_swapchain_release(renderer, swapchain_old);
+    }
+
+    renderer->vk.swapchain_image_all_count = 0;
+    result = vkGetSwapchainImagesKHR(renderer->vk.device, renderer->vk.swapchain, &renderer->vk.swapchain_image_all_count, NULL);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetSwapchainImagesKHR (1/2)");
+
+    SPRX_ASSERT(0 != renderer->vk.swapchain_image_all_count, CNVX_VULKAN_ERROR_LOGIC("could not continue", "swapchain image count has to be >0", NULL));
+
+    renderer->vk.swapchain_image_all = malloc(sizeof(*renderer->vk.swapchain_image_all) * renderer->vk.swapchain_image_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.swapchain_image_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    result = vkGetSwapchainImagesKHR(renderer->vk.device, renderer->vk.swapchain, &renderer->vk.swapchain_image_all_count, renderer->vk.swapchain_image_all);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkGetSwapchainImagesKHR (2/2)");
+
+    //the implementation is allowed to create more images than requested
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: swapchain has %u images, %u requested within [%u, %u]", renderer->vk.swapchain_image_all_count, image_count, renderer->vk.surface_capabilities.minImageCount, renderer->vk.surface_capabilities.maxImageCount);
+}
+
+void canvas_vulkan_swapchain_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    free(renderer->vk.swapchain_image_all);
+    renderer->vk.swapchain_image_all = NULL;
+    renderer->vk.swapchain_image_all_count = 0;
+
+    //a retired swapchain is kept as handle until replaced, e.g. while minimized
+    if (VK_NULL_HANDLE != renderer->vk.swapchain)
+    {
+        vkDestroySwapchainKHR(renderer->vk.device, renderer->vk.swapchain, NULL);
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySwapchainKHR");
+
+        renderer->vk.swapchain = VK_NULL_HANDLE;
+    }
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: swapchain destruction");
+}
+
+void canvas_vulkan_swapchain_retire(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //frames in flight may still render into or present these
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        canvas_vulkan_deferred_semaphore_release(renderer, renderer->vk.semaphore_rendering_done_all[i]);
+
+        if (NULL != renderer->vk.framebuffer_all)
+        {
+            canvas_vulkan_deferred_framebuffer_release(renderer, renderer->vk.framebuffer_all[i]);
+        }
+
+        canvas_vulkan_deferred_image_view_release(renderer, renderer->vk.image_view_all[i]);
+    }
+
+    free(renderer->vk.semaphore_rendering_done_all);
+    free(renderer->vk.framebuffer_all);
+    free(renderer->vk.image_view_all);
+    free(renderer->vk.swapchain_image_all);
+
+    renderer->vk.swapchain_image_all_count = 0;
+    renderer->vk.swapchain_image_all = NULL;
+    renderer->vk.image_view_all = NULL;
+    renderer->vk.framebuffer_all = NULL;
+    renderer->vk.semaphore_rendering_done_all = NULL;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: swapchain retirement");
+}
+
+void canvas_vulkan_headless_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: headless creation");
+
+    renderer->vk.format_use = 0 != renderer->settings.headless_format ? (VkFormat)renderer->settings.headless_format : VK_FORMAT_B8G8R8A8_UNORM;
+
+    VkFormatProperties format_properties;
+    vkGetPhysicalDeviceFormatProperties(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], renderer->vk.format_use, &format_properties);
+
+    SPRX_ASSERT(VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BIT & format_properties.optimalTilingFeatures, CNVX_VULKAN_ERROR_ARGUMENT("settings.headless_format has to be usable as color attachment"));
+
+    renderer->vk.readback_supported_is = true;
+
+    //one image per frame, the frame fence then guards its reuse just like the command buffers
+    renderer->vk.swapchain_image_all_count = renderer->vk.frame_count;
+
+    renderer->vk.swapchain_image_all = malloc(sizeof(*renderer->vk.swapchain_image_all) * renderer->vk.swapchain_image_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.swapchain_image_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    renderer->vk.headless_allocation_all = malloc(sizeof(*renderer->vk.headless_allocation_all) * renderer->vk.swapchain_image_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.headless_allocation_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    VkImageCreateInfo image_create_info;
+    image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_create_info.pNext = NULL;
+    image_create_info.flags = 0;
+    image_create_info.imageType = VK_IMAGE_TYPE_2D;
+    image_create_info.format = renderer->vk.format_use;
+    image_create_info.extent.width = (uint32_t)renderer->width;
+    image_create_info.extent.height = (uint32_t)renderer->height;
+    image_create_info.extent.depth = 1;
+    image_create_info.mipLevels = 1;
+    image_create_info.arrayLayers = 1;
+    image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_create_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    image_create_info.queueFamilyIndexCount = 0;
+    image_create_info.pQueueFamilyIndices = NULL;
+    image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        VkResult result = vkCreateImage(renderer->vk.device, &image_create_info, NULL, &renderer->vk.swapchain_image_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateImage headless (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+
+        VkMemoryRequirements memory_requirements;
+        vkGetImageMemoryRequirements(renderer->vk.device, renderer->vk.swapchain_image_all[i], &memory_requirements);
+
+        canvas_vulkan_memory_allocate(renderer, &memory_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, false, &renderer->vk.headless_allocation_all[i]);
+
+        result = vkBindImageMemory(renderer->vk.device, renderer->vk.swapchain_image_all[i], renderer->vk.headless_allocation_all[i].memory, renderer->vk.headless_allocation_all[i].offset);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkBindImageMemory headless (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: headless with %u images of %ux%u in format %d", renderer->vk.swapchain_image_all_count, (unsigned)renderer->width, (unsigned)renderer->height, (int)renderer->vk.format_use);
+}
+
+void canvas_vulkan_headless_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        vkDestroyImage(renderer->vk.device, renderer->vk.swapchain_image_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyImage headless (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+
+        canvas_vulkan_memory_free(renderer, &renderer->vk.headless_allocation_all[i]);
+    }
+
+    free(renderer->vk.headless_allocation_all);
+    free(renderer->vk.swapchain_image_all);
+
+    renderer->vk.headless_allocation_all = NULL;
+    renderer->vk.swapchain_image_all = NULL;
+    renderer->vk.swapchain_image_all_count = 0;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: headless destruction");
+}
+
+void canvas_vulkan_imageviews_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: imageviews creation");
+
+    VkImageViewCreateInfo image_view_create_info;
+    image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    image_view_create_info.pNext = NULL;
+    image_view_create_info.flags = 0;
+    image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    image_view_create_info.format = renderer->vk.format_use;
+    image_view_create_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_view_create_info.subresourceRange.baseMipLevel = 0;
+    image_view_create_info.subresourceRange.levelCount = 1;
+    image_view_create_info.subresourceRange.baseArrayLayer = 0;
+    image_view_create_info.subresourceRange.layerCount = 1;
+
+    renderer->vk.image_view_all = malloc(sizeof(*renderer->vk.image_view_all) * renderer->vk.swapchain_image_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.image_view_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        image_view_create_info.image = renderer->vk.swapchain_image_all[i];
+
+        VkResult result = vkCreateImageView(renderer->vk.device, &image_view_create_info, NULL, &renderer->vk.image_view_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkGetSwapchainImagesKHR (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+    }
+}
+
+void canvas_vulkan_imageviews_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        vkDestroyImageView(renderer->vk.device, renderer->vk.image_view_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkGetSwapchainImagesKHR (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+    }
+
+    free(renderer->vk.image_view_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: imageviews destruction");
+}
+
+void canvas_vulkan_shader_module_create_PRIVATE(void* const renderer_, const size_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.shader_module_count > index_, CNVX_VULKAN_ERROR_ARGUMENT("index has to be <shader module count"));
+
+    VkShaderModuleCreateInfo shader_module_create_info;
+    shader_module_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    shader_module_create_info.pNext = NULL;
+    shader_module_create_info.flags = 0;
+    shader_module_create_info.codeSize = SPRX_VECTOR_AT(renderer->shader_vec, index_, CNVX_Renderer_Shader_PRIVATE)->size;
+    shader_module_create_info.pCode = (const uint32_t*)SPRX_VECTOR_AT(renderer->shader_vec, index_, CNVX_Renderer_Shader_PRIVATE)->data;
+
+    VkResult result = vkCreateShaderModule(renderer->vk.device, &shader_module_create_info, NULL, &renderer->vk.shader_module_all[index_]);
+    CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateShaderModule (%u/%u)", index_ + 1, renderer->vk.shader_module_count);
+}
+
+void canvas_vulkan_shader_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: shader creation");
+
+    renderer->vk.shader_module_count = SPRX_MIN(spore_vector_size(renderer->shader_vec), UINT32_MAX);
+
+    size_t geometry_shader_count = 0;
+
+    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        if (CNVX_RENDERER_PIPELINE_GEOMETRY == canvas_vulkan_shader_pipeline_get(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->type))
+        {
+            geometry_shader_count++;
+        }
+    }
+
+    if (geometry_shader_count < 2)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: required shader missing");
+    }
+
+    renderer->vk.shader_module_all = malloc(sizeof(*renderer->vk.shader_module_all) * SPRX_MAX(renderer->vk.shader_module_count, 1));
+    SPRX_ASSERT(renderer->vk.shader_module_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    renderer->vk.shader_job_all = malloc(sizeof(*renderer->vk.shader_job_all) * SPRX_MAX(renderer->vk.shader_module_count, 1));
+    SPRX_ASSERT(renderer->vk.shader_job_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    //every module is built on the worker, canvas_vulkan_shader_wait joins them
+    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        canvas_worker_submit(renderer->worker, &renderer->vk.shader_job_all[i], canvas_vulkan_shader_module_create_PRIVATE, renderer, i);
+    }
+}
+
+void canvas_vulkan_shader_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_shader_wait(renderer);
+
+    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        vkDestroyShaderModule(renderer->vk.device, renderer->vk.shader_module_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkDestroyShaderModule (%u/%u)", i + 1, renderer->vk.shader_module_count);
+    }
+
+    free(renderer->vk.shader_job_all);
+    free(renderer->vk.shader_module_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: shader destruction");
+}
+
+void canvas_vulkan_shader_wait(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        canvas_worker_wait(renderer->worker, &renderer->vk.shader_job_all[i]);
+    }
+}
+
+VkResult canvas_vulkan_pipeline_variant_build(void* const renderer_, const CNVX_Vulkan_Pipeline_Key_PRIVATE* const key_, const VkShaderModule* const shader_module_all_, VkPipeline* const pipeline_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != key_, CNVX_VULKAN_ERROR_NULL("key"));
+    SPRX_ASSERT(NULL != shader_module_all_, CNVX_VULKAN_ERROR_NULL("shader_module_all"));
+    SPRX_ASSERT(NULL != pipeline_, CNVX_VULKAN_ERROR_NULL("pipeline"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    VkPipelineShaderStageCreateInfo* const pipeline_shader_stage_create_info_all = malloc(sizeof(*pipeline_shader_stage_create_info_all) * SPRX_MAX(renderer->vk.shader_module_count, 1));
+    SPRX_ASSERT(NULL != pipeline_shader_stage_create_info_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    uint32_t stage_count = 0;
+
+    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        if (key_->shader_set != canvas_vulkan_shader_pipeline_get(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->type))
+        {
+            continue;
+        }
+
+        VkPipelineShaderStageCreateInfo pipeline_shader_stage_create_info;
+        pipeline_shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        pipeline_shader_stage_create_info.pNext = NULL;
+        pipeline_shader_stage_create_info.flags = 0;
+        pipeline_shader_stage_create_info.stage = canvas_vulkan_shader_stage_flag_bit_get_PRIVATE(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->type);
+        pipeline_shader_stage_create_info.module = shader_module_all_[i];
+        pipeline_shader_stage_create_info.pName = "main";
+        pipeline_shader_stage_create_info.pSpecializationInfo = NULL;
+
+        pipeline_shader_stage_create_info_all[stage_count++] = pipeline_shader_stage_create_info;
+    }
+
+    if (0 == stage_count)
+    {
+        //optional pipelines without shaders are skipped, their draws are dropped while recording
+        *pipeline_ = VK_NULL_HANDLE;
+
+        free(pipeline_shader_stage_create_info_all);
+        return VK_SUCCESS;
+    }
 
-    VkImageViewCreateInfo image_view_create_info;
-    image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-    image_view_create_info.pNext = NULL;
-    image_view_create_info.flags = 0;
-    image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-    image_view_create_info.format = renderer->vk.format_use;
-    image_view_create_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-    image_view_create_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-    image_view_create_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-    image_view_create_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
-    image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    image_view_create_info.subresourceRange.baseMipLevel = 0;
-    image_view_create_info.subresourceRange.levelCount = 1;
-    image_view_create_info.subresourceRange.baseArrayLayer = 0;
-    image_view_create_info.subresourceRange.layerCount = 1;
+    uint32_t vertex_input_binding_description_count = 0;
+    VkVertexInputBindingDescription vertex_input_binding_description_all[2];
+
+    uint32_t vertex_input_attribute_description_count = 0;
+    VkVertexInputAttributeDescription vertex_input_attribute_description_all[7];
+
+    if (CNVX_RENDERER_PIPELINE_QUAD == key_->shader_set)
+    {
+        //binding 0 holds the unit quad corners, binding 1 one CNVX_Renderer_Quad per instance
+        vertex_input_binding_description_all[vertex_input_binding_description_count++] = (VkVertexInputBindingDescription){ 0, 2 * sizeof(float), VK_VERTEX_INPUT_RATE_VERTEX };
+        vertex_input_binding_description_all[vertex_input_binding_description_count++] = (VkVertexInputBindingDescription){ 1, sizeof(CNVX_Renderer_Quad), VK_VERTEX_INPUT_RATE_INSTANCE };
+
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 0, 0, VK_FORMAT_R32G32_SFLOAT, 0 };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 1, 1, VK_FORMAT_R32G32_SFLOAT, offsetof(CNVX_Renderer_Quad, transform) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 2, 1, VK_FORMAT_R32G32_SFLOAT, offsetof(CNVX_Renderer_Quad, transform) + 2 * sizeof(float) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 3, 1, VK_FORMAT_R32G32_SFLOAT, offsetof(CNVX_Renderer_Quad, transform) + 4 * sizeof(float) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 4, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(CNVX_Renderer_Quad, uv) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 5, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(CNVX_Renderer_Quad, color) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 6, 1, VK_FORMAT_R32_UINT, offsetof(CNVX_Renderer_Quad, texture_index) };
+    }
+    else
+    {
+        vertex_input_binding_description_all[vertex_input_binding_description_count++] = (VkVertexInputBindingDescription){ 0, sizeof(CNVX_Renderer_Vertex), VK_VERTEX_INPUT_RATE_VERTEX };
+
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 0, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(CNVX_Renderer_Vertex, position) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(CNVX_Renderer_Vertex, uv) };
+        vertex_input_attribute_description_all[vertex_input_attribute_description_count++] = (VkVertexInputAttributeDescription){ 2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(CNVX_Renderer_Vertex, color) };
+    }
+
+    VkPipelineVertexInputStateCreateInfo pipeline_vertex_input_state_create_info;
+    pipeline_vertex_input_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    pipeline_vertex_input_state_create_info.pNext = NULL;
+    pipeline_vertex_input_state_create_info.flags = 0;
+    pipeline_vertex_input_state_create_info.vertexBindingDescriptionCount = vertex_input_binding_description_count;
+    pipeline_vertex_input_state_create_info.pVertexBindingDescriptions = vertex_input_binding_description_all;
+    pipeline_vertex_input_state_create_info.vertexAttributeDescriptionCount = vertex_input_attribute_description_count;
+    pipeline_vertex_input_state_create_info.pVertexAttributeDescriptions = vertex_input_attribute_description_all;
+
+    VkPipelineInputAssemblyStateCreateInfo pipelien_input_assembly_state_create_info;
+    pipelien_input_assembly_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    pipelien_input_assembly_state_create_info.pNext = NULL;
+    pipelien_input_assembly_state_create_info.flags = 0;
+    pipelien_input_assembly_state_create_info.topology = canvas_vulkan_topology_get_PRIVATE((CNVX_Renderer_Topology)key_->topology);
+    pipelien_input_assembly_state_create_info.primitiveRestartEnable = VK_FALSE;
+
+    VkViewport viewport;
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = renderer->width;
+    viewport.height = renderer->height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    VkRect2D scissor;
+    scissor.offset.x = 0;
+    scissor.offset.y = 0;
+    scissor.extent.width = renderer->width;
+    scissor.extent.height = renderer->height;
+
+    VkPipelineViewportStateCreateInfo pipeline_viewport_state_create_info;
+    pipeline_viewport_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    pipeline_viewport_state_create_info.pNext = NULL;
+    pipeline_viewport_state_create_info.flags = 0;
+    pipeline_viewport_state_create_info.viewportCount = 1;
+    pipeline_viewport_state_create_info.pViewports = &viewport;
+    pipeline_viewport_state_create_info.scissorCount = 1;
+    pipeline_viewport_state_create_info.pScissors = &scissor;
+
+    VkPipelineRasterizationStateCreateInfo pipeline_rasterisation_state_create_info;
+    pipeline_rasterisation_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    pipeline_rasterisation_state_create_info.pNext = NULL;
+    pipeline_rasterisation_state_create_info.flags = 0;
+    pipeline_rasterisation_state_create_info.depthClampEnable = VK_FALSE;
+    pipeline_rasterisation_state_create_info.rasterizerDiscardEnable = VK_FALSE;
+    pipeline_rasterisation_state_create_info.polygonMode = VK_POLYGON_MODE_FILL;
+    pipeline_rasterisation_state_create_info.cullMode = canvas_vulkan_cull_mode_get_PRIVATE((CNVX_Renderer_Cull)key_->cull);
+    pipeline_rasterisation_state_create_info.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    pipeline_rasterisation_state_create_info.depthBiasEnable = VK_FALSE;
+    pipeline_rasterisation_state_create_info.depthBiasConstantFactor = 0.0f;
+    pipeline_rasterisation_state_create_info.depthBiasClamp = 0.0f;
+    pipeline_rasterisation_state_create_info.depthBiasSlopeFactor = 0.0f;
+    pipeline_rasterisation_state_create_info.lineWidth = 1.0f;
+
+    VkPipelineMultisampleStateCreateInfo pipeline_multisample_state_create_info;
+    pipeline_multisample_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    pipeline_multisample_state_create_info.pNext = NULL;
+    pipeline_multisample_state_create_info.flags = 0;
+    pipeline_multisample_state_create_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    pipeline_multisample_state_create_info.sampleShadingEnable = VK_FALSE;
+    pipeline_multisample_state_create_info.minSampleShading = 1.0f;
+    pipeline_multisample_state_create_info.pSampleMask = NULL;
+    pipeline_multisample_state_create_info.alphaToCoverageEnable = VK_FALSE;
+    pipeline_multisample_state_create_info.alphaToOneEnable = VK_FALSE;
+
+    const VkPipelineColorBlendAttachmentState pipeline_color_blend_attachment_state = canvas_vulkan_blend_attachment_get_PRIVATE((CNVX_Renderer_Blend)key_->blend);
+
+    VkPipelineColorBlendStateCreateInfo pipeline_color_blend_state_create_info;
+    pipeline_color_blend_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    pipeline_color_blend_state_create_info.pNext = NULL;
+    pipeline_color_blend_state_create_info.flags = 0;
+    pipeline_color_blend_state_create_info.logicOpEnable = VK_FALSE;
+    pipeline_color_blend_state_create_info.logicOp = VK_LOGIC_OP_NO_OP;
+    pipeline_color_blend_state_create_info.attachmentCount = 1;
+    pipeline_color_blend_state_create_info.pAttachments = &pipeline_color_blend_attachment_state;
+    pipeline_color_blend_state_create_info.blendConstants[0] = 0.0f;
+    pipeline_color_blend_state_create_info.blendConstants[1] = 0.0f;
+    pipeline_color_blend_state_create_info.blendConstants[2] = 0.0f;
+    pipeline_color_blend_state_create_info.blendConstants[3] = 0.0f;
+
+    VkDynamicState dynamic_state_all[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+
+    VkPipelineDynamicStateCreateInfo pipeline_dynamic_state_create_info;
+    pipeline_dynamic_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    pipeline_dynamic_state_create_info.pNext = NULL;
+    pipeline_dynamic_state_create_info.flags = 0;
+    pipeline_dynamic_state_create_info.dynamicStateCount = 2;
+    pipeline_dynamic_state_create_info.pDynamicStates = dynamic_state_all;
+
+    VkGraphicsPipelineCreateInfo graphics_pipeline_create_info;
+    graphics_pipeline_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    graphics_pipeline_create_info.pNext = NULL;
+    graphics_pipeline_create_info.flags = 0;
+    graphics_pipeline_create_info.stageCount = stage_count;
+    graphics_pipeline_create_info.pStages = pipeline_shader_stage_create_info_all;
+    graphics_pipeline_create_info.pVertexInputState = &pipeline_vertex_input_state_create_info;
+    graphics_pipeline_create_info.pInputAssemblyState = &pipelien_input_assembly_state_create_info;
+    graphics_pipeline_create_info.pTessellationState = NULL;
+    graphics_pipeline_create_info.pViewportState = &pipeline_viewport_state_create_info;
+    graphics_pipeline_create_info.pRasterizationState = &pipeline_rasterisation_state_create_info;
+    graphics_pipeline_create_info.pMultisampleState = &pipeline_multisample_state_create_info;
+    graphics_pipeline_create_info.pDepthStencilState = NULL;
+    graphics_pipeline_create_info.pColorBlendState = &pipeline_color_blend_state_create_info;
+    graphics_pipeline_create_info.pDynamicState = &pipeline_dynamic_state_create_info;
+    graphics_pipeline_create_info.layout = renderer->vk.pipeline_layout;
+    graphics_pipeline_create_info.renderPass = renderer->vk.renderer_pass;
+    graphics_pipeline_create_info.subpass = 0;
+    graphics_pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
+    graphics_pipeline_create_info.basePipelineIndex = -1;
+
+    VkPipelineCreationFeedbackEXT pipeline_creation_feedback;
+    pipeline_creation_feedback.flags = 0;
+    pipeline_creation_feedback.duration = 0;
+
+    VkPipelineCreationFeedbackCreateInfoEXT pipeline_creation_feedback_create_info;
+    pipeline_creation_feedback_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATION_FEEDBACK_CREATE_INFO_EXT;
+    pipeline_creation_feedback_create_info.pNext = NULL;
+    pipeline_creation_feedback_create_info.pPipelineCreationFeedback = &pipeline_creation_feedback;
+    pipeline_creation_feedback_create_info.pipelineStageCreationFeedbackCount = 0;
+    pipeline_creation_feedback_create_info.pPipelineStageCreationFeedbacks = NULL;
+
+    if (renderer->vk.pipeline_creation_feedback_is)
+    {
+        graphics_pipeline_create_info.pNext = &pipeline_creation_feedback_create_info;
+    }
+
+    //without render pass the pipeline only knows the formats, so it fits any extent
+    VkPipelineRenderingCreateInfoKHR pipeline_rendering_create_info;
+    pipeline_rendering_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    pipeline_rendering_create_info.pNext = graphics_pipeline_create_info.pNext;
+    pipeline_rendering_create_info.viewMask = 0;
+    pipeline_rendering_create_info.colorAttachmentCount = 1;
+    pipeline_rendering_create_info.pColorAttachmentFormats = (const VkFormat*)&key_->color_format;
+    pipeline_rendering_create_info.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    pipeline_rendering_create_info.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+    if (renderer->vk.dynamic_rendering_is)
+    {
+        graphics_pipeline_create_info.pNext = &pipeline_rendering_create_info;
+    }
+
+    *pipeline_ = VK_NULL_HANDLE;
+
+    const VkResult result = vkCreateGraphicsPipelines(renderer->vk.device, renderer->vk.pipeline_cache, 1, &graphics_pipeline_create_info, NULL, pipeline_);
+
+    if (VK_SUCCESS == result)
+    {
+        canvas_vulkan_pipeline_cache_feedback_PRIVATE(renderer, &pipeline_creation_feedback);
+    }
+
+    free(pipeline_shader_stage_create_info_all);
+
+    return result;
+}
+
+void canvas_vulkan_pipeline_build_PRIVATE(void* const renderer_, const size_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.pipeline_variant_count > index_, CNVX_VULKAN_ERROR_ARGUMENT("index has to be <pipeline variant count"));
+
+    CNVX_Vulkan_Pipeline_Variant_PRIVATE* const pipeline_variant = &renderer->vk.pipeline_variant_all[index_];
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline_%llu build", index_);
+
+    canvas_vulkan_shader_wait(renderer);
+
+    VkResult result = canvas_vulkan_pipeline_variant_build(renderer, &pipeline_variant->key, renderer->vk.shader_module_all, &pipeline_variant->pipeline);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateGraphicsPipelines");
+
+    if (VK_NULL_HANDLE == pipeline_variant->pipeline)
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline_%llu has no shaders and is not built", index_);
+        return;
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline_%llu built", index_);
+}
+
+uint32_t canvas_vulkan_pipeline_variant_request_PRIVATE(void* const renderer_, const CNVX_Renderer_Pipeline_PRIVATE shader_set_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Vulkan_Pipeline_Key_PRIVATE key;
+    key.shader_set = shader_set_;
+    key.blend = renderer->vk.pipeline_draw_state.blend;
+    key.topology = CNVX_RENDERER_PIPELINE_QUAD == shader_set_ ? CNVX_RENDERER_TOPOLOGY_TRIANGLE_LIST : renderer->vk.pipeline_draw_state.topology;
+    key.cull = renderer->vk.pipeline_draw_state.cull;
+    key.color_format = renderer->vk.format_use;
+
+    return canvas_vulkan_pipeline_variant_get(renderer, &key, canvas_vulkan_pipeline_build_PRIVATE);
+}
+
+void canvas_vulkan_pipeline_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline creation");
+
+    VkPipelineLayoutCreateInfo pipeline_layout_create_info;
+    pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_create_info.pNext = NULL;
+    pipeline_layout_create_info.flags = 0;
+    //every pipeline shares this layout, so the bindless set, the uniform set and push constants survive pipeline switches
+    const VkDescriptorSetLayout descriptor_set_layout_all[] = { renderer->vk.descriptor_set_layout, renderer->vk.uniform_set_layout };
+
+    VkPushConstantRange push_constant_range;
+    push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    push_constant_range.offset = 0;
+    push_constant_range.size = sizeof(CNVX_Vulkan_Push_Constant_PRIVATE);
+
+    pipeline_layout_create_info.setLayoutCount = sizeof(descriptor_set_layout_all) / sizeof(*descriptor_set_layout_all);
+    pipeline_layout_create_info.pSetLayouts = descriptor_set_layout_all;
+    pipeline_layout_create_info.pushConstantRangeCount = 1;
+    pipeline_layout_create_info.pPushConstantRanges = &push_constant_range;
+
+    VkResult result = vkCreatePipelineLayout(renderer->vk.device, &pipeline_layout_create_info, NULL, &renderer->vk.pipeline_layout);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreatePipelineLayout");
+
+    VkAttachmentDescription attachment_description;
+    attachment_description.flags = 0;
+    attachment_description.format = renderer->vk.format_use;
+    attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
+    attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    //the frame graph transitions the image around the pass, so the pass itself never changes its layout
+    attachment_description.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    attachment_description.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference attachment_refference;
+    attachment_refference.attachment = 0;
+    attachment_refference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass_description;
+    subpass_description.flags = 0;
+    subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass_description.inputAttachmentCount = 0;
+    subpass_description.pInputAttachments = NULL;
+    subpass_description.colorAttachmentCount = 1;
+    subpass_description.pColorAttachments = &attachment_refference;
+    subpass_description.pResolveAttachments = NULL;
+    subpass_description.pDepthStencilAttachment = NULL;
+    subpass_description.preserveAttachmentCount = 0;
+    subpass_description.pPreserveAttachments = NULL;
+
+    VkRenderPassCreateInfo render_pass_create_info;
+    render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_create_info.pNext = NULL;
+    render_pass_create_info.flags = 0;
+    render_pass_create_info.attachmentCount = 1;
+    render_pass_create_info.pAttachments = &attachment_description;
+    render_pass_create_info.subpassCount = 1;
+    render_pass_create_info.pSubpasses = &subpass_description;
+    render_pass_create_info.dependencyCount = 0;
+    render_pass_create_info.pDependencies = NULL;
+
+    renderer->vk.renderer_pass = VK_NULL_HANDLE;
+
+    if (!renderer->vk.dynamic_rendering_is)
+    {
+        result = vkCreateRenderPass(renderer->vk.device, &render_pass_create_info, NULL, &renderer->vk.renderer_pass);
+        CNVX_VULKAN_ASSERT(renderer, result, "vkCreateRenderPass");
+    }
+
+    canvas_vulkan_pipeline_variant_create(renderer);
+
+    //the variants the next draws most likely use are compiled on the worker right away, the first canvas_vulkan_pipeline_wait joins them
+    for (size_t i = 0; i < ___CNVX_RENDERER_PIPELINE_MAX; i++)
+    {
+        canvas_vulkan_pipeline_variant_request_PRIVATE(renderer, (CNVX_Renderer_Pipeline_PRIVATE)i);
+    }
+}
+
+void canvas_vulkan_pipeline_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline destruction");
+
+    canvas_vulkan_pipeline_variant_destroy(renderer);
+
+    vkDestroyRenderPass(renderer->vk.device, renderer->vk.renderer_pass, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyRenderPass");
+
+    vkDestroyPipelineLayout(renderer->vk.device, renderer->vk.pipeline_layout, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyPipelineLayout");
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline destruction");
+}
+
+void canvas_vulkan_pipeline_wait(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_pipeline_variant_wait(renderer);
+}
+
+void canvas_vulkan_framebuffer_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
-    renderer->vk.image_view_all = malloc(sizeof(*renderer->vk.image_view_all) * renderer->vk.swapchain_image_all_count);
-    SPRX_ASSERT(NULL != renderer->vk.image_view_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: framebuffer creation");
+
+    //dynamic rendering begins on the image views directly, so resizes have nothing to rebuild here
+    if (renderer->vk.dynamic_rendering_is)
+    {
+        renderer->vk.framebuffer_all = NULL;
+        return;
+    }
+
+    renderer->vk.framebuffer_all = malloc(sizeof(*renderer->vk.framebuffer_all) * renderer->vk.swapchain_image_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.framebuffer_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    VkFramebufferCreateInfo frame_buffer_create_info;
+    frame_buffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    frame_buffer_create_info.pNext = NULL;
+    frame_buffer_create_info.flags = 0;
+    frame_buffer_create_info.renderPass = renderer->vk.renderer_pass;
+    frame_buffer_create_info.attachmentCount = 1;
+    frame_buffer_create_info.width = renderer->width;
+    frame_buffer_create_info.height = renderer->height;
+    frame_buffer_create_info.layers = 1;
 
     for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
     {
-        image_view_create_info.image = renderer->vk.swapchain_image_all[i];
+        frame_buffer_create_info.pAttachments = &renderer->vk.image_view_all[i];
 
-        VkResult result = vkCreateImageView(renderer->vk.device, &image_view_create_info, NULL, &renderer->vk.image_view_all[i]);
-        CNVX_VULKAN_ASSERTF(renderer, result, "vkGetSwapchainImagesKHR (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+        VkResult result = vkCreateFramebuffer(renderer->vk.device, &frame_buffer_create_info, NULL, &renderer->vk.framebuffer_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateFramebuffer (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
     }
 }
 
-void canvas_vulkan_imageviews_destroy(void* const renderer_)
+void canvas_vulkan_framebuffer_destroy(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count && NULL != renderer->vk.framebuffer_all; i++)
     {
-        vkDestroyImageView(renderer->vk.device, renderer->vk.image_view_all[i], NULL);
-        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkGetSwapchainImagesKHR (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+        vkDestroyFramebuffer(renderer->vk.device, renderer->vk.framebuffer_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkDestroyFramebuffer (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
     }
 
-    free(renderer->vk.image_view_all);
+    free(renderer->vk.framebuffer_all);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: imageviews destruction");
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: framebuffer destruction");
 }
 
-void canvas_vulkan_shader_create(void* const renderer_)
+void canvas_vulkan_commandpool_create(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: shader creation");
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandpool creation");
 
-    renderer->vk.shader_module_count = SPRX_MIN(spore_vector_capacity(renderer->shader_vec), UINT32_MAX);
+    renderer->vk.commandpool_all = malloc(sizeof(*renderer->vk.commandpool_all) * renderer->vk.frame_count);
+    SPRX_ASSERT(NULL != renderer->vk.commandpool_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    VkCommandPoolCreateInfo command_pool_create_info;
+    command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_create_info.pNext = NULL;
+    command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    command_pool_create_info.queueFamilyIndex = renderer->vk.queue_family_use_index;
 
-    if (renderer->vk.shader_module_count < 2)
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
     {
-        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: required shader missing");
+        VkResult result = vkCreateCommandPool(renderer->vk.device, &command_pool_create_info, NULL, &renderer->vk.commandpool_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateCommandPool (%u/%u)", i + 1, renderer->vk.frame_count);
     }
 
-    renderer->vk.shader_module_all = malloc(sizeof(*renderer->vk.shader_module_all) * renderer->vk.shader_module_count);
-    SPRX_ASSERT(renderer->vk.shader_module_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    //command pools are externally synchronized, so every draw list gets its own
+    renderer->vk.record_list_count = (uint32_t)canvas_worker_thread_count_get(renderer->worker);
 
-    VkShaderModuleCreateInfo shader_module_create_info;
-    shader_module_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    shader_module_create_info.pNext = NULL;
-    shader_module_create_info.flags = 0;
+    const uint32_t record_commandpool_count = renderer->vk.frame_count * renderer->vk.record_list_count;
 
-    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
-    {
-        shader_module_create_info.codeSize = SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->size;
-        shader_module_create_info.pCode = (const uint32_t*)SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->data;
+    renderer->vk.record_commandpool_all = malloc(sizeof(*renderer->vk.record_commandpool_all) * record_commandpool_count);
+    SPRX_ASSERT(NULL != renderer->vk.record_commandpool_all, CNVX_VULKAN_ERROR_ALLOCATION);
 
-        VkResult result = vkCreateShaderModule(renderer->vk.device, &shader_module_create_info, NULL, &renderer->vk.shader_module_all[i]);
-        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateShaderModule (%u/%u)", i + 1, renderer->vk.shader_module_count);
+    for (uint32_t i = 0; i < record_commandpool_count; i++)
+    {
+        VkResult result = vkCreateCommandPool(renderer->vk.device, &command_pool_create_info, NULL, &renderer->vk.record_commandpool_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateCommandPool record (%u/%u)", i + 1, record_commandpool_count);
     }
 }
 
-void canvas_vulkan_shader_destroy(void* const renderer_)
+void canvas_vulkan_commandpool_destroy(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
     {
-        vkDestroyShaderModule(renderer->vk.device, renderer->vk.shader_module_all[i], NULL);
-        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkDestroyShaderModule (%u/%u)", i + 1, renderer->vk.shader_module_count);
+        vkDestroyCommandPool(renderer->vk.device, renderer->vk.commandpool_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyCommandPool (%u/%u)", i + 1, renderer->vk.frame_count);
     }
 
-    free(renderer->vk.shader_module_all);
+    free(renderer->vk.commandpool_all);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: shader destruction");
+    const uint32_t record_commandpool_count = renderer->vk.frame_count * renderer->vk.record_list_count;
+
+    for (uint32_t i = 0; i < record_commandpool_count; i++)
+    {
+        vkDestroyCommandPool(renderer->vk.device, renderer->vk.record_commandpool_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyCommandPool record (%u/%u)", i + 1, record_commandpool_count);
+    }
+
+    free(renderer->vk.record_commandpool_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commadpool destruction");
 }
 
-void canvas_vulkan_pipeline_create(void* const renderer_)
+void canvas_vulkan_commandbuffer_create(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline creation");
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandbuffer creation");
 
-    VkPipelineShaderStageCreateInfo* const pipeline_shader_stage_create_info_all = malloc(sizeof(*pipeline_shader_stage_create_info_all) * renderer->vk.shader_module_count);
-    SPRX_ASSERT(NULL != pipeline_shader_stage_create_info_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    renderer->vk.commandbuffer_all = malloc(sizeof(*renderer->vk.commandbuffer_all) * renderer->vk.frame_count);
+    SPRX_ASSERT(NULL != renderer->vk.commandbuffer_all, CNVX_VULKAN_ERROR_ALLOCATION);
 
-    for (size_t i = 0; i < renderer->vk.shader_module_count; i++)
+    //allocated once, resetting the pool keeps them allocated for reuse
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
     {
-        VkPipelineShaderStageCreateInfo pipeline_shader_stage_create_info;
-        pipeline_shader_stage_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-        pipeline_shader_stage_create_info.pNext = NULL;
-        pipeline_shader_stage_create_info.flags = 0;
-        pipeline_shader_stage_create_info.stage = canvas_vulkan_shader_stage_flag_bit_get_PRIVATE(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->type);
-        pipeline_shader_stage_create_info.module = renderer->vk.shader_module_all[i];
-        pipeline_shader_stage_create_info.pName = "main";
-        pipeline_shader_stage_create_info.pSpecializationInfo = NULL;
+        VkCommandBufferAllocateInfo command_buffer_allocate_info;
+        command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.pNext = NULL;
+        command_buffer_allocate_info.commandPool = renderer->vk.commandpool_all[i];
+        command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        VkResult result = vkAllocateCommandBuffers(renderer->vk.device, &command_buffer_allocate_info, &renderer->vk.commandbuffer_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkAllocateCommandBuffers (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
+
+    const uint32_t record_commandbuffer_count = renderer->vk.frame_count * renderer->vk.record_list_count;
 
-        pipeline_shader_stage_create_info_all[i] = pipeline_shader_stage_create_info;
+    renderer->vk.record_commandbuffer_all = malloc(sizeof(*renderer->vk.record_commandbuffer_all) * record_commandbuffer_count);
+    SPRX_ASSERT(NULL != renderer->vk.record_commandbuffer_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    for (uint32_t i = 0; i < record_commandbuffer_count; i++)
+    {
+        VkCommandBufferAllocateInfo command_buffer_allocate_info;
+        command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        command_buffer_allocate_info.pNext = NULL;
+        command_buffer_allocate_info.commandPool = renderer->vk.record_commandpool_all[i];
+        command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        command_buffer_allocate_info.commandBufferCount = 1;
+
+        VkResult result = vkAllocateCommandBuffers(renderer->vk.device, &command_buffer_allocate_info, &renderer->vk.record_commandbuffer_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkAllocateCommandBuffers record (%u/%u)", i + 1, record_commandbuffer_count);
     }
+}
 
-    VkPipelineVertexInputStateCreateInfo pipeline_vertex_input_state_create_info;
-    pipeline_vertex_input_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    pipeline_vertex_input_state_create_info.pNext = NULL;
-    pipeline_vertex_input_state_create_info.flags = 0;
-    pipeline_vertex_input_state_create_info.vertexBindingDescriptionCount = 0;
-    pipeline_vertex_input_state_create_info.pVertexBindingDescriptions = NULL;
-    pipeline_vertex_input_state_create_info.vertexAttributeDescriptionCount = 0;
-    pipeline_vertex_input_state_create_info.pVertexAttributeDescriptions = NULL;
+void canvas_vulkan_commandbuffer_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
-    VkPipelineInputAssemblyStateCreateInfo pipelien_input_assembly_state_create_info;
-    pipelien_input_assembly_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    pipelien_input_assembly_state_create_info.pNext = NULL;
-    pipelien_input_assembly_state_create_info.flags = 0;
-    pipelien_input_assembly_state_create_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    pipelien_input_assembly_state_create_info.primitiveRestartEnable = VK_FALSE;
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        vkFreeCommandBuffers(renderer->vk.device, renderer->vk.commandpool_all[i], 1, &renderer->vk.commandbuffer_all[i]);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkFreeCommandBuffers (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
+
+    free(renderer->vk.commandbuffer_all);
+
+    const uint32_t record_commandbuffer_count = renderer->vk.frame_count * renderer->vk.record_list_count;
+
+    for (uint32_t i = 0; i < record_commandbuffer_count; i++)
+    {
+        vkFreeCommandBuffers(renderer->vk.device, renderer->vk.record_commandpool_all[i], 1, &renderer->vk.record_commandbuffer_all[i]);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkFreeCommandBuffers record (%u/%u)", i + 1, record_commandbuffer_count);
+    }
+
+    free(renderer->vk.record_commandbuffer_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandbuffer destruction");
+}
+
+void canvas_vulkan_draw_record_PRIVATE(void* const renderer_, const VkCommandBuffer commandbuffer_, const size_t draw_first_, const size_t draw_last_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //dynamic state is not inherited by secondary command buffers, so every list sets it
     VkViewport viewport;
     viewport.x = 0.0f;
     viewport.y = 0.0f;
@@ -669,361 +2276,364 @@ void canvas_vulkan_pipeline_create(void* const renderer_)
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
 
+    vkCmdSetViewport(commandbuffer_, 0, 1, &viewport);
+
     VkRect2D scissor;
     scissor.offset.x = 0;
     scissor.offset.y = 0;
     scissor.extent.width = renderer->width;
     scissor.extent.height = renderer->height;
 
-    VkPipelineViewportStateCreateInfo pipeline_viewport_state_create_info;
-    pipeline_viewport_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    pipeline_viewport_state_create_info.pNext = NULL;
-    pipeline_viewport_state_create_info.flags = 0;
-    pipeline_viewport_state_create_info.viewportCount = 1;
-    pipeline_viewport_state_create_info.pViewports = &viewport;
-    pipeline_viewport_state_create_info.scissorCount = 1;
-    pipeline_viewport_state_create_info.pScissors = &scissor;
+    vkCmdSetScissor(commandbuffer_, 0, 1, &scissor);
 
-    VkPipelineRasterizationStateCreateInfo pipeline_rasterisation_state_create_info;
-    pipeline_rasterisation_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    pipeline_rasterisation_state_create_info.pNext = NULL;
-    pipeline_rasterisation_state_create_info.flags = 0;
-    pipeline_rasterisation_state_create_info.depthClampEnable = VK_FALSE;
-    pipeline_rasterisation_state_create_info.rasterizerDiscardEnable = VK_FALSE;
-    pipeline_rasterisation_state_create_info.polygonMode = VK_POLYGON_MODE_FILL;
-    pipeline_rasterisation_state_create_info.cullMode = VK_CULL_MODE_BACK_BIT;
-    pipeline_rasterisation_state_create_info.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    pipeline_rasterisation_state_create_info.depthBiasEnable = VK_FALSE;
-    pipeline_rasterisation_state_create_info.depthBiasConstantFactor = 0.0f;
-    pipeline_rasterisation_state_create_info.depthBiasClamp = 0.0f;
-    pipeline_rasterisation_state_create_info.depthBiasSlopeFactor = 0.0f;
-    pipeline_rasterisation_state_create_info.lineWidth = 1.0f;
+    canvas_vulkan_descriptor_bind(renderer, commandbuffer_);
 
-    VkPipelineMultisampleStateCreateInfo pipeline_multisample_state_create_info;
-    pipeline_multisample_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    pipeline_multisample_state_create_info.pNext = NULL;
-    pipeline_multisample_state_create_info.flags = 0;
-    pipeline_multisample_state_create_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-    pipeline_multisample_state_create_info.sampleShadingEnable = VK_FALSE;
-    pipeline_multisample_state_create_info.minSampleShading = 1.0f;
-    pipeline_multisample_state_create_info.pSampleMask = NULL;
-    pipeline_multisample_state_create_info.alphaToCoverageEnable = VK_FALSE;
-    pipeline_multisample_state_create_info.alphaToOneEnable = VK_FALSE;
+    uint32_t variant_bound = CNVX_VULKAN_PIPELINE_VARIANT_NONE;
+    VkBuffer buffer_bound = VK_NULL_HANDLE;
+    VkBuffer index_buffer_bound = VK_NULL_HANDLE;
+    const CNVX_Vulkan_Push_Constant_PRIVATE* push_constant_pushed = NULL;
+    uint32_t uniform_offset_bound = CNVX_VULKAN_UNIFORM_OFFSET_NONE;
+    bool uniform_bound_is = false;
 
-    VkPipelineColorBlendAttachmentState pipeline_color_blend_attachment_state;
-    pipeline_color_blend_attachment_state.blendEnable = VK_TRUE;
-    pipeline_color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    pipeline_color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    pipeline_color_blend_attachment_state.colorBlendOp = VK_BLEND_OP_ADD;
-    pipeline_color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    pipeline_color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    pipeline_color_blend_attachment_state.alphaBlendOp = VK_BLEND_OP_ADD;
-    pipeline_color_blend_attachment_state.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    //all draws of a frame usually live in the same arena buffer, so buffers are bound once per pipeline switch
+    for (size_t i = draw_first_; i < draw_last_; i++)
+    {
+        canvas_vulkan_timestamp_region_write(renderer, commandbuffer_, i);
 
-    VkPipelineColorBlendStateCreateInfo pipeline_color_blend_state_create_info;
-    pipeline_color_blend_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    pipeline_color_blend_state_create_info.pNext = NULL;
-    pipeline_color_blend_state_create_info.flags = 0;
-    pipeline_color_blend_state_create_info.logicOpEnable = VK_FALSE;
-    pipeline_color_blend_state_create_info.logicOp = VK_LOGIC_OP_NO_OP;
-    pipeline_color_blend_state_create_info.attachmentCount = 1;
-    pipeline_color_blend_state_create_info.pAttachments = &pipeline_color_blend_attachment_state;
-    pipeline_color_blend_state_create_info.blendConstants[0] = 0.0f;
-    pipeline_color_blend_state_create_info.blendConstants[1] = 0.0f;
-    pipeline_color_blend_state_create_info.blendConstants[2] = 0.0f;
-    pipeline_color_blend_state_create_info.blendConstants[3] = 0.0f;
+        const CNVX_Renderer_Draw_PRIVATE* const draw = SPRX_VECTOR_AT(renderer->draw_vec, i, CNVX_Renderer_Draw_PRIVATE);
 
-    VkDynamicState dynamic_state_all[] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        if (VK_NULL_HANDLE == renderer->vk.pipeline_variant_all[draw->variant].pipeline)
+        {
+            continue;
+        }
 
-    VkPipelineDynamicStateCreateInfo pipeline_dynamic_state_create_info;
-    pipeline_dynamic_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    pipeline_dynamic_state_create_info.pNext = NULL;
-    pipeline_dynamic_state_create_info.flags = 0;
-    pipeline_dynamic_state_create_info.dynamicStateCount = 2;
-    pipeline_dynamic_state_create_info.pDynamicStates = dynamic_state_all;
+        //variants of the same shader set share their vertex layout, buffers stay bound only within one
+        if (variant_bound != draw->variant)
+        {
+            vkCmdBindPipeline(commandbuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->vk.pipeline_variant_all[draw->variant].pipeline);
 
-    VkPipelineLayoutCreateInfo pipeline_layout_create_info;
-    pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-    pipeline_layout_create_info.pNext = NULL;
-    pipeline_layout_create_info.flags = 0;
-    pipeline_layout_create_info.setLayoutCount = 0;
-    pipeline_layout_create_info.pSetLayouts = NULL;
-    pipeline_layout_create_info.pushConstantRangeCount = 0;
-    pipeline_layout_create_info.pPushConstantRanges = NULL;
+            variant_bound = draw->variant;
+            buffer_bound = VK_NULL_HANDLE;
+        }
 
-    VkResult result = vkCreatePipelineLayout(renderer->vk.device, &pipeline_layout_create_info, NULL, &renderer->vk.pipeline_layout);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreatePipelineLayout");
+        if (buffer_bound != draw->buffer)
+        {
+            if (CNVX_RENDERER_PIPELINE_QUAD == draw->pipeline)
+            {
+                const VkBuffer buffer_all[] = { renderer->vk.quad_buffer, draw->buffer };
+                const VkDeviceSize offset_all[] = { 0, 0 };
 
-    VkAttachmentDescription attachment_description;
-    attachment_description.flags = 0;
-    attachment_description.format = renderer->vk.format_use;
-    attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
-    attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    attachment_description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    attachment_description.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+                vkCmdBindVertexBuffers(commandbuffer_, 0, 2, buffer_all, offset_all);
+                vkCmdBindIndexBuffer(commandbuffer_, renderer->vk.quad_buffer, CNVX_VULKAN_QUAD_INDEX_OFFSET, VK_INDEX_TYPE_UINT32);
 
-    VkAttachmentReference attachment_refference;
-    attachment_refference.attachment = 0;
-    attachment_refference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                index_buffer_bound = renderer->vk.quad_buffer;
+            }
+            else
+            {
+                const VkDeviceSize offset = 0;
 
-    VkSubpassDescription subpass_description;
-    subpass_description.flags = 0;
-    subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass_description.inputAttachmentCount = 0;
-    subpass_description.pInputAttachments = NULL;
-    subpass_description.colorAttachmentCount = 1;
-    subpass_description.pColorAttachments = &attachment_refference;
-    subpass_description.pResolveAttachments = NULL;
-    subpass_description.pDepthStencilAttachment = NULL;
-    subpass_description.preserveAttachmentCount = 0;
-    subpass_description.pPreserveAttachments = NULL;
+                vkCmdBindVertexBuffers(commandbuffer_, 0, 1, &draw->buffer, &offset);
+            }
 
-    VkSubpassDependency subpass_dependency;
-    subpass_dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
-    subpass_dependency.dstSubpass = 0;
-    subpass_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    subpass_dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    subpass_dependency.srcAccessMask = 0;
-    subpass_dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-    subpass_dependency.dependencyFlags = 0;
+            buffer_bound = draw->buffer;
+        }
 
-    VkRenderPassCreateInfo render_pass_create_info;
-    render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    render_pass_create_info.pNext = NULL;
-    render_pass_create_info.flags = 0;
-    render_pass_create_info.attachmentCount = 1;
-    render_pass_create_info.pAttachments = &attachment_description;
-    render_pass_create_info.subpassCount = 1;
-    render_pass_create_info.pSubpasses = &subpass_description;
-    render_pass_create_info.dependencyCount = 1;
-    render_pass_create_info.pDependencies = &subpass_dependency;
+        //the indices may live in another arena buffer than the vertices
+        if (VK_NULL_HANDLE != draw->index_buffer && index_buffer_bound != draw->index_buffer)
+        {
+            vkCmdBindIndexBuffer(commandbuffer_, draw->index_buffer, 0, VK_INDEX_TYPE_UINT32);
 
-    result = vkCreateRenderPass(renderer->vk.device, &render_pass_create_info, NULL, &renderer->vk.renderer_pass);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateRenderPass");
+            index_buffer_bound = draw->index_buffer;
+        }
 
-    VkGraphicsPipelineCreateInfo graphics_pipeline_create_info;
-    graphics_pipeline_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    graphics_pipeline_create_info.pNext = NULL;
-    graphics_pipeline_create_info.flags = 0;
-    graphics_pipeline_create_info.stageCount = spore_vector_capacity(renderer->shader_vec);
-    graphics_pipeline_create_info.pStages = pipeline_shader_stage_create_info_all;
-    graphics_pipeline_create_info.pVertexInputState = &pipeline_vertex_input_state_create_info;
-    graphics_pipeline_create_info.pInputAssemblyState = &pipelien_input_assembly_state_create_info;
-    graphics_pipeline_create_info.pTessellationState = NULL;
-    graphics_pipeline_create_info.pViewportState = &pipeline_viewport_state_create_info;
-    graphics_pipeline_create_info.pRasterizationState = &pipeline_rasterisation_state_create_info;
-    graphics_pipeline_create_info.pMultisampleState = &pipeline_multisample_state_create_info;
-    graphics_pipeline_create_info.pDepthStencilState = NULL;
-    graphics_pipeline_create_info.pColorBlendState = &pipeline_color_blend_state_create_info;
-    graphics_pipeline_create_info.pDynamicState = &pipeline_dynamic_state_create_info;
-    graphics_pipeline_create_info.layout = renderer->vk.pipeline_layout;
-    graphics_pipeline_create_info.renderPass = renderer->vk.renderer_pass;
-    graphics_pipeline_create_info.subpass = 0;
-    graphics_pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
-    graphics_pipeline_create_info.basePipelineIndex = -1;
+        //rebinding the same set with new dynamic offsets is cheap, no descriptor is written
+        if (!uniform_bound_is || uniform_offset_bound != draw->uniform_offset)
+        {
+            canvas_vulkan_uniform_bind(renderer, commandbuffer_, draw->uniform_offset);
 
-    result = vkCreateGraphicsPipelines(renderer->vk.device, VK_NULL_HANDLE, 1, &graphics_pipeline_create_info, NULL, &renderer->vk.pipeline);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateGraphicsPipelines");
+            uniform_offset_bound = draw->uniform_offset;
+            uniform_bound_is = true;
+        }
+
+        if (NULL == push_constant_pushed || 0 != memcmp(push_constant_pushed, &draw->push_constant, sizeof(draw->push_constant)))
+        {
+            vkCmdPushConstants(commandbuffer_, renderer->vk.pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(draw->push_constant), &draw->push_constant);
+
+            push_constant_pushed = &draw->push_constant;
+        }
+
+        if (CNVX_RENDERER_PIPELINE_QUAD == draw->pipeline)
+        {
+            vkCmdDrawIndexed(commandbuffer_, draw->index_count, draw->instance_count, 0, 0, draw->instance_first);
+        }
+        else if (0 != draw->index_count)
+        {
+            vkCmdDrawIndexed(commandbuffer_, draw->index_count, 1, draw->index_first, draw->vertex_first, 0);
+        }
+        else
+        {
+            vkCmdDraw(commandbuffer_, draw->vertex_count, 1, draw->vertex_first, 0);
+        }
+    }
 
-    free(pipeline_shader_stage_create_info_all);
+    //regions ending with the frame belong to the list holding the last draw
+    if (spore_vector_size(renderer->draw_vec) == draw_last_ && (draw_first_ < draw_last_ || 0 == draw_first_))
+    {
+        canvas_vulkan_timestamp_region_write(renderer, commandbuffer_, draw_last_);
+    }
 }
 
-void canvas_vulkan_pipeline_destroy(void* const renderer_)
+void canvas_vulkan_record_list_PRIVATE(void* const renderer_, const size_t index_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline destruction");
+    const VkCommandBuffer commandbuffer = renderer->vk.record_commandbuffer_all[renderer->vk.frame_index * renderer->vk.record_list_count + index_];
+
+    //contiguous slices keep the submission order once the lists are executed in order
+    const size_t draw_count = spore_vector_size(renderer->draw_vec);
+    const size_t draw_per_list = (draw_count + renderer->vk.record_list_use_count - 1) / renderer->vk.record_list_use_count;
+    const size_t draw_first = SPRX_MIN(draw_per_list * index_, draw_count);
+    const size_t draw_last = SPRX_MIN(draw_first + draw_per_list, draw_count);
+
+    VkCommandBufferInheritanceRenderingInfoKHR command_buffer_inheritance_rendering_info;
+    command_buffer_inheritance_rendering_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+    command_buffer_inheritance_rendering_info.pNext = NULL;
+    command_buffer_inheritance_rendering_info.flags = 0;
+    command_buffer_inheritance_rendering_info.viewMask = 0;
+    command_buffer_inheritance_rendering_info.colorAttachmentCount = 1;
+    command_buffer_inheritance_rendering_info.pColorAttachmentFormats = &renderer->vk.format_use;
+    command_buffer_inheritance_rendering_info.depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    command_buffer_inheritance_rendering_info.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+    command_buffer_inheritance_rendering_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkCommandBufferInheritanceInfo command_buffer_inheritance_info;
+    command_buffer_inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    command_buffer_inheritance_info.pNext = renderer->vk.dynamic_rendering_is ? &command_buffer_inheritance_rendering_info : NULL;
+    command_buffer_inheritance_info.renderPass = renderer->vk.renderer_pass;
+    command_buffer_inheritance_info.subpass = 0;
+    command_buffer_inheritance_info.framebuffer = renderer->vk.dynamic_rendering_is ? VK_NULL_HANDLE : renderer->vk.framebuffer_all[renderer->vk.record_image_index];
+    command_buffer_inheritance_info.occlusionQueryEnable = VK_FALSE;
+    command_buffer_inheritance_info.queryFlags = 0;
+    command_buffer_inheritance_info.pipelineStatistics = 0;
 
-    vkDestroyPipeline(renderer->vk.device, renderer->vk.pipeline, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyPipeline");
+    VkCommandBufferBeginInfo command_buffer_begin_info;
+    command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.pNext = NULL;
+    command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    command_buffer_begin_info.pInheritanceInfo = &command_buffer_inheritance_info;
 
-    vkDestroyRenderPass(renderer->vk.device, renderer->vk.renderer_pass, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyRenderPass");
+    VkResult result = vkBeginCommandBuffer(commandbuffer, &command_buffer_begin_info);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkBeginCommandBuffer record");
 
-    vkDestroyPipelineLayout(renderer->vk.device, renderer->vk.pipeline_layout, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyPipelineLayout");
+    canvas_vulkan_draw_record_PRIVATE(renderer, commandbuffer, draw_first, draw_last);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: pipeline destruction");
+    result = vkEndCommandBuffer(commandbuffer);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkEndCommandBuffer record");
 }
 
-void canvas_vulkan_framebuffer_create(void* const renderer_)
+void canvas_vulkan_rendering_begin_PRIVATE(void* const renderer_, const VkCommandBuffer commandbuffer_, const bool secondary_is_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: framebuffer destruction");
-
-    renderer->vk.framebuffer_all = malloc(sizeof(*renderer->vk.framebuffer_all) * renderer->vk.swapchain_image_all_count);
-    SPRX_ASSERT(NULL != renderer->vk.framebuffer_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    VkClearValue clear_value = { 0.0f, 0.0f, 0.0f, 1.0f };
 
-    VkFramebufferCreateInfo frame_buffer_create_info;
-    frame_buffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-    frame_buffer_create_info.pNext = NULL;
-    frame_buffer_create_info.flags = 0;
-    frame_buffer_create_info.renderPass = renderer->vk.renderer_pass;
-    frame_buffer_create_info.attachmentCount = 1;
-    frame_buffer_create_info.width = renderer->width;
-    frame_buffer_create_info.height = renderer->height;
-    frame_buffer_create_info.layers = 1;
+    VkRect2D render_area;
+    render_area.offset.x = 0;
+    render_area.offset.y = 0;
+    render_area.extent.width = renderer->width;
+    render_area.extent.height = renderer->height;
 
-    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    if (renderer->vk.dynamic_rendering_is)
     {
-        frame_buffer_create_info.pAttachments = &renderer->vk.image_view_all[i];
+        VkImageView image_view;
+        canvas_vulkan_graph_image_get(renderer, renderer->vk.graph_backbuffer, NULL, &image_view);
+
+        VkRenderingAttachmentInfoKHR rendering_attachment_info;
+        rendering_attachment_info.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+        rendering_attachment_info.pNext = NULL;
+        rendering_attachment_info.imageView = image_view;
+        rendering_attachment_info.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        rendering_attachment_info.resolveMode = VK_RESOLVE_MODE_NONE;
+        rendering_attachment_info.resolveImageView = VK_NULL_HANDLE;
+        rendering_attachment_info.resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        rendering_attachment_info.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        rendering_attachment_info.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        rendering_attachment_info.clearValue = clear_value;
+
+        VkRenderingInfoKHR rendering_info;
+        rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+        rendering_info.pNext = NULL;
+        rendering_info.flags = secondary_is_ ? VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR : 0;
+        rendering_info.renderArea = render_area;
+        rendering_info.layerCount = 1;
+        rendering_info.viewMask = 0;
+        rendering_info.colorAttachmentCount = 1;
+        rendering_info.pColorAttachments = &rendering_attachment_info;
+        rendering_info.pDepthAttachment = NULL;
+        rendering_info.pStencilAttachment = NULL;
+
+        renderer->vk.cmd_begin_rendering(commandbuffer_, &rendering_info);
+    }
+    else
+    {
+        VkRenderPassBeginInfo render_pass_begin_info;
+        render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        render_pass_begin_info.pNext = NULL;
+        render_pass_begin_info.renderPass = renderer->vk.renderer_pass;
+        render_pass_begin_info.framebuffer = renderer->vk.framebuffer_all[renderer->vk.record_image_index];
+        render_pass_begin_info.renderArea = render_area;
+        render_pass_begin_info.clearValueCount = 1;
+        render_pass_begin_info.pClearValues = &clear_value;
 
-        VkResult result = vkCreateFramebuffer(renderer->vk.device, &frame_buffer_create_info, NULL, &renderer->vk.framebuffer_all[i]);
-        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateFramebuffer (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+        vkCmdBeginRenderPass(commandbuffer_, &render_pass_begin_info, secondary_is_ ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
     }
 }
 
-void canvas_vulkan_framebuffer_destroy(void* const renderer_)
+void canvas_vulkan_rendering_end_PRIVATE(void* const renderer_, const VkCommandBuffer commandbuffer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    if (renderer->vk.dynamic_rendering_is)
     {
-        vkDestroyFramebuffer(renderer->vk.device, renderer->vk.framebuffer_all[i], NULL);
-        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkDestroyFramebuffer (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+        renderer->vk.cmd_end_rendering(commandbuffer_);
+    }
+    else
+    {
+        vkCmdEndRenderPass(commandbuffer_);
     }
-
-    free(renderer->vk.framebuffer_all);
-
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: framebuffer destruction");
 }
 
-void canvas_vulkan_commandpool_create(void* const renderer_)
+void canvas_vulkan_graph_main_record_PRIVATE(void* const renderer_, const VkCommandBuffer commandbuffer_, void* const data_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandpool creation");
+    const size_t draw_count = spore_vector_size(renderer->draw_vec);
 
-    VkCommandPoolCreateInfo command_pool_create_info;
-    command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    command_pool_create_info.pNext = NULL;
-    command_pool_create_info.flags = 0;
-    command_pool_create_info.queueFamilyIndex = 0; //@TODO
+    //one draw list per worker thread, but only as many as there is work for
+    renderer->vk.record_list_use_count = (uint32_t)SPRX_MIN((draw_count + CNVX_RENDERER_RECORD_DRAW_COUNT_MIN - 1) / CNVX_RENDERER_RECORD_DRAW_COUNT_MIN, renderer->vk.record_list_count);
+
+    canvas_vulkan_timestamp_write(renderer, commandbuffer_, CNVX_VULKAN_TIMESTAMP_QUERY_PASS_BEGIN);
+
+    if (1 < renderer->vk.record_list_use_count)
+    {
+        for (uint32_t i = 0; i < renderer->vk.record_list_use_count; i++)
+        {
+            canvas_worker_submit(renderer->worker, &renderer->vk.record_job_all[i], canvas_vulkan_record_list_PRIVATE, renderer, i);
+        }
+
+        canvas_vulkan_rendering_begin_PRIVATE(renderer, commandbuffer_, true);
+
+        for (uint32_t i = 0; i < renderer->vk.record_list_use_count; i++)
+        {
+            canvas_worker_wait(renderer->worker, &renderer->vk.record_job_all[i]);
+        }
+
+        vkCmdExecuteCommands(commandbuffer_, renderer->vk.record_list_use_count, &renderer->vk.record_commandbuffer_all[renderer->vk.frame_index * renderer->vk.record_list_count]);
+    }
+    else
+    {
+        canvas_vulkan_rendering_begin_PRIVATE(renderer, commandbuffer_, false);
+
+        canvas_vulkan_draw_record_PRIVATE(renderer, commandbuffer_, 0, draw_count);
+    }
 
-    VkResult result = vkCreateCommandPool(renderer->vk.device, &command_pool_create_info, NULL, &renderer->vk.commandpool);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateCommandPool");
+    canvas_vulkan_rendering_end_PRIVATE(renderer, commandbuffer_);
+
+    canvas_vulkan_timestamp_write(renderer, commandbuffer_, CNVX_VULKAN_TIMESTAMP_QUERY_PASS_END);
 }
 
-void canvas_vulkan_commandpool_destroy(void* const renderer_)
+void canvas_vulkan_graph_readback_record_PRIVATE(void* const renderer_, const VkCommandBuffer commandbuffer_, void* const data_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    vkDestroyCommandPool(renderer->vk.device, renderer->vk.commandpool, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyCommandPool");
+    VkImage image;
+    canvas_vulkan_graph_image_get(renderer, renderer->vk.graph_backbuffer, &image, NULL);
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commadpool destruction");
+    canvas_vulkan_readback_record(renderer, commandbuffer_, image);
 }
 
-void canvas_vulkan_commandbuffer_create(void* const renderer_)
+void canvas_vulkan_frame_graph_create(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandbuffer creation");
+    canvas_vulkan_graph_create(renderer);
 
-    renderer->vk.commandbuffer_all = malloc(sizeof(*renderer->vk.commandbuffer_all) * renderer->vk.swapchain_image_all_count);
-    SPRX_ASSERT(NULL != renderer->vk.commandbuffer_all, CNVX_VULKAN_ERROR_ALLOCATION);
+    //acquisition waits at the color output stage, presentation expects PRESENT_SRC and headless images stay ready for copies
+    renderer->vk.graph_backbuffer = canvas_vulkan_graph_image_import(renderer, renderer->vk.format_use, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, renderer->settings.headless_is ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
-    VkCommandBufferAllocateInfo command_buffer_allocate_info;
-    command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    command_buffer_allocate_info.pNext = NULL;
-    command_buffer_allocate_info.commandPool = renderer->vk.commandpool;
-    command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    command_buffer_allocate_info.commandBufferCount = renderer->vk.swapchain_image_all_count;
+    renderer->vk.graph_pass_main = canvas_vulkan_graph_pass_add(renderer, "main", canvas_vulkan_graph_main_record_PRIVATE, NULL, false);
+    canvas_vulkan_graph_pass_access_add(renderer, renderer->vk.graph_pass_main, renderer->vk.graph_backbuffer, CNVX_VULKAN_GRAPH_ACCESS_TYPE_COLOR_WRITE);
 
-    VkResult result = vkAllocateCommandBuffers(renderer->vk.device, &command_buffer_allocate_info, renderer->vk.commandbuffer_all);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkAllocateCommandBuffers");
+    //the host reads the copy, nothing in the graph does
+    renderer->vk.graph_pass_readback = canvas_vulkan_graph_pass_add(renderer, "readback", canvas_vulkan_graph_readback_record_PRIVATE, NULL, true);
+    canvas_vulkan_graph_pass_access_add(renderer, renderer->vk.graph_pass_readback, renderer->vk.graph_backbuffer, CNVX_VULKAN_GRAPH_ACCESS_TYPE_TRANSFER_READ);
+    canvas_vulkan_graph_pass_enable(renderer, renderer->vk.graph_pass_readback, false);
+
+    canvas_vulkan_graph_allocate(renderer);
 }
 
-void canvas_vulkan_commandbuffer_destroy(void* const renderer_)
+void canvas_vulkan_frame_graph_destroy(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    vkFreeCommandBuffers(renderer->vk.device, renderer->vk.commandpool, renderer->vk.swapchain_image_all_count, renderer->vk.commandbuffer_all);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkFreeCommandBuffers");
-
-    free(renderer->vk.commandbuffer_all);
-
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandbuffer destruction");
+    canvas_vulkan_graph_destroy(renderer);
 }
 
-void canvas_vulkan_commandbuffer_record(void* const renderer_)
+void canvas_vulkan_commandbuffer_record(void* const renderer_, const uint32_t image_index_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: commandbuffer recording");
+    SPRX_ASSERT(renderer->vk.swapchain_image_all_count > image_index_, CNVX_VULKAN_ERROR_ARGUMENT("image_index has to be <swapchain image count"));
+
+    //the pool of this frame was reset in canvas_vulkan_frame_begin
+    const VkCommandBuffer commandbuffer = renderer->vk.commandbuffer_all[renderer->vk.frame_index];
 
     VkCommandBufferBeginInfo command_buffer_begin_info;
     command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     command_buffer_begin_info.pNext = NULL;
-    command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     command_buffer_begin_info.pInheritanceInfo = NULL;
 
-    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
-    {
-        VkResult result = vkBeginCommandBuffer(renderer->vk.commandbuffer_all[i], &command_buffer_begin_info);
-        CNVX_VULKAN_ASSERTF(renderer, result, "vkBeginCommandBuffer (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+    VkResult result = vkBeginCommandBuffer(commandbuffer, &command_buffer_begin_info);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkBeginCommandBuffer");
 
-        VkClearValue clear_value = { 0.0f, 0.0f, 0.0f, 1.0f };
+    canvas_vulkan_timestamp_reset(renderer, commandbuffer);
+    canvas_vulkan_timestamp_write(renderer, commandbuffer, CNVX_VULKAN_TIMESTAMP_QUERY_FRAME_BEGIN);
 
-        VkRenderPassBeginInfo render_pass_begin_info;
-        render_pass_begin_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        render_pass_begin_info.pNext = NULL;
-        render_pass_begin_info.renderPass = renderer->vk.renderer_pass;
-        render_pass_begin_info.framebuffer = renderer->vk.framebuffer_all[i];
-        render_pass_begin_info.renderArea.offset.x = 0;
-        render_pass_begin_info.renderArea.offset.y = 0;
-        render_pass_begin_info.renderArea.extent.width = renderer->width;
-        render_pass_begin_info.renderArea.extent.height = renderer->height;
-        render_pass_begin_info.clearValueCount = 1;
-        render_pass_begin_info.pClearValues = &clear_value;
+    //texture copies and mip blits have to happen outside of the render pass
+    canvas_vulkan_texture_record(renderer, commandbuffer);
 
-        vkCmdBeginRenderPass(renderer->vk.commandbuffer_all[i], &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-        vkCmdBindPipeline(renderer->vk.commandbuffer_all[i], VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->vk.pipeline);
+    canvas_vulkan_uniform_frame_write(renderer);
 
-        VkViewport viewport;
-        viewport.x = 0.0f;
-        viewport.y = 0.0f;
-        viewport.width = renderer->width;
-        viewport.height = renderer->height;
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
+    canvas_vulkan_pipeline_wait(renderer);
 
-        vkCmdSetViewport(renderer->vk.commandbuffer_all[i], 0, 1, &viewport);
+    renderer->vk.record_image_index = image_index_;
 
-        VkRect2D scissor;
-        scissor.offset.x = 0;
-        scissor.offset.y = 0;
-        scissor.extent.width = renderer->width;
-        scissor.extent.height = renderer->height;
+    canvas_vulkan_graph_image_bind(renderer, renderer->vk.graph_backbuffer, renderer->vk.swapchain_image_all[image_index_], renderer->vk.image_view_all[image_index_]);
+    canvas_vulkan_graph_pass_enable(renderer, renderer->vk.graph_pass_readback, canvas_vulkan_readback_prepare(renderer));
 
-        vkCmdSetScissor(renderer->vk.commandbuffer_all[i], 0, 1, &scissor);
+    canvas_vulkan_graph_execute(renderer, commandbuffer);
 
-        vkCmdDraw(renderer->vk.commandbuffer_all[i], 3, 1, 0, 0);
-        vkCmdEndRenderPass(renderer->vk.commandbuffer_all[i]);
+    canvas_vulkan_timestamp_write(renderer, commandbuffer, CNVX_VULKAN_TIMESTAMP_QUERY_FRAME_END);
 
-        result = vkEndCommandBuffer(renderer->vk.commandbuffer_all[i]);
-        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vkEndCommandBuffer (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
-    }
+    result = vkEndCommandBuffer(commandbuffer);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkEndCommandBuffer");
 }
 
 void canvas_vulkan_semaphore_create(void* const renderer_)
@@ -1039,11 +2649,15 @@ void canvas_vulkan_semaphore_create(void* const renderer_)
     semaphore_create_info.pNext = NULL;
     semaphore_create_info.flags = 0;
 
-    VkResult result = vkCreateSemaphore(renderer->vk.device, &semaphore_create_info, NULL, &renderer->vk.semaphore_image_available);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateSemaphore (1/2)");
+    //acquisition happens before the image index is known, so it is tracked per frame
+    renderer->vk.semaphore_image_available_all = malloc(sizeof(*renderer->vk.semaphore_image_available_all) * renderer->vk.frame_count);
+    SPRX_ASSERT(NULL != renderer->vk.semaphore_image_available_all, CNVX_VULKAN_ERROR_ALLOCATION);
 
-    result = vkCreateSemaphore(renderer->vk.device, &semaphore_create_info, NULL, &renderer->vk.semaphore_rendering_done);
-    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateSemaphore (2/2)");
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        VkResult result = vkCreateSemaphore(renderer->vk.device, &semaphore_create_info, NULL, &renderer->vk.semaphore_image_available_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateSemaphore image available (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
 }
 
 void canvas_vulkan_semaphore_destroy(void* const renderer_)
@@ -1052,55 +2666,407 @@ void canvas_vulkan_semaphore_destroy(void* const renderer_)
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    vkDestroySemaphore(renderer->vk.device, renderer->vk.semaphore_rendering_done, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySemaphore(1/2)");
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        vkDestroySemaphore(renderer->vk.device, renderer->vk.semaphore_image_available_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySemaphore image available (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
 
-    vkDestroySemaphore(renderer->vk.device, renderer->vk.semaphore_image_available, NULL);
-    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySemaphore(2/2)");
+    free(renderer->vk.semaphore_image_available_all);
 
     CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: semaphore destruction");
 }
 
+void canvas_vulkan_semaphore_rendering_done_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: semaphore rendering done creation");
+
+    VkSemaphoreCreateInfo semaphore_create_info;
+    semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphore_create_info.pNext = NULL;
+    semaphore_create_info.flags = 0;
+
+    //presentation holds on to its wait semaphore until the image is acquired again, so it is tracked per image
+    renderer->vk.semaphore_rendering_done_all = malloc(sizeof(*renderer->vk.semaphore_rendering_done_all) * renderer->vk.swapchain_image_all_count);
+    SPRX_ASSERT(NULL != renderer->vk.semaphore_rendering_done_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        VkResult result = vkCreateSemaphore(renderer->vk.device, &semaphore_create_info, NULL, &renderer->vk.semaphore_rendering_done_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateSemaphore rendering done (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+    }
+}
+
+void canvas_vulkan_semaphore_rendering_done_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.swapchain_image_all_count; i++)
+    {
+        vkDestroySemaphore(renderer->vk.device, renderer->vk.semaphore_rendering_done_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySemaphore rendering done (%u/%u)", i + 1, renderer->vk.swapchain_image_all_count);
+    }
+
+    free(renderer->vk.semaphore_rendering_done_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: semaphore rendering done destruction");
+}
+
+void canvas_vulkan_fence_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: fence creation");
+
+    renderer->vk.fence_frame_all = malloc(sizeof(*renderer->vk.fence_frame_all) * renderer->vk.frame_count);
+    SPRX_ASSERT(NULL != renderer->vk.fence_frame_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    //created signaled so the first wait on every frame returns immediately
+    VkFenceCreateInfo fence_create_info;
+    fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_create_info.pNext = NULL;
+    fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        VkResult result = vkCreateFence(renderer->vk.device, &fence_create_info, NULL, &renderer->vk.fence_frame_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateFence (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
+
+    renderer->vk.frame_index = 0;
+    renderer->vk.frame_begun_is = false;
+    renderer->vk.frame_serial = 0;
+    memset(renderer->vk.frame_serial_submitted_all, 0, sizeof(renderer->vk.frame_serial_submitted_all));
+    memset(renderer->vk.frame_serial_done_all, 0, sizeof(renderer->vk.frame_serial_done_all));
+
+    spore_vector_clear_reserve(renderer->draw_vec, CNVX_RENDERER_DRAW_GROWTH);
+}
+
+void canvas_vulkan_fence_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        vkDestroyFence(renderer->vk.device, renderer->vk.fence_frame_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyFence (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
+
+    free(renderer->vk.fence_frame_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: fence destruction");
+}
+
+void canvas_vulkan_frame_begin(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (!renderer->vk.frame_begun_is)
+    {
+        //blocks only if the gpu is still working on the frame recorded frame_count updates ago
+        VkResult result = vkWaitForFences(renderer->vk.device, 1, &renderer->vk.fence_frame_all[renderer->vk.frame_index], VK_TRUE, UINT64_MAX);
+        CNVX_VULKAN_QASSERT(renderer, result, "vkWaitForFences");
+
+        //the gpu is done with this frame's arena and command buffers
+        canvas_vulkan_memory_linear_reset(renderer);
+        canvas_vulkan_uniform_frame_reset(renderer);
+
+        renderer->vk.frame_serial_done_all[renderer->vk.frame_index] = renderer->vk.frame_serial_submitted_all[renderer->vk.frame_index];
+        canvas_vulkan_deferred_collect(renderer, false);
+        canvas_vulkan_descriptor_frame_reset(renderer);
+
+        //the fence is signaled, so the results are there without waiting
+        canvas_vulkan_timestamp_collect(renderer);
+
+        //nothing of this frame is recorded yet, so changed shaders can be swapped in
+        canvas_vulkan_reload_update(renderer);
+
+        result = vkResetCommandPool(renderer->vk.device, renderer->vk.commandpool_all[renderer->vk.frame_index], 0);
+        CNVX_VULKAN_QASSERT(renderer, result, "vkResetCommandPool");
+
+        for (uint32_t i = 0; i < renderer->vk.record_list_count; i++)
+        {
+            result = vkResetCommandPool(renderer->vk.device, renderer->vk.record_commandpool_all[renderer->vk.frame_index * renderer->vk.record_list_count + i], 0);
+            CNVX_VULKAN_QASSERT(renderer, result, "vkResetCommandPool record");
+        }
+
+        renderer->vk.frame_begun_is = true;
+    }
+}
+
 void canvas_vulkan_frame_draw(void* const renderer_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    if (renderer->width * renderer->height)
+    if (renderer->prepared_is && renderer->width * renderer->height)
     {
-        uint32_t image_index = 0;
+        const uint32_t frame_index = renderer->vk.frame_index;
+
+        canvas_vulkan_frame_begin(renderer);
+
+        //headless images are owned per frame, so there is nothing to acquire
+        uint32_t image_index = frame_index;
+
+        VkResult result = VK_SUCCESS;
+
+        if (!renderer->settings.headless_is)
+        {
+            result = vkAcquireNextImageKHR(renderer->vk.device, renderer->vk.swapchain, UINT64_MAX, renderer->vk.semaphore_image_available_all[frame_index], VK_NULL_HANDLE, &image_index);
+
+            if (VK_ERROR_OUT_OF_DATE_KHR == result)
+            {
+                //the window resize callback recreates the swapchain, the fence stays signaled
+                return;
+            }
+
+            if (VK_SUBOPTIMAL_KHR != result)
+            {
+                CNVX_VULKAN_QASSERT(renderer, result, "vkAcquireNextImageKHR");
+            }
+        }
 
-        VkResult result = vkAcquireNextImageKHR(renderer->vk.device, renderer->vk.swapchain, INT64_MAX, renderer->vk.semaphore_image_available, VK_NULL_HANDLE, &image_index);
-        CNVX_VULKAN_QASSERT(renderer, result, "vkAcquireNextImageKHR");
+        result = vkResetFences(renderer->vk.device, 1, &renderer->vk.fence_frame_all[frame_index]);
+        CNVX_VULKAN_QASSERT(renderer, result, "vkResetFences");
 
-        VkPipelineStageFlags wait_stage_mask[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+        canvas_vulkan_commandbuffer_record(renderer, image_index);
+
+        //uploads recorded since the last frame have to land before this frame reads them
+        canvas_vulkan_transfer_flush(renderer);
+
+        uint32_t wait_semaphore_count = 0;
+        VkSemaphore wait_semaphore_all[2];
+        uint64_t wait_value_all[2];
+        VkPipelineStageFlags wait_stage_mask_all[2];
+
+        if (!renderer->settings.headless_is)
+        {
+            wait_semaphore_all[wait_semaphore_count] = renderer->vk.semaphore_image_available_all[frame_index];
+            wait_value_all[wait_semaphore_count] = 0; //ignored for binary semaphores
+            wait_stage_mask_all[wait_semaphore_count] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            wait_semaphore_count++;
+        }
+
+        if (canvas_vulkan_transfer_wait_get(renderer, &wait_semaphore_all[wait_semaphore_count], &wait_value_all[wait_semaphore_count], &wait_stage_mask_all[wait_semaphore_count]))
+        {
+            wait_semaphore_count++;
+        }
+
+        VkTimelineSemaphoreSubmitInfo timeline_semaphore_submit_info;
+        timeline_semaphore_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_semaphore_submit_info.pNext = NULL;
+        timeline_semaphore_submit_info.waitSemaphoreValueCount = wait_semaphore_count;
+        timeline_semaphore_submit_info.pWaitSemaphoreValues = wait_value_all;
+        timeline_semaphore_submit_info.signalSemaphoreValueCount = 0;
+        timeline_semaphore_submit_info.pSignalSemaphoreValues = NULL;
 
         VkSubmitInfo submit_info;
         submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submit_info.pNext = NULL;
-        submit_info.waitSemaphoreCount = 1;
-        submit_info.pWaitSemaphores = &renderer->vk.semaphore_image_available;
-        submit_info.pWaitDstStageMask = wait_stage_mask;
-        submit_info.commandBufferCount = renderer->vk.swapchain_image_all_count;
-        submit_info.pCommandBuffers = &renderer->vk.commandbuffer_all[image_index];
-        submit_info.signalSemaphoreCount = 1;
-        submit_info.pSignalSemaphores = &renderer->vk.semaphore_rendering_done;
-
-        result = vkQueueSubmit(renderer->vk.queue, 1, &submit_info, VK_NULL_HANDLE);
+        submit_info.pNext = renderer->vk.timeline_semaphore_is ? &timeline_semaphore_submit_info : NULL;
+        submit_info.waitSemaphoreCount = wait_semaphore_count;
+        submit_info.pWaitSemaphores = wait_semaphore_all;
+        submit_info.pWaitDstStageMask = wait_stage_mask_all;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers = &renderer->vk.commandbuffer_all[frame_index];
+        submit_info.signalSemaphoreCount = renderer->settings.headless_is ? 0 : 1;
+        submit_info.pSignalSemaphores = &renderer->vk.semaphore_rendering_done_all[image_index];
+
+        result = vkQueueSubmit(renderer->vk.queue, 1, &submit_info, renderer->vk.fence_frame_all[frame_index]);
         CNVX_VULKAN_QASSERT(renderer, result, "vkQueueSubmit");
 
-        VkPresentInfoKHR present_info;
-        present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        present_info.pNext = NULL;
-        present_info.waitSemaphoreCount = 1;
-        present_info.pWaitSemaphores = &renderer->vk.semaphore_rendering_done;
-        present_info.swapchainCount = 1;
-        present_info.pSwapchains = &renderer->vk.swapchain;
-        present_info.pImageIndices = &image_index;
-        present_info.pResults = NULL;
+        renderer->vk.frame_serial_submitted_all[frame_index] = ++renderer->vk.frame_serial;
+
+        canvas_vulkan_texture_submitted(renderer);
+
+        canvas_pacer_submitted(&renderer->pacer);
+
+        if (!renderer->settings.headless_is)
+        {
+            VkPresentInfoKHR present_info;
+            present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+            present_info.pNext = NULL;
+            present_info.waitSemaphoreCount = 1;
+            present_info.pWaitSemaphores = &renderer->vk.semaphore_rendering_done_all[image_index];
+            present_info.swapchainCount = 1;
+            present_info.pSwapchains = &renderer->vk.swapchain;
+            present_info.pImageIndices = &image_index;
+            present_info.pResults = NULL;
+
+            result = vkQueuePresentKHR(renderer->vk.queue, &present_info);
+
+            if (VK_ERROR_OUT_OF_DATE_KHR != result && VK_SUBOPTIMAL_KHR != result)
+            {
+                CNVX_VULKAN_QASSERT(renderer, result, "vkQueuePresentKHR");
+            }
+        }
+
+        spore_vector_clear_reserve(renderer->draw_vec, CNVX_RENDERER_DRAW_GROWTH);
+        canvas_vulkan_timestamp_region_clear(renderer);
+
+        renderer->vk.frame_begun_is = false;
+        renderer->vk.frame_index = (frame_index + 1) % renderer->vk.frame_count;
+    }
+    else if (renderer->vk.frame_begun_is)
+    {
+        //nothing is presented, drop the geometry so the arena does not overflow
+        spore_vector_clear_reserve(renderer->draw_vec, CNVX_RENDERER_DRAW_GROWTH);
+        canvas_vulkan_timestamp_region_clear(renderer);
+        canvas_vulkan_memory_linear_reset(renderer);
+        canvas_vulkan_uniform_frame_reset(renderer);
+    }
+}
+
+void canvas_vulkan_geometry_submit(void* const renderer_, const CNVX_Renderer_Vertex* const vertex_all_, const size_t vertex_count_, const uint32_t* const index_all_, const size_t index_count_, const uint32_t texture_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != vertex_all_, CNVX_VULKAN_ERROR_NULL("vertex_all"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_frame_begin(renderer);
+
+    //the draw uniform block did not fit into the arena
+    if (CNVX_VULKAN_UNIFORM_OFFSET_INVALID == renderer->vk.uniform_draw_offset)
+    {
+        return;
+    }
+
+    CNVX_Renderer_Draw_PRIVATE draw;
+    draw.pipeline = CNVX_RENDERER_PIPELINE_GEOMETRY;
+    draw.variant = canvas_vulkan_pipeline_variant_request_PRIVATE(renderer, CNVX_RENDERER_PIPELINE_GEOMETRY);
+
+    if (CNVX_VULKAN_PIPELINE_VARIANT_NONE == draw.variant)
+    {
+        return;
+    }
+
+    draw.instance_first = 0;
+    draw.instance_count = 1;
+    draw.uniform_offset = renderer->vk.uniform_draw_offset;
+
+    memset(&draw.push_constant, 0, sizeof(draw.push_constant));
+    draw.push_constant.texture_index = texture_index_;
+
+    VkDeviceSize vertex_offset = 0;
+
+    //aligned to the stride so the offset can be passed as vertex index
+    CNVX_Renderer_Vertex* const vertex_data = canvas_vulkan_memory_linear_allocate(renderer, sizeof(*vertex_all_) * vertex_count_, sizeof(*vertex_all_), &draw.buffer, &vertex_offset);
+
+    if (NULL == vertex_data)
+    {
+        return;
+    }
+
+    memcpy(vertex_data, vertex_all_, sizeof(*vertex_all_) * vertex_count_);
+
+    draw.vertex_first = (uint32_t)(vertex_offset / sizeof(*vertex_all_));
+    draw.vertex_count = (uint32_t)vertex_count_;
+    draw.index_buffer = VK_NULL_HANDLE;
+    draw.index_first = 0;
+    draw.index_count = 0;
+
+    if (NULL != index_all_)
+    {
+        VkBuffer index_buffer = VK_NULL_HANDLE;
+        VkDeviceSize index_offset = 0;
+
+        uint32_t* const index_data = canvas_vulkan_memory_linear_allocate(renderer, sizeof(*index_all_) * index_count_, sizeof(*index_all_), &index_buffer, &index_offset);
+
+        if (NULL == index_data)
+        {
+            return;
+        }
 
-        result = vkQueuePresentKHR(renderer->vk.queue, &present_info);
-        CNVX_VULKAN_QASSERT(renderer, result, "vkQueuePresentKHR");
+        memcpy(index_data, index_all_, sizeof(*index_all_) * index_count_);
+
+        draw.index_buffer = index_buffer;
+        draw.index_first = (uint32_t)(index_offset / sizeof(*index_all_));
+        draw.index_count = (uint32_t)index_count_;
+    }
+
+    spore_vector_push_back_grow(renderer->draw_vec, CNVX_RENDERER_DRAW_GROWTH, &draw);
+}
+
+void canvas_vulkan_quad_submit(void* const renderer_, const CNVX_Renderer_Quad* const quad_all_, const size_t quad_count_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != quad_all_, CNVX_VULKAN_ERROR_NULL("quad_all"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_frame_begin(renderer);
+
+    //the draw uniform block did not fit into the arena
+    if (CNVX_VULKAN_UNIFORM_OFFSET_INVALID == renderer->vk.uniform_draw_offset)
+    {
+        return;
+    }
+
+    const uint32_t variant = canvas_vulkan_pipeline_variant_request_PRIVATE(renderer, CNVX_RENDERER_PIPELINE_QUAD);
+
+    if (CNVX_VULKAN_PIPELINE_VARIANT_NONE == variant)
+    {
+        return;
     }
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+
+    //aligned to the stride so the offset can be passed as first instance
+    CNVX_Renderer_Quad* const quad_data = canvas_vulkan_memory_linear_allocate(renderer, sizeof(*quad_all_) * quad_count_, sizeof(*quad_all_), &buffer, &offset);
+
+    if (NULL == quad_data)
+    {
+        return;
+    }
+
+    memcpy(quad_data, quad_all_, sizeof(*quad_all_) * quad_count_);
+
+    const uint32_t instance_first = (uint32_t)(offset / sizeof(*quad_all_));
+
+    const size_t draw_count = spore_vector_size(renderer->draw_vec);
+
+    if (0 != draw_count && !canvas_vulkan_timestamp_region_boundary_is(renderer, draw_count))
+    {
+        CNVX_Renderer_Draw_PRIVATE* const draw_last = SPRX_VECTOR_AT(renderer->draw_vec, draw_count - 1, CNVX_Renderer_Draw_PRIVATE);
+
+        //instances that directly follow the previous batch extend it
+        if (variant == draw_last->variant && buffer == draw_last->buffer && renderer->vk.uniform_draw_offset == draw_last->uniform_offset && draw_last->instance_first + draw_last->instance_count == instance_first)
+        {
+            draw_last->instance_count += (uint32_t)quad_count_;
+            return;
+        }
+    }
+
+    CNVX_Renderer_Draw_PRIVATE draw;
+    draw.pipeline = CNVX_RENDERER_PIPELINE_QUAD;
+    draw.variant = variant;
+    draw.buffer = buffer;
+    draw.index_buffer = VK_NULL_HANDLE; //bound together with the quad corners
+    draw.vertex_first = 0;
+    draw.vertex_count = 4;
+    draw.index_first = 0;
+    draw.index_count = CNVX_VULKAN_QUAD_INDEX_COUNT;
+    draw.instance_first = instance_first;
+    draw.instance_count = (uint32_t)quad_count_;
+    draw.uniform_offset = renderer->vk.uniform_draw_offset;
+
+    //quads carry their texture index per instance
+    memset(&draw.push_constant, 0, sizeof(draw.push_constant));
+
+    spore_vector_push_back_grow(renderer->draw_vec, CNVX_RENDERER_DRAW_GROWTH, &draw);
 }
+
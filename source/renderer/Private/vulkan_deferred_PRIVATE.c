@@ -0,0 +1,269 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_descriptor_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/container/vector.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+#include "sprx/thread/mutex.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+void canvas_vulkan_deferred_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: deferred creation");
+
+    renderer->vk.deferred_mutex = spore_mutex_new();
+    renderer->vk.deferred_vec = spore_vector_new_c(sizeof(CNVX_Vulkan_Deferred_PRIVATE), CNVX_VULKAN_DEFERRED_GROWTH);
+    renderer->vk.deferred_spare_vec = spore_vector_new_c(sizeof(CNVX_Vulkan_Deferred_PRIVATE), CNVX_VULKAN_DEFERRED_GROWTH);
+}
+
+void canvas_vulkan_deferred_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_deferred_collect(renderer, true);
+
+    spore_vector_delete(renderer->vk.deferred_spare_vec);
+    spore_vector_delete(renderer->vk.deferred_vec);
+    spore_mutex_delete(renderer->vk.deferred_mutex);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: deferred destruction");
+}
+
+void canvas_vulkan_deferred_push_PRIVATE(void* const renderer_, CNVX_Vulkan_Deferred_PRIVATE* const deferred_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != deferred_, CNVX_VULKAN_ERROR_NULL("deferred"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.deferred_mutex);
+
+    //only submissions up to now can reference the object
+    memcpy(deferred_->frame_serial_all, renderer->vk.frame_serial_submitted_all, sizeof(deferred_->frame_serial_all));
+
+    spore_vector_push_back_grow(renderer->vk.deferred_vec, CNVX_VULKAN_DEFERRED_GROWTH, deferred_);
+
+    spore_mutex_unlock(renderer->vk.deferred_mutex);
+}
+
+void canvas_vulkan_deferred_buffer_release(void* const renderer_, const VkBuffer buffer_, const CNVX_Vulkan_Allocation_PRIVATE* const allocation_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_BUFFER;
+    deferred.buffer = buffer_;
+    deferred.allocation_is = NULL != allocation_;
+
+    if (deferred.allocation_is)
+    {
+        deferred.allocation = *allocation_;
+    }
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_image_release(void* const renderer_, const VkImage image_, const CNVX_Vulkan_Allocation_PRIVATE* const allocation_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_IMAGE;
+    deferred.image = image_;
+    deferred.allocation_is = NULL != allocation_;
+
+    if (deferred.allocation_is)
+    {
+        deferred.allocation = *allocation_;
+    }
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_image_view_release(void* const renderer_, const VkImageView image_view_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_IMAGE_VIEW;
+    deferred.image_view = image_view_;
+    deferred.allocation_is = false;
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_framebuffer_release(void* const renderer_, const VkFramebuffer framebuffer_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_FRAMEBUFFER;
+    deferred.framebuffer = framebuffer_;
+    deferred.allocation_is = false;
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_pipeline_release(void* const renderer_, const VkPipeline pipeline_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_PIPELINE;
+    deferred.pipeline = pipeline_;
+    deferred.allocation_is = false;
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_semaphore_release(void* const renderer_, const VkSemaphore semaphore_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_SEMAPHORE;
+    deferred.semaphore = semaphore_;
+    deferred.allocation_is = false;
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_swapchain_release(void* const renderer_, const VkSwapchainKHR swapchain_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_SWAPCHAIN;
+    deferred.swapchain = swapchain_;
+    deferred.allocation_is = false;
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_descriptor_release(void* const renderer_, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding_, const uint32_t index_)
+{
+    CNVX_Vulkan_Deferred_PRIVATE deferred;
+    deferred.type = CNVX_VULKAN_DEFERRED_TYPE_DESCRIPTOR;
+    deferred.descriptor_binding = binding_;
+    deferred.descriptor_index = index_;
+    deferred.allocation_is = false;
+
+    canvas_vulkan_deferred_push_PRIVATE(renderer_, &deferred);
+}
+
+void canvas_vulkan_deferred_object_destroy_PRIVATE(void* const renderer_, CNVX_Vulkan_Deferred_PRIVATE* const deferred_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != deferred_, CNVX_VULKAN_ERROR_NULL("deferred"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    switch (deferred_->type)
+    {
+    case CNVX_VULKAN_DEFERRED_TYPE_BUFFER:
+        vkDestroyBuffer(renderer->vk.device, deferred_->buffer, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_IMAGE:
+        vkDestroyImage(renderer->vk.device, deferred_->image, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_IMAGE_VIEW:
+        vkDestroyImageView(renderer->vk.device, deferred_->image_view, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_FRAMEBUFFER:
+        vkDestroyFramebuffer(renderer->vk.device, deferred_->framebuffer, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_PIPELINE:
+        vkDestroyPipeline(renderer->vk.device, deferred_->pipeline, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_SEMAPHORE:
+        vkDestroySemaphore(renderer->vk.device, deferred_->semaphore, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_SWAPCHAIN:
+        vkDestroySwapchainKHR(renderer->vk.device, deferred_->swapchain, NULL);
+        break;
+    case CNVX_VULKAN_DEFERRED_TYPE_DESCRIPTOR:
+        canvas_vulkan_descriptor_free(renderer, deferred_->descriptor_binding, deferred_->descriptor_index);
+        break;
+    default:
+        SPRX_ASSERT(false, CNVX_VULKAN_ERROR_LOGIC("failed to destroy deferred object", "unknown type", NULL));
+    }
+
+    if (deferred_->allocation_is)
+    {
+        canvas_vulkan_memory_free(renderer, &deferred_->allocation);
+    }
+}
+
+void canvas_vulkan_deferred_collect(void* const renderer_, const bool all_is)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.deferred_mutex);
+
+    const size_t count = spore_vector_size(renderer->vk.deferred_vec);
+    size_t destroyed_count = 0;
+
+    //survivors move to the spare vector, which then takes the place of the queue
+    for (size_t i = 0; i < count; i++)
+    {
+        CNVX_Vulkan_Deferred_PRIVATE* const deferred = SPRX_VECTOR_AT(renderer->vk.deferred_vec, i, CNVX_Vulkan_Deferred_PRIVATE);
+
+        bool done_is = true;
+
+        for (uint32_t k = 0; k < renderer->vk.frame_count && !all_is; k++)
+        {
+            done_is = done_is && renderer->vk.frame_serial_done_all[k] >= deferred->frame_serial_all[k];
+        }
+
+        if (done_is)
+        {
+            canvas_vulkan_deferred_object_destroy_PRIVATE(renderer, deferred);
+
+            destroyed_count++;
+        }
+        else
+        {
+            spore_vector_push_back_grow(renderer->vk.deferred_spare_vec, CNVX_VULKAN_DEFERRED_GROWTH, deferred);
+        }
+    }
+
+    if (0 != destroyed_count)
+    {
+        void* const deferred_vec = renderer->vk.deferred_vec;
+        renderer->vk.deferred_vec = renderer->vk.deferred_spare_vec;
+        renderer->vk.deferred_spare_vec = deferred_vec;
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: destroyed %llu deferred objects, %llu pending", (unsigned long long)destroyed_count, (unsigned long long)(count - destroyed_count));
+    }
+
+    spore_vector_clear_reserve(renderer->vk.deferred_spare_vec, CNVX_VULKAN_DEFERRED_GROWTH);
+
+    spore_mutex_unlock(renderer->vk.deferred_mutex);
+}
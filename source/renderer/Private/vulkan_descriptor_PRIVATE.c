@@ -0,0 +1,423 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_descriptor_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/container/vector.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+#include "sprx/thread/mutex.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+VkDescriptorPool canvas_vulkan_descriptor_frame_pool_create_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //generous for the few set shapes used per frame, exhaustion just chains another pool
+    const VkDescriptorPoolSize descriptor_pool_size_all[] = {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, CNVX_VULKAN_DESCRIPTOR_FRAME_SET_COUNT },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, CNVX_VULKAN_DESCRIPTOR_FRAME_SET_COUNT },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, CNVX_VULKAN_DESCRIPTOR_FRAME_SET_COUNT },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, CNVX_VULKAN_DESCRIPTOR_FRAME_SET_COUNT },
+    };
+
+    VkDescriptorPoolCreateInfo descriptor_pool_create_info;
+    descriptor_pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.pNext = NULL;
+    descriptor_pool_create_info.flags = 0;
+    descriptor_pool_create_info.maxSets = CNVX_VULKAN_DESCRIPTOR_FRAME_SET_COUNT;
+    descriptor_pool_create_info.poolSizeCount = sizeof(descriptor_pool_size_all) / sizeof(*descriptor_pool_size_all);
+    descriptor_pool_create_info.pPoolSizes = descriptor_pool_size_all;
+
+    VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
+
+    VkResult result = vkCreateDescriptorPool(renderer->vk.device, &descriptor_pool_create_info, NULL, &descriptor_pool);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDescriptorPool frame");
+
+    return descriptor_pool;
+}
+
+void canvas_vulkan_descriptor_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: descriptor creation");
+
+    VkPhysicalDeviceVulkan12Properties physical_device_vulkan12_properties;
+    memset(&physical_device_vulkan12_properties, 0, sizeof(physical_device_vulkan12_properties));
+    physical_device_vulkan12_properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES;
+
+    VkPhysicalDeviceProperties2 physical_device_properties2;
+    physical_device_properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    physical_device_properties2.pNext = &physical_device_vulkan12_properties;
+
+    vkGetPhysicalDeviceProperties2(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], &physical_device_properties2);
+
+    renderer->vk.descriptor_count_all[CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE] = SPRX_MIN(SPRX_MIN(physical_device_vulkan12_properties.maxDescriptorSetUpdateAfterBindSampledImages, physical_device_vulkan12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages), CNVX_VULKAN_DESCRIPTOR_TEXTURE_COUNT_MAX);
+    renderer->vk.descriptor_count_all[CNVX_VULKAN_DESCRIPTOR_BINDING_BUFFER] = SPRX_MIN(SPRX_MIN(physical_device_vulkan12_properties.maxDescriptorSetUpdateAfterBindStorageBuffers, physical_device_vulkan12_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers), CNVX_VULKAN_DESCRIPTOR_BUFFER_COUNT_MAX);
+
+    const VkDescriptorType descriptor_type_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX] = { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER };
+
+    VkDescriptorSetLayoutBinding descriptor_set_layout_binding_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX];
+    VkDescriptorBindingFlags descriptor_binding_flags_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX];
+    VkDescriptorPoolSize descriptor_pool_size_all[___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX];
+
+    for (uint32_t i = 0; i < ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX; i++)
+    {
+        descriptor_set_layout_binding_all[i].binding = i;
+        descriptor_set_layout_binding_all[i].descriptorType = descriptor_type_all[i];
+        descriptor_set_layout_binding_all[i].descriptorCount = renderer->vk.descriptor_count_all[i];
+        descriptor_set_layout_binding_all[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        descriptor_set_layout_binding_all[i].pImmutableSamplers = NULL;
+
+        //unregistered slots stay empty and registering never waits for frames in flight
+        descriptor_binding_flags_all[i] = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+
+        descriptor_pool_size_all[i].type = descriptor_type_all[i];
+        descriptor_pool_size_all[i].descriptorCount = renderer->vk.descriptor_count_all[i];
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: bindless binding %u holds %u descriptors", i, renderer->vk.descriptor_count_all[i]);
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo descriptor_set_layout_binding_flags_create_info;
+    descriptor_set_layout_binding_flags_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO;
+    descriptor_set_layout_binding_flags_create_info.pNext = NULL;
+    descriptor_set_layout_binding_flags_create_info.bindingCount = ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX;
+    descriptor_set_layout_binding_flags_create_info.pBindingFlags = descriptor_binding_flags_all;
+
+    VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info;
+    descriptor_set_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptor_set_layout_create_info.pNext = &descriptor_set_layout_binding_flags_create_info;
+    descriptor_set_layout_create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    descriptor_set_layout_create_info.bindingCount = ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX;
+    descriptor_set_layout_create_info.pBindings = descriptor_set_layout_binding_all;
+
+    VkResult result = vkCreateDescriptorSetLayout(renderer->vk.device, &descriptor_set_layout_create_info, NULL, &renderer->vk.descriptor_set_layout);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDescriptorSetLayout");
+
+    VkDescriptorPoolCreateInfo descriptor_pool_create_info;
+    descriptor_pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.pNext = NULL;
+    descriptor_pool_create_info.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    descriptor_pool_create_info.maxSets = 1;
+    descriptor_pool_create_info.poolSizeCount = ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX;
+    descriptor_pool_create_info.pPoolSizes = descriptor_pool_size_all;
+
+    result = vkCreateDescriptorPool(renderer->vk.device, &descriptor_pool_create_info, NULL, &renderer->vk.descriptor_pool);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDescriptorPool");
+
+    VkDescriptorSetAllocateInfo descriptor_set_allocate_info;
+    descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptor_set_allocate_info.pNext = NULL;
+    descriptor_set_allocate_info.descriptorPool = renderer->vk.descriptor_pool;
+    descriptor_set_allocate_info.descriptorSetCount = 1;
+    descriptor_set_allocate_info.pSetLayouts = &renderer->vk.descriptor_set_layout;
+
+    result = vkAllocateDescriptorSets(renderer->vk.device, &descriptor_set_allocate_info, &renderer->vk.descriptor_set);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkAllocateDescriptorSets");
+
+    //free slots are popped from the back, so low indices are handed out first
+    for (uint32_t i = 0; i < ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX; i++)
+    {
+        renderer->vk.descriptor_free_all[i] = malloc(sizeof(*renderer->vk.descriptor_free_all[i]) * SPRX_MAX(renderer->vk.descriptor_count_all[i], 1));
+        SPRX_ASSERT(NULL != renderer->vk.descriptor_free_all[i], CNVX_VULKAN_ERROR_ALLOCATION);
+
+        for (uint32_t k = 0; k < renderer->vk.descriptor_count_all[i]; k++)
+        {
+            renderer->vk.descriptor_free_all[i][k] = renderer->vk.descriptor_count_all[i] - 1 - k;
+        }
+
+        renderer->vk.descriptor_free_count_all[i] = renderer->vk.descriptor_count_all[i];
+    }
+
+    renderer->vk.descriptor_mutex = spore_mutex_new();
+
+    VkSamplerCreateInfo sampler_create_info;
+    sampler_create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_create_info.pNext = NULL;
+    sampler_create_info.flags = 0;
+    sampler_create_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_create_info.mipLodBias = 0.0f;
+    sampler_create_info.anisotropyEnable = VK_FALSE;
+    sampler_create_info.maxAnisotropy = 1.0f;
+    sampler_create_info.compareEnable = VK_FALSE;
+    sampler_create_info.compareOp = VK_COMPARE_OP_ALWAYS;
+    sampler_create_info.minLod = 0.0f;
+    sampler_create_info.maxLod = VK_LOD_CLAMP_NONE;
+    sampler_create_info.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
+    sampler_create_info.unnormalizedCoordinates = VK_FALSE;
+
+    for (uint32_t i = 0; i < ___CNVX_VULKAN_DESCRIPTOR_SAMPLER_MAX; i++)
+    {
+        const bool linear_is = CNVX_VULKAN_DESCRIPTOR_SAMPLER_LINEAR == i;
+
+        sampler_create_info.magFilter = linear_is ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+        sampler_create_info.minFilter = linear_is ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+        sampler_create_info.mipmapMode = linear_is ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+
+        result = vkCreateSampler(renderer->vk.device, &sampler_create_info, NULL, &renderer->vk.descriptor_sampler_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateSampler (%u/%u)", i + 1, ___CNVX_VULKAN_DESCRIPTOR_SAMPLER_MAX);
+    }
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        renderer->vk.descriptor_frame_pool_vec_all[i] = spore_vector_new_c(sizeof(VkDescriptorPool), CNVX_VULKAN_DESCRIPTOR_FRAME_POOL_GROWTH);
+        renderer->vk.descriptor_frame_pool_index_all[i] = 0;
+
+        const VkDescriptorPool descriptor_pool = canvas_vulkan_descriptor_frame_pool_create_PRIVATE(renderer);
+        spore_vector_push_back_grow(renderer->vk.descriptor_frame_pool_vec_all[i], CNVX_VULKAN_DESCRIPTOR_FRAME_POOL_GROWTH, &descriptor_pool);
+    }
+}
+
+void canvas_vulkan_descriptor_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        const size_t pool_count = spore_vector_size(renderer->vk.descriptor_frame_pool_vec_all[i]);
+
+        for (size_t k = 0; k < pool_count; k++)
+        {
+            vkDestroyDescriptorPool(renderer->vk.device, *SPRX_VECTOR_AT(renderer->vk.descriptor_frame_pool_vec_all[i], k, VkDescriptorPool), NULL);
+        }
+
+        spore_vector_delete(renderer->vk.descriptor_frame_pool_vec_all[i]);
+    }
+
+    for (uint32_t i = 0; i < ___CNVX_VULKAN_DESCRIPTOR_SAMPLER_MAX; i++)
+    {
+        vkDestroySampler(renderer->vk.device, renderer->vk.descriptor_sampler_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySampler (%u/%u)", i + 1, ___CNVX_VULKAN_DESCRIPTOR_SAMPLER_MAX);
+    }
+
+    spore_mutex_delete(renderer->vk.descriptor_mutex);
+
+    for (uint32_t i = 0; i < ___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX; i++)
+    {
+        if (renderer->vk.descriptor_free_count_all[i] != renderer->vk.descriptor_count_all[i])
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: %u descriptors of binding %u were never released", renderer->vk.descriptor_count_all[i] - renderer->vk.descriptor_free_count_all[i], i);
+        }
+
+        free(renderer->vk.descriptor_free_all[i]);
+    }
+
+    //destroying the pool frees the set
+    vkDestroyDescriptorPool(renderer->vk.device, renderer->vk.descriptor_pool, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyDescriptorPool");
+
+    vkDestroyDescriptorSetLayout(renderer->vk.device, renderer->vk.descriptor_set_layout, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyDescriptorSetLayout");
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: descriptor destruction");
+}
+
+uint32_t canvas_vulkan_descriptor_slot_take_PRIVATE(void* const renderer_, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.descriptor_mutex);
+
+    SPRX_ASSERT(0 != renderer->vk.descriptor_free_count_all[binding_], CNVX_VULKAN_ERROR_LOGIC("failed to register descriptor", "all slots of the binding are in use", NULL));
+
+    const uint32_t index = renderer->vk.descriptor_free_all[binding_][--renderer->vk.descriptor_free_count_all[binding_]];
+
+    spore_mutex_unlock(renderer->vk.descriptor_mutex);
+
+    return index;
+}
+
+uint32_t canvas_vulkan_descriptor_texture_register(void* const renderer_, const VkImageView image_view_, const VkImageLayout layout_, const VkSampler sampler_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t index = canvas_vulkan_descriptor_slot_take_PRIVATE(renderer, CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE);
+
+    VkDescriptorImageInfo descriptor_image_info;
+    descriptor_image_info.sampler = sampler_;
+    descriptor_image_info.imageView = image_view_;
+    descriptor_image_info.imageLayout = layout_;
+
+    VkWriteDescriptorSet write_descriptor_set;
+    write_descriptor_set.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write_descriptor_set.pNext = NULL;
+    write_descriptor_set.dstSet = renderer->vk.descriptor_set;
+    write_descriptor_set.dstBinding = CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE;
+    write_descriptor_set.dstArrayElement = index;
+    write_descriptor_set.descriptorCount = 1;
+    write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write_descriptor_set.pImageInfo = &descriptor_image_info;
+    write_descriptor_set.pBufferInfo = NULL;
+    write_descriptor_set.pTexelBufferView = NULL;
+
+    //update after bind allows this while frames in flight use other slots of the set
+    vkUpdateDescriptorSets(renderer->vk.device, 1, &write_descriptor_set, 0, NULL);
+
+    return index;
+}
+
+uint32_t canvas_vulkan_descriptor_buffer_register(void* const renderer_, const VkBuffer buffer_, const VkDeviceSize offset_, const VkDeviceSize range_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t index = canvas_vulkan_descriptor_slot_take_PRIVATE(renderer, CNVX_VULKAN_DESCRIPTOR_BINDING_BUFFER);
+
+    VkDescriptorBufferInfo descriptor_buffer_info;
+    descriptor_buffer_info.buffer = buffer_;
+    descriptor_buffer_info.offset = offset_;
+    descriptor_buffer_info.range = range_;
+
+    VkWriteDescriptorSet write_descriptor_set;
+    write_descriptor_set.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    write_descriptor_set.pNext = NULL;
+    write_descriptor_set.dstSet = renderer->vk.descriptor_set;
+    write_descriptor_set.dstBinding = CNVX_VULKAN_DESCRIPTOR_BINDING_BUFFER;
+    write_descriptor_set.dstArrayElement = index;
+    write_descriptor_set.descriptorCount = 1;
+    write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    write_descriptor_set.pImageInfo = NULL;
+    write_descriptor_set.pBufferInfo = &descriptor_buffer_info;
+    write_descriptor_set.pTexelBufferView = NULL;
+
+    vkUpdateDescriptorSets(renderer->vk.device, 1, &write_descriptor_set, 0, NULL);
+
+    return index;
+}
+
+void canvas_vulkan_descriptor_release(void* const renderer_, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding_, const uint32_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(___CNVX_VULKAN_DESCRIPTOR_BINDING_MAX > binding_, CNVX_VULKAN_ERROR_ARGUMENT("invalid value of binding"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.descriptor_count_all[binding_] > index_, CNVX_VULKAN_ERROR_ARGUMENT("index has to be <descriptor count of the binding"));
+
+    canvas_vulkan_deferred_descriptor_release(renderer, binding_, index_);
+}
+
+void canvas_vulkan_descriptor_free(void* const renderer_, const CNVX_Vulkan_Descriptor_Binding_PRIVATE binding_, const uint32_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //the stale descriptor stays in the set, partially bound makes that harmless
+    spore_mutex_lock(renderer->vk.descriptor_mutex);
+    renderer->vk.descriptor_free_all[binding_][renderer->vk.descriptor_free_count_all[binding_]++] = index_;
+    spore_mutex_unlock(renderer->vk.descriptor_mutex);
+}
+
+void canvas_vulkan_descriptor_bind(void* const renderer_, const VkCommandBuffer commandbuffer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    vkCmdBindDescriptorSets(commandbuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->vk.pipeline_layout, 0, 1, &renderer->vk.descriptor_set, 0, NULL);
+}
+
+VkDescriptorSet canvas_vulkan_descriptor_frame_allocate(void* const renderer_, const VkDescriptorSetLayout layout_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    void* const pool_vec = renderer->vk.descriptor_frame_pool_vec_all[renderer->vk.frame_index];
+    uint32_t* const pool_index = &renderer->vk.descriptor_frame_pool_index_all[renderer->vk.frame_index];
+
+    VkDescriptorSetAllocateInfo descriptor_set_allocate_info;
+    descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptor_set_allocate_info.pNext = NULL;
+    descriptor_set_allocate_info.descriptorSetCount = 1;
+    descriptor_set_allocate_info.pSetLayouts = &layout_;
+
+    VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+
+    while (true)
+    {
+        descriptor_set_allocate_info.descriptorPool = *SPRX_VECTOR_AT(pool_vec, *pool_index, VkDescriptorPool);
+
+        const VkResult result = vkAllocateDescriptorSets(renderer->vk.device, &descriptor_set_allocate_info, &descriptor_set);
+
+        if (VK_ERROR_OUT_OF_POOL_MEMORY != result && VK_ERROR_FRAGMENTED_POOL != result)
+        {
+            CNVX_VULKAN_QASSERT(renderer, result, "vkAllocateDescriptorSets frame");
+            break;
+        }
+
+        //the exhausted pool stays in the chain and is reset with the others
+        if (++*pool_index == spore_vector_size(pool_vec))
+        {
+            const VkDescriptorPool descriptor_pool = canvas_vulkan_descriptor_frame_pool_create_PRIVATE(renderer);
+            spore_vector_push_back_grow(pool_vec, CNVX_VULKAN_DESCRIPTOR_FRAME_POOL_GROWTH, &descriptor_pool);
+
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: frame %u chains descriptor pool %u", renderer->vk.frame_index, *pool_index + 1);
+        }
+    }
+
+    return descriptor_set;
+}
+
+void canvas_vulkan_descriptor_frame_reset(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    void* const pool_vec = renderer->vk.descriptor_frame_pool_vec_all[renderer->vk.frame_index];
+
+    //pools beyond the index were never touched since the last reset
+    for (uint32_t i = 0; i <= renderer->vk.descriptor_frame_pool_index_all[renderer->vk.frame_index]; i++)
+    {
+        const VkResult result = vkResetDescriptorPool(renderer->vk.device, *SPRX_VECTOR_AT(pool_vec, i, VkDescriptorPool), 0);
+        CNVX_VULKAN_QASSERT(renderer, result, "vkResetDescriptorPool");
+    }
+
+    renderer->vk.descriptor_frame_pool_index_all[renderer->vk.frame_index] = 0;
+}
@@ -0,0 +1,581 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_graph_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+typedef struct CNVX_Vulkan_Graph_Access_Info_PRIVATE
+{
+    VkImageLayout layout;
+    VkPipelineStageFlags stage;
+    VkAccessFlags access;
+    VkImageUsageFlags usage;
+    bool write_is;
+} CNVX_Vulkan_Graph_Access_Info_PRIVATE;
+
+CNVX_Vulkan_Graph_Access_Info_PRIVATE canvas_vulkan_graph_access_info_get_PRIVATE(const CNVX_Vulkan_Graph_Access_Type_PRIVATE type_)
+{
+    switch (type_)
+    {
+    case CNVX_VULKAN_GRAPH_ACCESS_TYPE_COLOR_WRITE:
+        return (CNVX_Vulkan_Graph_Access_Info_PRIVATE){ VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, true };
+    case CNVX_VULKAN_GRAPH_ACCESS_TYPE_SAMPLED_READ:
+        return (CNVX_Vulkan_Graph_Access_Info_PRIVATE){ VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_USAGE_SAMPLED_BIT, false };
+    case CNVX_VULKAN_GRAPH_ACCESS_TYPE_TRANSFER_READ:
+        return (CNVX_Vulkan_Graph_Access_Info_PRIVATE){ VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_IMAGE_USAGE_TRANSFER_SRC_BIT, false };
+    case CNVX_VULKAN_GRAPH_ACCESS_TYPE_TRANSFER_WRITE:
+        return (CNVX_Vulkan_Graph_Access_Info_PRIVATE){ VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_IMAGE_USAGE_TRANSFER_DST_BIT, true };
+    default:
+        SPRX_ASSERT(false, CNVX_VULKAN_ERROR_ARGUMENT("type has to be <___CNVX_VULKAN_GRAPH_ACCESS_TYPE_MAX"));
+    }
+
+    return (CNVX_Vulkan_Graph_Access_Info_PRIVATE){ VK_IMAGE_LAYOUT_UNDEFINED, 0, 0, 0, false };
+}
+
+void canvas_vulkan_graph_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: graph creation");
+
+    memset(&renderer->vk.graph, 0, sizeof(renderer->vk.graph));
+}
+
+void canvas_vulkan_graph_release_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    bool allocation_released_is = false;
+
+    for (uint32_t i = 0; i < graph->resource_count; i++)
+    {
+        CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[i];
+
+        if (resource->imported_is || VK_NULL_HANDLE == resource->image)
+        {
+            continue;
+        }
+
+        canvas_vulkan_deferred_image_view_release(renderer, resource->image_view);
+
+        //the shared block goes with the first image, the others are destroyed in the same collection
+        canvas_vulkan_deferred_image_release(renderer, resource->image, allocation_released_is ? NULL : &graph->allocation);
+        allocation_released_is = true;
+
+        resource->image = VK_NULL_HANDLE;
+        resource->image_view = VK_NULL_HANDLE;
+    }
+
+    graph->allocation_is = false;
+}
+
+void canvas_vulkan_graph_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_graph_release_PRIVATE(renderer);
+
+    renderer->vk.graph.pass_count = 0;
+    renderer->vk.graph.resource_count = 0;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: graph destruction");
+}
+
+uint32_t canvas_vulkan_graph_resource_add_PRIVATE(void* const renderer_, const VkFormat format_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    SPRX_ASSERT(CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX > graph->resource_count, CNVX_VULKAN_ERROR_LOGIC("failed to add graph resource", "CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX reached", NULL));
+
+    const uint32_t index = graph->resource_count++;
+
+    CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[index];
+    memset(resource, 0, sizeof(*resource));
+    resource->format = format_;
+    resource->pass_first = UINT32_MAX;
+
+    return index;
+}
+
+uint32_t canvas_vulkan_graph_image_import(void* const renderer_, const VkFormat format_, const VkPipelineStageFlags stage_initial_, const VkImageLayout layout_final_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t index = canvas_vulkan_graph_resource_add_PRIVATE(renderer, format_);
+
+    CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &renderer->vk.graph.resource_all[index];
+    resource->imported_is = true;
+    resource->stage_initial = stage_initial_;
+    resource->layout_final = layout_final_;
+
+    return index;
+}
+
+void canvas_vulkan_graph_image_bind(void* const renderer_, const uint32_t resource_, const VkImage image_, const VkImageView image_view_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.graph.resource_count > resource_, CNVX_VULKAN_ERROR_ARGUMENT("resource has to be <resource count"));
+    SPRX_ASSERT(renderer->vk.graph.resource_all[resource_].imported_is, CNVX_VULKAN_ERROR_ARGUMENT("resource has to be imported"));
+
+    renderer->vk.graph.resource_all[resource_].image = image_;
+    renderer->vk.graph.resource_all[resource_].image_view = image_view_;
+}
+
+uint32_t canvas_vulkan_graph_image_transient(void* const renderer_, const VkFormat format_, const uint32_t width_, const uint32_t height_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t index = canvas_vulkan_graph_resource_add_PRIVATE(renderer, format_);
+
+    CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &renderer->vk.graph.resource_all[index];
+    resource->width = width_;
+    resource->height = height_;
+
+    return index;
+}
+
+void canvas_vulkan_graph_image_get(void* const renderer_, const uint32_t resource_, VkImage* const image_, VkImageView* const image_view_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.graph.resource_count > resource_, CNVX_VULKAN_ERROR_ARGUMENT("resource has to be <resource count"));
+
+    if (NULL != image_)
+    {
+        *image_ = renderer->vk.graph.resource_all[resource_].image;
+    }
+
+    if (NULL != image_view_)
+    {
+        *image_view_ = renderer->vk.graph.resource_all[resource_].image_view;
+    }
+}
+
+uint32_t canvas_vulkan_graph_pass_add(void* const renderer_, const char* const name_, const CNVX_Vulkan_Graph_Record_PRIVATE record_, void* const data_, const bool side_effect_is_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != name_, CNVX_VULKAN_ERROR_NULL("name"));
+    SPRX_ASSERT(NULL != record_, CNVX_VULKAN_ERROR_NULL("record"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    SPRX_ASSERT(CNVX_VULKAN_GRAPH_PASS_COUNT_MAX > graph->pass_count, CNVX_VULKAN_ERROR_LOGIC("failed to add graph pass", "CNVX_VULKAN_GRAPH_PASS_COUNT_MAX reached", NULL));
+
+    const uint32_t index = graph->pass_count++;
+
+    CNVX_Vulkan_Graph_Pass_PRIVATE* const pass = &graph->pass_all[index];
+    pass->name = name_;
+    pass->record = record_;
+    pass->data = data_;
+    pass->enabled_is = true;
+    pass->side_effect_is = side_effect_is_;
+    pass->alive_is = false;
+    pass->access_count = 0;
+
+    return index;
+}
+
+void canvas_vulkan_graph_pass_access_add(void* const renderer_, const uint32_t pass_, const uint32_t resource_, const CNVX_Vulkan_Graph_Access_Type_PRIVATE type_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(___CNVX_VULKAN_GRAPH_ACCESS_TYPE_MAX > type_, CNVX_VULKAN_ERROR_ARGUMENT("type has to be <___CNVX_VULKAN_GRAPH_ACCESS_TYPE_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    SPRX_ASSERT(graph->pass_count > pass_, CNVX_VULKAN_ERROR_ARGUMENT("pass has to be <pass count"));
+    SPRX_ASSERT(graph->resource_count > resource_, CNVX_VULKAN_ERROR_ARGUMENT("resource has to be <resource count"));
+
+    CNVX_Vulkan_Graph_Pass_PRIVATE* const pass = &graph->pass_all[pass_];
+    CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[resource_];
+
+    SPRX_ASSERT(CNVX_VULKAN_GRAPH_ACCESS_COUNT_MAX > pass->access_count, CNVX_VULKAN_ERROR_LOGIC("failed to add graph access", "CNVX_VULKAN_GRAPH_ACCESS_COUNT_MAX reached", NULL));
+
+    pass->access_all[pass->access_count].resource = resource_;
+    pass->access_all[pass->access_count].type = type_;
+    pass->access_count++;
+
+    resource->usage |= canvas_vulkan_graph_access_info_get_PRIVATE(type_).usage;
+    resource->pass_first = SPRX_MIN(resource->pass_first, pass_);
+    resource->pass_last = SPRX_MAX(resource->pass_last, pass_);
+}
+
+void canvas_vulkan_graph_pass_enable(void* const renderer_, const uint32_t pass_, const bool enabled_is_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.graph.pass_count > pass_, CNVX_VULKAN_ERROR_ARGUMENT("pass has to be <pass count"));
+
+    renderer->vk.graph.pass_all[pass_].enabled_is = enabled_is_;
+}
+
+void canvas_vulkan_graph_allocate(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    //frames in flight keep the old images until their fences signaled
+    canvas_vulkan_graph_release_PRIVATE(renderer);
+
+    uint32_t transient_all[CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX];
+    uint32_t transient_count = 0;
+    VkMemoryRequirements memory_requirements_all[CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX];
+
+    for (uint32_t i = 0; i < graph->resource_count; i++)
+    {
+        CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[i];
+
+        //images no pass touches are never created
+        if (resource->imported_is || UINT32_MAX == resource->pass_first)
+        {
+            continue;
+        }
+
+        VkImageCreateInfo image_create_info;
+        image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        image_create_info.pNext = NULL;
+        image_create_info.flags = 0;
+        image_create_info.imageType = VK_IMAGE_TYPE_2D;
+        image_create_info.format = resource->format;
+        image_create_info.extent.width = 0 != resource->width ? resource->width : (uint32_t)renderer->width;
+        image_create_info.extent.height = 0 != resource->height ? resource->height : (uint32_t)renderer->height;
+        image_create_info.extent.depth = 1;
+        image_create_info.mipLevels = 1;
+        image_create_info.arrayLayers = 1;
+        image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+        image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+        image_create_info.usage = resource->usage;
+        image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        image_create_info.queueFamilyIndexCount = 0;
+        image_create_info.pQueueFamilyIndices = NULL;
+        image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkResult result = vkCreateImage(renderer->vk.device, &image_create_info, NULL, &resource->image);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateImage graph (%u)", i);
+
+        vkGetImageMemoryRequirements(renderer->vk.device, resource->image, &memory_requirements_all[transient_count]);
+
+        transient_all[transient_count++] = i;
+    }
+
+    if (0 == transient_count)
+    {
+        return;
+    }
+
+    //largest first, each image takes the lowest offset not overlapping an image alive at the same time
+    for (uint32_t i = 1; i < transient_count; i++)
+    {
+        for (uint32_t k = i; 0 < k && memory_requirements_all[k - 1].size < memory_requirements_all[k].size; k--)
+        {
+            const VkMemoryRequirements memory_requirements = memory_requirements_all[k];
+            memory_requirements_all[k] = memory_requirements_all[k - 1];
+            memory_requirements_all[k - 1] = memory_requirements;
+
+            const uint32_t transient = transient_all[k];
+            transient_all[k] = transient_all[k - 1];
+            transient_all[k - 1] = transient;
+        }
+    }
+
+    VkMemoryRequirements memory_requirements_block;
+    memory_requirements_block.size = 0;
+    memory_requirements_block.alignment = 1;
+    memory_requirements_block.memoryTypeBits = UINT32_MAX;
+
+    VkDeviceSize size_unaliased = 0;
+
+    for (uint32_t i = 0; i < transient_count; i++)
+    {
+        CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[transient_all[i]];
+        const VkMemoryRequirements* const memory_requirements = &memory_requirements_all[i];
+
+        VkDeviceSize offset = 0;
+        bool moved_is = true;
+
+        //every conflict moves the candidate behind it, offsets only grow so this ends
+        while (moved_is)
+        {
+            moved_is = false;
+
+            for (uint32_t k = 0; k < i; k++)
+            {
+                const CNVX_Vulkan_Graph_Resource_PRIVATE* const placed = &graph->resource_all[transient_all[k]];
+
+                const bool lifetime_overlap_is = placed->pass_first <= resource->pass_last && resource->pass_first <= placed->pass_last;
+                const bool memory_overlap_is = placed->alias_offset < offset + memory_requirements->size && offset < placed->alias_offset + memory_requirements_all[k].size;
+
+                if (lifetime_overlap_is && memory_overlap_is)
+                {
+                    offset = (placed->alias_offset + memory_requirements_all[k].size + memory_requirements->alignment - 1) & ~(memory_requirements->alignment - 1);
+                    moved_is = true;
+                }
+            }
+        }
+
+        resource->alias_offset = offset;
+
+        memory_requirements_block.size = SPRX_MAX(memory_requirements_block.size, offset + memory_requirements->size);
+        memory_requirements_block.alignment = SPRX_MAX(memory_requirements_block.alignment, memory_requirements->alignment);
+        memory_requirements_block.memoryTypeBits &= memory_requirements->memoryTypeBits;
+
+        size_unaliased += memory_requirements->size;
+    }
+
+    SPRX_ASSERT(0 != memory_requirements_block.memoryTypeBits, CNVX_VULKAN_ERROR_LOGIC("failed to allocate graph", "transient images share no memory type", NULL));
+
+    canvas_vulkan_memory_allocate(renderer, &memory_requirements_block, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, false, &graph->allocation);
+    graph->allocation_is = true;
+
+    for (uint32_t i = 0; i < transient_count; i++)
+    {
+        CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[transient_all[i]];
+
+        VkResult result = vkBindImageMemory(renderer->vk.device, resource->image, graph->allocation.memory, graph->allocation.offset + resource->alias_offset);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkBindImageMemory graph (%u)", transient_all[i]);
+
+        VkImageViewCreateInfo image_view_create_info;
+        image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        image_view_create_info.pNext = NULL;
+        image_view_create_info.flags = 0;
+        image_view_create_info.image = resource->image;
+        image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        image_view_create_info.format = resource->format;
+        image_view_create_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+        image_view_create_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+        image_view_create_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+        image_view_create_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+        image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        image_view_create_info.subresourceRange.baseMipLevel = 0;
+        image_view_create_info.subresourceRange.levelCount = 1;
+        image_view_create_info.subresourceRange.baseArrayLayer = 0;
+        image_view_create_info.subresourceRange.layerCount = 1;
+
+        result = vkCreateImageView(renderer->vk.device, &image_view_create_info, NULL, &resource->image_view);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateImageView graph (%u)", transient_all[i]);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: graph aliases %u transient images into %lluKiB instead of %lluKiB", transient_count, (unsigned long long)(memory_requirements_block.size >> 10), (unsigned long long)(size_unaliased >> 10));
+}
+
+void canvas_vulkan_graph_cull_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    for (uint32_t i = 0; i < graph->resource_count; i++)
+    {
+        graph->resource_all[i].needed_is = graph->resource_all[i].imported_is;
+    }
+
+    //backwards, so a pass is alive if a later alive pass reads what it writes
+    for (uint32_t i = graph->pass_count; 0 < i; i--)
+    {
+        CNVX_Vulkan_Graph_Pass_PRIVATE* const pass = &graph->pass_all[i - 1];
+
+        pass->alive_is = pass->enabled_is && pass->side_effect_is;
+
+        for (uint32_t k = 0; k < pass->access_count && pass->enabled_is && !pass->alive_is; k++)
+        {
+            const CNVX_Vulkan_Graph_Access_PRIVATE* const access = &pass->access_all[k];
+
+            pass->alive_is = canvas_vulkan_graph_access_info_get_PRIVATE(access->type).write_is && graph->resource_all[access->resource].needed_is;
+        }
+
+        if (!pass->alive_is)
+        {
+            continue;
+        }
+
+        for (uint32_t k = 0; k < pass->access_count; k++)
+        {
+            const CNVX_Vulkan_Graph_Access_PRIVATE* const access = &pass->access_all[k];
+
+            if (!canvas_vulkan_graph_access_info_get_PRIVATE(access->type).write_is)
+            {
+                graph->resource_all[access->resource].needed_is = true;
+            }
+        }
+    }
+}
+
+void canvas_vulkan_graph_execute(void* const renderer_, const VkCommandBuffer commandbuffer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Vulkan_Graph_PRIVATE* const graph = &renderer->vk.graph;
+
+    canvas_vulkan_graph_cull_PRIVATE(renderer);
+
+    //contents never survive a frame, transient images may share memory with one used before
+    for (uint32_t i = 0; i < graph->resource_count; i++)
+    {
+        CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[i];
+
+        resource->layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        resource->stage = resource->imported_is ? resource->stage_initial : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        resource->access = resource->imported_is ? 0 : VK_ACCESS_MEMORY_WRITE_BIT;
+        resource->written_is = !resource->imported_is;
+    }
+
+    VkImageMemoryBarrier image_memory_barrier_all[CNVX_VULKAN_GRAPH_RESOURCE_COUNT_MAX];
+
+    for (uint32_t i = 0; i < graph->pass_count; i++)
+    {
+        const CNVX_Vulkan_Graph_Pass_PRIVATE* const pass = &graph->pass_all[i];
+
+        if (!pass->alive_is)
+        {
+            continue;
+        }
+
+        uint32_t barrier_count = 0;
+        VkPipelineStageFlags stage_src = 0;
+        VkPipelineStageFlags stage_dst = 0;
+
+        for (uint32_t k = 0; k < pass->access_count; k++)
+        {
+            CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[pass->access_all[k].resource];
+            const CNVX_Vulkan_Graph_Access_Info_PRIVATE info = canvas_vulkan_graph_access_info_get_PRIVATE(pass->access_all[k].type);
+
+            //reads following reads in the same layout need nothing, they only join the readers
+            if (resource->layout == info.layout && !resource->written_is && !info.write_is)
+            {
+                resource->stage |= info.stage;
+                continue;
+            }
+
+            VkImageMemoryBarrier* const image_memory_barrier = &image_memory_barrier_all[barrier_count++];
+            image_memory_barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            image_memory_barrier->pNext = NULL;
+            image_memory_barrier->srcAccessMask = resource->written_is ? resource->access : 0;
+            image_memory_barrier->dstAccessMask = info.access;
+            image_memory_barrier->oldLayout = resource->layout;
+            image_memory_barrier->newLayout = info.layout;
+            image_memory_barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_memory_barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            image_memory_barrier->image = resource->image;
+            image_memory_barrier->subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            image_memory_barrier->subresourceRange.baseMipLevel = 0;
+            image_memory_barrier->subresourceRange.levelCount = 1;
+            image_memory_barrier->subresourceRange.baseArrayLayer = 0;
+            image_memory_barrier->subresourceRange.layerCount = 1;
+
+            stage_src |= resource->stage;
+            stage_dst |= info.stage;
+
+            resource->layout = info.layout;
+            resource->stage = info.stage;
+            resource->access = info.access;
+            resource->written_is = info.write_is;
+        }
+
+        if (0 != barrier_count)
+        {
+            vkCmdPipelineBarrier(commandbuffer_, stage_src, stage_dst, 0, 0, NULL, 0, NULL, barrier_count, image_memory_barrier_all);
+        }
+
+        pass->record(renderer, commandbuffer_, pass->data);
+    }
+
+    uint32_t barrier_count = 0;
+    VkPipelineStageFlags stage_src = 0;
+
+    //imported images go back the way their owner expects them, like ready for presentation
+    for (uint32_t i = 0; i < graph->resource_count; i++)
+    {
+        CNVX_Vulkan_Graph_Resource_PRIVATE* const resource = &graph->resource_all[i];
+
+        if (!resource->imported_is || resource->layout == resource->layout_final)
+        {
+            continue;
+        }
+
+        VkImageMemoryBarrier* const image_memory_barrier = &image_memory_barrier_all[barrier_count++];
+        image_memory_barrier->sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        image_memory_barrier->pNext = NULL;
+        image_memory_barrier->srcAccessMask = resource->written_is ? resource->access : 0;
+        image_memory_barrier->dstAccessMask = 0;
+        image_memory_barrier->oldLayout = resource->layout;
+        image_memory_barrier->newLayout = resource->layout_final;
+        image_memory_barrier->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        image_memory_barrier->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        image_memory_barrier->image = resource->image;
+        image_memory_barrier->subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        image_memory_barrier->subresourceRange.baseMipLevel = 0;
+        image_memory_barrier->subresourceRange.levelCount = 1;
+        image_memory_barrier->subresourceRange.baseArrayLayer = 0;
+        image_memory_barrier->subresourceRange.layerCount = 1;
+
+        stage_src |= resource->stage;
+
+        resource->layout = resource->layout_final;
+    }
+
+    //presentation and the next frame wait on semaphores and fences, which cover all prior work
+    if (0 != barrier_count)
+    {
+        vkCmdPipelineBarrier(commandbuffer_, stage_src, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, NULL, 0, NULL, barrier_count, image_memory_barrier_all);
+    }
+}
@@ -0,0 +1,492 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+#include "sprx/thread/mutex.h"
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+#define CNVX_VULKAN_MEMORY_PAGE_SLOT_COUNT 64
+
+VkDeviceSize canvas_vulkan_memory_class_size_get_PRIVATE(const uint32_t class_index_)
+{
+    return (VkDeviceSize)CNVX_VULKAN_MEMORY_CLASS_SIZE_MIN << class_index_;
+}
+
+uint32_t canvas_vulkan_memory_class_index_get_PRIVATE(const VkDeviceSize size_, const VkDeviceSize alignment_)
+{
+    //slots sit at multiples of the class size, so a class at least as large as the alignment is aligned
+    const VkDeviceSize size = SPRX_MAX(size_, alignment_);
+
+    for (uint32_t i = 0; i < CNVX_VULKAN_MEMORY_CLASS_COUNT; i++)
+    {
+        if (size <= canvas_vulkan_memory_class_size_get_PRIVATE(i))
+        {
+            return i;
+        }
+    }
+
+    return CNVX_VULKAN_MEMORY_CLASS_DEDICATED;
+}
+
+VkResult canvas_vulkan_memory_block_allocate_PRIVATE(void* const renderer_, const uint32_t type_index_, const VkDeviceSize size_, VkDeviceMemory* const memory_, void** const data_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != memory_, CNVX_VULKAN_ERROR_NULL("memory"));
+    SPRX_ASSERT(NULL != data_, CNVX_VULKAN_ERROR_NULL("data"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const VkPhysicalDeviceMemoryProperties* const memory_properties = &renderer->vk.physical_device_memory_properties_all[renderer->vk.physical_device_use_index];
+    const uint32_t heap_index = memory_properties->memoryTypes[type_index_].heapIndex;
+
+    if (renderer->vk.memory_allocation_count >= renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index].limits.maxMemoryAllocationCount)
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: %u device memory allocations reach maxMemoryAllocationCount", renderer->vk.memory_allocation_count);
+    }
+
+    VkMemoryAllocateInfo memory_allocate_info;
+    memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memory_allocate_info.pNext = NULL;
+    memory_allocate_info.allocationSize = size_;
+    memory_allocate_info.memoryTypeIndex = type_index_;
+
+    VkResult result = vkAllocateMemory(renderer->vk.device, &memory_allocate_info, NULL, memory_);
+
+    if (VK_SUCCESS != result)
+    {
+        return result;
+    }
+
+    *data_ = NULL;
+
+    if (VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT & memory_properties->memoryTypes[type_index_].propertyFlags)
+    {
+        //host visible blocks stay mapped for their whole lifetime
+        result = vkMapMemory(renderer->vk.device, *memory_, 0, VK_WHOLE_SIZE, 0, data_);
+        CNVX_VULKAN_ASSERT(renderer, result, "vkMapMemory");
+    }
+
+    renderer->vk.memory_allocation_count++;
+    renderer->vk.memory_stats.heap_all[heap_index].allocation_count++;
+    renderer->vk.memory_stats.heap_all[heap_index].allocated_size += size_;
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkAllocateMemory %lluKiB from memory type %u (heap %u)", (unsigned long long)(size_ >> 10), type_index_, heap_index);
+
+    return VK_SUCCESS;
+}
+
+void canvas_vulkan_memory_block_free_PRIVATE(void* const renderer_, const uint32_t type_index_, const VkDeviceSize size_, const VkDeviceMemory memory_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t heap_index = renderer->vk.physical_device_memory_properties_all[renderer->vk.physical_device_use_index].memoryTypes[type_index_].heapIndex;
+
+    //freeing implicitly unmaps
+    vkFreeMemory(renderer->vk.device, memory_, NULL);
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkFreeMemory %lluKiB from memory type %u (heap %u)", (unsigned long long)(size_ >> 10), type_index_, heap_index);
+
+    renderer->vk.memory_allocation_count--;
+    renderer->vk.memory_stats.heap_all[heap_index].allocation_count--;
+    renderer->vk.memory_stats.heap_all[heap_index].allocated_size -= size_;
+}
+
+VkDeviceSize canvas_vulkan_memory_page_size_get_PRIVATE(const uint32_t class_index_)
+{
+    const VkDeviceSize page_size = canvas_vulkan_memory_class_size_get_PRIVATE(class_index_) * CNVX_VULKAN_MEMORY_PAGE_SLOT_COUNT;
+
+    return SPRX_MIN(SPRX_MAX(page_size, CNVX_VULKAN_MEMORY_PAGE_SIZE_MIN), CNVX_VULKAN_MEMORY_PAGE_SIZE_MAX);
+}
+
+CNVX_Vulkan_Memory_Page_PRIVATE* canvas_vulkan_memory_page_new_PRIVATE(void* const renderer_, const uint32_t type_index_, const uint32_t class_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const VkDeviceSize page_size = canvas_vulkan_memory_page_size_get_PRIVATE(class_index_);
+
+    CNVX_Vulkan_Memory_Page_PRIVATE* const page = malloc(sizeof(*page));
+    SPRX_ASSERT(NULL != page, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    if (VK_SUCCESS != canvas_vulkan_memory_block_allocate_PRIVATE(renderer, type_index_, page_size, &page->memory, &page->data))
+    {
+        free(page);
+        return NULL;
+    }
+
+    page->slot_count = (uint32_t)(page_size / canvas_vulkan_memory_class_size_get_PRIVATE(class_index_));
+    page->free_count = page->slot_count;
+    page->next = NULL;
+
+    page->free_all = malloc(sizeof(*page->free_all) * page->slot_count);
+    SPRX_ASSERT(NULL != page->free_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    //lowest slot on top of the stack
+    for (uint32_t i = 0; i < page->slot_count; i++)
+    {
+        page->free_all[i] = page->slot_count - 1 - i;
+    }
+
+    return page;
+}
+
+void canvas_vulkan_memory_page_delete_PRIVATE(void* const renderer_, CNVX_Vulkan_Memory_Page_PRIVATE* const page_, const uint32_t type_index_, const uint32_t class_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != page_, CNVX_VULKAN_ERROR_NULL("page"));
+
+    canvas_vulkan_memory_block_free_PRIVATE(renderer_, type_index_, canvas_vulkan_memory_page_size_get_PRIVATE(class_index_), page_->memory);
+
+    free(page_->free_all);
+    free(page_);
+}
+
+//returns false if the memory type is exhausted
+bool canvas_vulkan_memory_allocate_type_PRIVATE(void* const renderer_, const uint32_t type_index_, const VkMemoryRequirements* const requirements_, const bool linear_is_, CNVX_Vulkan_Allocation_PRIVATE* const allocation_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t class_index = canvas_vulkan_memory_class_index_get_PRIVATE(requirements_->size, requirements_->alignment);
+
+    allocation_->type_index = type_index_;
+    allocation_->class_index = class_index;
+    allocation_->linear_is = linear_is_;
+
+    if (CNVX_VULKAN_MEMORY_CLASS_DEDICATED == class_index)
+    {
+        if (VK_SUCCESS != canvas_vulkan_memory_block_allocate_PRIVATE(renderer, type_index_, requirements_->size, &allocation_->memory, &allocation_->data))
+        {
+            return false;
+        }
+
+        allocation_->offset = 0;
+        allocation_->size = requirements_->size;
+        allocation_->page = NULL;
+        allocation_->slot = 0;
+
+        return true;
+    }
+
+    //linear and optimal resources never share a page, so bufferImageGranularity can be ignored
+    CNVX_Vulkan_Memory_Page_PRIVATE** const page_first = &renderer->vk.memory_page_first_all[type_index_][linear_is_ ? 1 : 0][class_index];
+
+    CNVX_Vulkan_Memory_Page_PRIVATE* page = *page_first;
+
+    while (NULL != page && 0 == page->free_count)
+    {
+        page = page->next;
+    }
+
+    if (NULL == page)
+    {
+        page = canvas_vulkan_memory_page_new_PRIVATE(renderer, type_index_, class_index);
+
+        if (NULL == page)
+        {
+            return false;
+        }
+
+        page->next = *page_first;
+        *page_first = page;
+    }
+
+    const VkDeviceSize class_size = canvas_vulkan_memory_class_size_get_PRIVATE(class_index);
+
+    allocation_->slot = page->free_all[--page->free_count];
+    allocation_->memory = page->memory;
+    allocation_->offset = allocation_->slot * class_size;
+    allocation_->size = class_size;
+    allocation_->data = NULL != page->data ? (char*)page->data + allocation_->offset : NULL;
+    allocation_->page = page;
+
+    return true;
+}
+
+void canvas_vulkan_memory_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: memory creation");
+
+    renderer->vk.memory_mutex = spore_mutex_new();
+    renderer->vk.memory_allocation_count = 0;
+
+    for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+    {
+        for (uint32_t k = 0; k < 2; k++)
+        {
+            for (uint32_t l = 0; l < CNVX_VULKAN_MEMORY_CLASS_COUNT; l++)
+            {
+                renderer->vk.memory_page_first_all[i][k][l] = NULL;
+            }
+        }
+    }
+
+    const VkPhysicalDeviceMemoryProperties* const memory_properties = &renderer->vk.physical_device_memory_properties_all[renderer->vk.physical_device_use_index];
+
+    renderer->vk.memory_stats.heap_count = SPRX_MIN(memory_properties->memoryHeapCount, CNVX_RENDERER_MEMORY_HEAP_COUNT_MAX);
+
+    for (size_t i = 0; i < CNVX_RENDERER_MEMORY_HEAP_COUNT_MAX; i++)
+    {
+        CNVX_Renderer_Memory_Heap_Stats* const heap_stats = &renderer->vk.memory_stats.heap_all[i];
+
+        heap_stats->size = i < renderer->vk.memory_stats.heap_count ? memory_properties->memoryHeaps[i].size : 0;
+        heap_stats->device_local_is = i < renderer->vk.memory_stats.heap_count && (VK_MEMORY_HEAP_DEVICE_LOCAL_BIT & memory_properties->memoryHeaps[i].flags);
+        heap_stats->allocation_count = 0;
+        heap_stats->allocated_size = 0;
+        heap_stats->used_size = 0;
+    }
+
+    renderer->vk.memory_linear_size = 0 != renderer->settings.memory_linear_size ? renderer->settings.memory_linear_size : CNVX_RENDERER_MEMORY_LINEAR_SIZE_DEFAULT;
+    renderer->vk.memory_linear_head = 0;
+
+    renderer->vk.memory_stats.linear_size = renderer->vk.memory_linear_size;
+    renderer->vk.memory_stats.linear_used_size_peak = 0;
+
+    renderer->vk.memory_linear_buffer_all = malloc(sizeof(*renderer->vk.memory_linear_buffer_all) * renderer->vk.frame_count);
+    SPRX_ASSERT(NULL != renderer->vk.memory_linear_buffer_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    renderer->vk.memory_linear_allocation_all = malloc(sizeof(*renderer->vk.memory_linear_allocation_all) * renderer->vk.frame_count);
+    SPRX_ASSERT(NULL != renderer->vk.memory_linear_allocation_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    VkBufferCreateInfo buffer_create_info;
+    buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_create_info.pNext = NULL;
+    buffer_create_info.flags = 0;
+    //the slack keeps a dynamic uniform range starting anywhere in the arena inside the buffer
+    buffer_create_info.size = renderer->vk.memory_linear_size + CNVX_RENDERER_UNIFORM_SIZE_MAX;
+    buffer_create_info.usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    buffer_create_info.queueFamilyIndexCount = 0;
+    buffer_create_info.pQueueFamilyIndices = NULL;
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        VkResult result = vkCreateBuffer(renderer->vk.device, &buffer_create_info, NULL, &renderer->vk.memory_linear_buffer_all[i]);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateBuffer (%u/%u)", i + 1, renderer->vk.frame_count);
+
+        VkMemoryRequirements memory_requirements;
+        vkGetBufferMemoryRequirements(renderer->vk.device, renderer->vk.memory_linear_buffer_all[i], &memory_requirements);
+
+        //written by the cpu every frame, device local if the device offers resizable bar
+        canvas_vulkan_memory_allocate(renderer, &memory_requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true, &renderer->vk.memory_linear_allocation_all[i]);
+
+        result = vkBindBufferMemory(renderer->vk.device, renderer->vk.memory_linear_buffer_all[i], renderer->vk.memory_linear_allocation_all[i].memory, renderer->vk.memory_linear_allocation_all[i].offset);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkBindBufferMemory (%u/%u)", i + 1, renderer->vk.frame_count);
+    }
+}
+
+void canvas_vulkan_memory_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        vkDestroyBuffer(renderer->vk.device, renderer->vk.memory_linear_buffer_all[i], NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyBuffer (%u/%u)", i + 1, renderer->vk.frame_count);
+
+        canvas_vulkan_memory_free(renderer, &renderer->vk.memory_linear_allocation_all[i]);
+    }
+
+    free(renderer->vk.memory_linear_allocation_all);
+    free(renderer->vk.memory_linear_buffer_all);
+
+    for (uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+    {
+        for (uint32_t k = 0; k < 2; k++)
+        {
+            for (uint32_t l = 0; l < CNVX_VULKAN_MEMORY_CLASS_COUNT; l++)
+            {
+                CNVX_Vulkan_Memory_Page_PRIVATE* page = renderer->vk.memory_page_first_all[i][k][l];
+
+                while (NULL != page)
+                {
+                    CNVX_Vulkan_Memory_Page_PRIVATE* const next = page->next;
+
+                    if (page->free_count != page->slot_count)
+                    {
+                        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: %u allocations of memory type %u leaked", page->slot_count - page->free_count, i);
+                    }
+
+                    canvas_vulkan_memory_page_delete_PRIVATE(renderer, page, i, l);
+
+                    page = next;
+                }
+            }
+        }
+    }
+
+    if (0 != renderer->vk.memory_allocation_count)
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: %u dedicated allocations leaked", renderer->vk.memory_allocation_count);
+    }
+
+    spore_mutex_delete(renderer->vk.memory_mutex);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: memory destruction");
+}
+
+void canvas_vulkan_memory_allocate(void* const renderer_, const VkMemoryRequirements* const requirements_, const VkMemoryPropertyFlags required_, const VkMemoryPropertyFlags preferred_, const bool linear_is_, CNVX_Vulkan_Allocation_PRIVATE* const allocation_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != requirements_, CNVX_VULKAN_ERROR_NULL("requirements"));
+    SPRX_ASSERT(NULL != allocation_, CNVX_VULKAN_ERROR_NULL("allocation"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.memory_mutex);
+
+    const VkPhysicalDeviceMemoryProperties* const memory_properties = &renderer->vk.physical_device_memory_properties_all[renderer->vk.physical_device_use_index];
+
+    bool done_is = false;
+
+    //first pass with the preferred flags, second pass with the required ones only
+    for (uint32_t pass = 0; pass < 2 && !done_is; pass++)
+    {
+        const VkMemoryPropertyFlags flags = 0 == pass ? required_ | preferred_ : required_;
+
+        for (uint32_t i = 0; i < memory_properties->memoryTypeCount && !done_is; i++)
+        {
+            if ((requirements_->memoryTypeBits & (1u << i)) && flags == (flags & memory_properties->memoryTypes[i].propertyFlags))
+            {
+                done_is = canvas_vulkan_memory_allocate_type_PRIVATE(renderer, i, requirements_, linear_is_, allocation_);
+            }
+        }
+    }
+
+    SPRX_ASSERT(done_is, CNVX_VULKAN_ERROR_LOGIC("could not continue", "no memory type could satisfy the allocation", NULL));
+
+    renderer->vk.memory_stats.heap_all[memory_properties->memoryTypes[allocation_->type_index].heapIndex].used_size += allocation_->size;
+
+    spore_mutex_unlock(renderer->vk.memory_mutex);
+}
+
+void canvas_vulkan_memory_free(void* const renderer_, CNVX_Vulkan_Allocation_PRIVATE* const allocation_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != allocation_, CNVX_VULKAN_ERROR_NULL("allocation"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.memory_mutex);
+
+    renderer->vk.memory_stats.heap_all[renderer->vk.physical_device_memory_properties_all[renderer->vk.physical_device_use_index].memoryTypes[allocation_->type_index].heapIndex].used_size -= allocation_->size;
+
+    if (CNVX_VULKAN_MEMORY_CLASS_DEDICATED == allocation_->class_index)
+    {
+        canvas_vulkan_memory_block_free_PRIVATE(renderer, allocation_->type_index, allocation_->size, allocation_->memory);
+    }
+    else
+    {
+        CNVX_Vulkan_Memory_Page_PRIVATE* const page = allocation_->page;
+
+        page->free_all[page->free_count++] = allocation_->slot;
+
+        //an empty page is released unless it is the only one of its pool
+        CNVX_Vulkan_Memory_Page_PRIVATE** link = &renderer->vk.memory_page_first_all[allocation_->type_index][allocation_->linear_is ? 1 : 0][allocation_->class_index];
+
+        if (page->free_count == page->slot_count && (page != *link || NULL != page->next))
+        {
+            while (page != *link)
+            {
+                link = &(*link)->next;
+            }
+
+            *link = page->next;
+
+            canvas_vulkan_memory_page_delete_PRIVATE(renderer, page, allocation_->type_index, allocation_->class_index);
+        }
+    }
+
+    allocation_->memory = VK_NULL_HANDLE;
+    allocation_->data = NULL;
+    allocation_->page = NULL;
+
+    spore_mutex_unlock(renderer->vk.memory_mutex);
+}
+
+void canvas_vulkan_memory_linear_reset(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.memory_mutex);
+
+    renderer->vk.memory_linear_head = 0;
+
+    spore_mutex_unlock(renderer->vk.memory_mutex);
+}
+
+void* canvas_vulkan_memory_linear_allocate(void* const renderer_, const VkDeviceSize size_, const VkDeviceSize alignment_, VkBuffer* const buffer_, VkDeviceSize* const offset_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != buffer_, CNVX_VULKAN_ERROR_NULL("buffer"));
+    SPRX_ASSERT(NULL != offset_, CNVX_VULKAN_ERROR_NULL("offset"));
+    SPRX_ASSERT(0 != alignment_ && 0 == (alignment_ & (alignment_ - 1)), CNVX_VULKAN_ERROR_ARGUMENT("alignment has to be a power of two"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.memory_mutex);
+
+    const VkDeviceSize offset = (renderer->vk.memory_linear_head + alignment_ - 1) & ~(alignment_ - 1);
+
+    if (offset + size_ > renderer->vk.memory_linear_size)
+    {
+        spore_mutex_unlock(renderer->vk.memory_mutex);
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: linear allocation of %lluB does not fit into the %lluKiB frame arena", (unsigned long long)size_, (unsigned long long)(renderer->vk.memory_linear_size >> 10));
+
+        return NULL;
+    }
+
+    renderer->vk.memory_linear_head = offset + size_;
+    renderer->vk.memory_stats.linear_used_size_peak = SPRX_MAX(renderer->vk.memory_stats.linear_used_size_peak, renderer->vk.memory_linear_head);
+
+    spore_mutex_unlock(renderer->vk.memory_mutex);
+
+    const CNVX_Vulkan_Allocation_PRIVATE* const allocation = &renderer->vk.memory_linear_allocation_all[renderer->vk.frame_index];
+
+    *buffer_ = renderer->vk.memory_linear_buffer_all[renderer->vk.frame_index];
+    *offset_ = offset;
+
+    return (char*)allocation->data + offset;
+}
@@ -0,0 +1,157 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_pipeline_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+#include "sprx/thread/mutex.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+//fnv-1a over the key, the fields are small enums so every byte matters
+uint32_t canvas_vulkan_pipeline_key_hash_PRIVATE(const CNVX_Vulkan_Pipeline_Key_PRIVATE* const key_)
+{
+    SPRX_ASSERT(NULL != key_, CNVX_VULKAN_ERROR_NULL("key"));
+
+    const uint8_t* const byte_all = (const uint8_t*)key_;
+
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < sizeof(*key_); i++)
+    {
+        hash = (hash ^ byte_all[i]) * 16777619u;
+    }
+
+    return hash;
+}
+
+void canvas_vulkan_pipeline_variant_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    renderer->vk.pipeline_variant_count = 0;
+    renderer->vk.pipeline_variant_wait_count = 0;
+
+    for (uint32_t i = 0; i < CNVX_VULKAN_PIPELINE_SLOT_COUNT; i++)
+    {
+        renderer->vk.pipeline_variant_slot_all[i] = CNVX_VULKAN_PIPELINE_VARIANT_NONE;
+    }
+}
+
+void canvas_vulkan_pipeline_variant_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_pipeline_variant_wait(renderer);
+
+    for (uint32_t i = 0; i < renderer->vk.pipeline_variant_count; i++)
+    {
+        if (VK_NULL_HANDLE != renderer->vk.pipeline_variant_all[i].pipeline)
+        {
+            vkDestroyPipeline(renderer->vk.device, renderer->vk.pipeline_variant_all[i].pipeline, NULL);
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyPipeline (%u/%u)", i + 1, renderer->vk.pipeline_variant_count);
+        }
+    }
+
+    canvas_vulkan_pipeline_variant_create(renderer);
+}
+
+uint32_t canvas_vulkan_pipeline_variant_get(void* const renderer_, const CNVX_Vulkan_Pipeline_Key_PRIVATE* const key_, const CNVX_Worker_Function_PRIVATE build_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != key_, CNVX_VULKAN_ERROR_NULL("key"));
+    SPRX_ASSERT(NULL != build_, CNVX_VULKAN_ERROR_NULL("build"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t mask = CNVX_VULKAN_PIPELINE_SLOT_COUNT - 1;
+
+    //the table never gets more than half full, so probing always ends on an empty slot
+    uint32_t slot = canvas_vulkan_pipeline_key_hash_PRIVATE(key_) & mask;
+
+    for (; CNVX_VULKAN_PIPELINE_VARIANT_NONE != renderer->vk.pipeline_variant_slot_all[slot]; slot = (slot + 1) & mask)
+    {
+        const uint32_t variant = renderer->vk.pipeline_variant_slot_all[slot];
+
+        if (0 == memcmp(&renderer->vk.pipeline_variant_all[variant].key, key_, sizeof(*key_)))
+        {
+            return variant;
+        }
+    }
+
+    if (CNVX_VULKAN_PIPELINE_VARIANT_COUNT_MAX == renderer->vk.pipeline_variant_count)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: CNVX_VULKAN_PIPELINE_VARIANT_COUNT_MAX reached, draw dropped");
+        return CNVX_VULKAN_PIPELINE_VARIANT_NONE;
+    }
+
+    const uint32_t variant = renderer->vk.pipeline_variant_count++;
+
+    CNVX_Vulkan_Pipeline_Variant_PRIVATE* const pipeline_variant = &renderer->vk.pipeline_variant_all[variant];
+    pipeline_variant->key = *key_;
+    pipeline_variant->pipeline = VK_NULL_HANDLE;
+
+    renderer->vk.pipeline_variant_slot_all[slot] = variant;
+
+    spore_mutex_lock(renderer->vk.pipeline_cache_mutex);
+    renderer->vk.pipeline_cache_stats.variant_count++;
+    spore_mutex_unlock(renderer->vk.pipeline_cache_mutex);
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: pipeline variant %u requested (shader set %u, blend %u, topology %u, cull %u)", variant, key_->shader_set, key_->blend, key_->topology, key_->cull);
+
+    canvas_worker_submit(renderer->worker, &pipeline_variant->job, build_, renderer, variant);
+
+    return variant;
+}
+
+void canvas_vulkan_pipeline_variant_wait(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //variants are only ever appended, everything below the wait count is already joined
+    for (uint32_t i = renderer->vk.pipeline_variant_wait_count; i < renderer->vk.pipeline_variant_count; i++)
+    {
+        if (!canvas_worker_done_is(renderer->worker, &renderer->vk.pipeline_variant_all[i].job))
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: waiting for pipeline variant %u build", i);
+        }
+
+        canvas_worker_wait(renderer->worker, &renderer->vk.pipeline_variant_all[i].job);
+    }
+
+    renderer->vk.pipeline_variant_wait_count = renderer->vk.pipeline_variant_count;
+}
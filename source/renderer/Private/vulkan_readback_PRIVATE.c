@@ -0,0 +1,324 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_readback_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+//=0 if the copy would need a format conversion
+uint32_t canvas_vulkan_readback_texel_size_get_PRIVATE(const VkFormat format_)
+{
+    switch (format_)
+    {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB:
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB:
+        return 4;
+    default:
+        return 0;
+    }
+}
+
+void canvas_vulkan_readback_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: readback creation");
+
+    //buffers are created on the first capture, sized to the image
+    for (uint32_t i = 0; i < CNVX_RENDERER_READBACK_RING_COUNT; i++)
+    {
+        renderer->vk.readback_slot_all[i].state = CNVX_VULKAN_READBACK_STATE_FREE;
+        renderer->vk.readback_slot_all[i].buffer = VK_NULL_HANDLE;
+        renderer->vk.readback_slot_all[i].size = 0;
+    }
+
+    renderer->vk.readback_slot_record = NULL;
+    renderer->vk.readback_requested_is = false;
+}
+
+void canvas_vulkan_readback_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < CNVX_RENDERER_READBACK_RING_COUNT; i++)
+    {
+        CNVX_Vulkan_Readback_Slot_PRIVATE* const slot = &renderer->vk.readback_slot_all[i];
+
+        if (VK_NULL_HANDLE != slot->buffer)
+        {
+            vkDestroyBuffer(renderer->vk.device, slot->buffer, NULL);
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyBuffer (%u/%u)", i + 1, CNVX_RENDERER_READBACK_RING_COUNT);
+
+            canvas_vulkan_memory_free(renderer, &slot->allocation);
+
+            slot->buffer = VK_NULL_HANDLE;
+        }
+
+        slot->state = CNVX_VULKAN_READBACK_STATE_FREE;
+        slot->size = 0;
+    }
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: readback destruction");
+}
+
+void canvas_vulkan_readback_slot_reserve_PRIVATE(void* const renderer_, CNVX_Vulkan_Readback_Slot_PRIVATE* const slot_, const VkDeviceSize size_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != slot_, CNVX_VULKAN_ERROR_NULL("slot"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (size_ <= slot_->size)
+    {
+        return;
+    }
+
+    //a free slot has been fetched or never used, so the gpu is done with its buffer
+    if (VK_NULL_HANDLE != slot_->buffer)
+    {
+        vkDestroyBuffer(renderer->vk.device, slot_->buffer, NULL);
+        canvas_vulkan_memory_free(renderer, &slot_->allocation);
+    }
+
+    VkBufferCreateInfo buffer_create_info;
+    buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_create_info.pNext = NULL;
+    buffer_create_info.flags = 0;
+    buffer_create_info.size = size_;
+    buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    buffer_create_info.queueFamilyIndexCount = 0;
+    buffer_create_info.pQueueFamilyIndices = NULL;
+
+    VkResult result = vkCreateBuffer(renderer->vk.device, &buffer_create_info, NULL, &slot_->buffer);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateBuffer");
+
+    VkMemoryRequirements memory_requirements;
+    vkGetBufferMemoryRequirements(renderer->vk.device, slot_->buffer, &memory_requirements);
+
+    //cached memory makes reading the pixels on the cpu considerably faster
+    canvas_vulkan_memory_allocate(renderer, &memory_requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT, true, &slot_->allocation);
+
+    result = vkBindBufferMemory(renderer->vk.device, slot_->buffer, slot_->allocation.memory, slot_->allocation.offset);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkBindBufferMemory");
+
+    slot_->size = size_;
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: readback buffer of %lluKiB", (unsigned long long)(size_ >> 10));
+}
+
+bool canvas_vulkan_readback_prepare(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    renderer->vk.readback_slot_record = NULL;
+
+    if (!renderer->vk.readback_requested_is)
+    {
+        return false;
+    }
+
+    renderer->vk.readback_requested_is = false;
+
+    const uint32_t texel_size = canvas_vulkan_readback_texel_size_get_PRIVATE(renderer->vk.format_use);
+
+    if (!renderer->vk.readback_supported_is || 0 == texel_size)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: readback dropped, the image can not be copied");
+        return false;
+    }
+
+    CNVX_Vulkan_Readback_Slot_PRIVATE* slot = NULL;
+
+    for (uint32_t i = 0; i < CNVX_RENDERER_READBACK_RING_COUNT && NULL == slot; i++)
+    {
+        if (CNVX_VULKAN_READBACK_STATE_FREE == renderer->vk.readback_slot_all[i].state)
+        {
+            slot = &renderer->vk.readback_slot_all[i];
+        }
+    }
+
+    if (NULL == slot)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: readback dropped, every ring buffer is in use");
+        return false;
+    }
+
+    slot->width = (uint32_t)renderer->width;
+    slot->height = (uint32_t)renderer->height;
+    slot->texel_size = texel_size;
+    slot->format = renderer->vk.format_use;
+
+    canvas_vulkan_readback_slot_reserve_PRIVATE(renderer, slot, (VkDeviceSize)slot->width * slot->height * texel_size);
+
+    renderer->vk.readback_slot_record = slot;
+
+    return true;
+}
+
+void canvas_vulkan_readback_record(void* const renderer_, const VkCommandBuffer commandbuffer_, const VkImage image_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Vulkan_Readback_Slot_PRIVATE* const slot = renderer->vk.readback_slot_record;
+
+    SPRX_ASSERT(NULL != slot, CNVX_VULKAN_ERROR_LOGIC("failed to record readback", "canvas_vulkan_readback_prepare did not reserve a slot", NULL));
+
+    renderer->vk.readback_slot_record = NULL;
+
+    VkBufferImageCopy buffer_image_copy;
+    buffer_image_copy.bufferOffset = 0;
+    buffer_image_copy.bufferRowLength = 0;
+    buffer_image_copy.bufferImageHeight = 0;
+    buffer_image_copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    buffer_image_copy.imageSubresource.mipLevel = 0;
+    buffer_image_copy.imageSubresource.baseArrayLayer = 0;
+    buffer_image_copy.imageSubresource.layerCount = 1;
+    buffer_image_copy.imageOffset.x = 0;
+    buffer_image_copy.imageOffset.y = 0;
+    buffer_image_copy.imageOffset.z = 0;
+    buffer_image_copy.imageExtent.width = slot->width;
+    buffer_image_copy.imageExtent.height = slot->height;
+    buffer_image_copy.imageExtent.depth = 1;
+
+    vkCmdCopyImageToBuffer(commandbuffer_, image_, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, slot->buffer, 1, &buffer_image_copy);
+
+    VkBufferMemoryBarrier buffer_memory_barrier;
+    buffer_memory_barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    buffer_memory_barrier.pNext = NULL;
+    buffer_memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    buffer_memory_barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    buffer_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    buffer_memory_barrier.buffer = slot->buffer;
+    buffer_memory_barrier.offset = 0;
+    buffer_memory_barrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(commandbuffer_, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, NULL, 1, &buffer_memory_barrier, 0, NULL);
+
+    //recording is directly followed by the submission of this frame
+    slot->state = CNVX_VULKAN_READBACK_STATE_PENDING;
+    slot->frame_index = renderer->vk.frame_index;
+    slot->frame_serial = renderer->vk.frame_serial + 1;
+}
+
+bool canvas_vulkan_readback_done_is_PRIVATE(void* const renderer_, const CNVX_Vulkan_Readback_Slot_PRIVATE* const slot_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != slot_, CNVX_VULKAN_ERROR_NULL("slot"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (renderer->vk.frame_serial_done_all[slot_->frame_index] >= slot_->frame_serial)
+    {
+        return true;
+    }
+
+    //the fence is only meaningful while it still belongs to the captured submission
+    if (renderer->vk.frame_serial_submitted_all[slot_->frame_index] != slot_->frame_serial)
+    {
+        return false;
+    }
+
+    return VK_SUCCESS == vkGetFenceStatus(renderer->vk.device, renderer->vk.fence_frame_all[slot_->frame_index]);
+}
+
+bool canvas_vulkan_readback_get(void* const renderer_, CNVX_Renderer_Readback* const readback_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != readback_, CNVX_VULKAN_ERROR_NULL("readback"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_readback_release(renderer);
+
+    CNVX_Vulkan_Readback_Slot_PRIVATE* oldest = NULL;
+
+    for (uint32_t i = 0; i < CNVX_RENDERER_READBACK_RING_COUNT; i++)
+    {
+        CNVX_Vulkan_Readback_Slot_PRIVATE* const slot = &renderer->vk.readback_slot_all[i];
+
+        if (CNVX_VULKAN_READBACK_STATE_PENDING == slot->state && canvas_vulkan_readback_done_is_PRIVATE(renderer, slot))
+        {
+            slot->state = CNVX_VULKAN_READBACK_STATE_READY;
+        }
+
+        if (CNVX_VULKAN_READBACK_STATE_READY == slot->state && (NULL == oldest || slot->frame_serial < oldest->frame_serial))
+        {
+            oldest = slot;
+        }
+    }
+
+    if (NULL == oldest)
+    {
+        return false;
+    }
+
+    oldest->state = CNVX_VULKAN_READBACK_STATE_HELD;
+
+    readback_->data = oldest->allocation.data;
+    readback_->width = oldest->width;
+    readback_->height = oldest->height;
+    readback_->row_size = (size_t)oldest->width * oldest->texel_size;
+    readback_->format = (uint32_t)oldest->format;
+    readback_->frame = oldest->frame_serial;
+
+    return true;
+}
+
+void canvas_vulkan_readback_release(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < CNVX_RENDERER_READBACK_RING_COUNT; i++)
+    {
+        if (CNVX_VULKAN_READBACK_STATE_HELD == renderer->vk.readback_slot_all[i].state)
+        {
+            renderer->vk.readback_slot_all[i].state = CNVX_VULKAN_READBACK_STATE_FREE;
+        }
+    }
+}
@@ -0,0 +1,526 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_pipeline_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_reload_PRIVATE.h"
+#include "cnvx/renderer/Private/worker_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/container/vector.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+#include "sprx/file/file.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif // __linux__
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+const char* canvas_vulkan_reload_name_get_PRIVATE(const char* const path_)
+{
+    SPRX_ASSERT(NULL != path_, CNVX_VULKAN_ERROR_NULL("path"));
+
+    const char* const slash = strrchr(path_, '/');
+
+    return NULL != slash ? slash + 1 : path_;
+}
+
+bool canvas_vulkan_reload_affected_is_PRIVATE(void* const renderer_, const uint32_t shader_set_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        if (renderer->vk.reload_shader_all[i].rebuild_is && shader_set_ == canvas_vulkan_shader_pipeline_get(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->type))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//reads the whole file, =false keeps the shader as it is
+bool canvas_vulkan_reload_shader_read_PRIVATE(void* const renderer_, const uint32_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.shader_module_count > index_, CNVX_VULKAN_ERROR_ARGUMENT("index has to be <shader module count"));
+
+    CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[index_];
+    const char* const path = spore_string_cstr(SPRX_VECTOR_AT(renderer->shader_vec, index_, CNVX_Renderer_Shader_PRIVATE)->path);
+
+    //read the same way canvas_renderer_shader_load does, but a failure keeps the running module
+    void* file = spore_file_new();
+
+    if (SPRX_FILE_RESULT_SUCCESS != spore_file_open(file, path, SPRX_FILE_MODE_READ, SPRX_FILE_FLAG_NONE))
+    {
+        spore_file_delete(file);
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: failed to open %s for reloading shader_%u", path, index_);
+        return false;
+    }
+
+    size_t size = 0;
+    const char* mapped = NULL;
+
+    char* data = NULL;
+
+    //a spir-v module is a sequence of words starting with the magic number
+    if (SPRX_FILE_RESULT_SUCCESS == spore_file_size_get(file, &size) && 0 < size && 0 == size % 4 && UINT32_MAX >= size && SPRX_FILE_RESULT_SUCCESS == spore_file_mmap(file, &mapped))
+    {
+        uint32_t magic = 0;
+        memcpy(&magic, mapped, sizeof(magic));
+
+        //copied, the editor may write the file again while the rebuild runs
+        if (CNVX_VULKAN_RELOAD_SPIRV_MAGIC == magic)
+        {
+            data = malloc(size);
+            SPRX_ASSERT(NULL != data, CNVX_VULKAN_ERROR_ALLOCATION);
+
+            memcpy(data, mapped, size);
+        }
+    }
+
+    spore_file_close(file);
+    spore_file_delete(file);
+
+    if (NULL == data)
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: %s is no spir-v module, keeping shader_%u", path, index_);
+        return false;
+    }
+
+    reload_shader->data = data;
+    reload_shader->size = (uint32_t)size;
+
+    return true;
+}
+
+//runs on the worker, touches only the reload fields, the new modules and the variants below reload_variant_count
+void canvas_vulkan_reload_rebuild_PRIVATE(void* const renderer_, const size_t index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //unchanged shaders keep their modules, which stay valid while the rebuild runs
+    VkShaderModule* const shader_module_all = malloc(sizeof(*shader_module_all) * SPRX_MAX(renderer->vk.shader_module_count, 1));
+    SPRX_ASSERT(NULL != shader_module_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    VkResult result = VK_SUCCESS;
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count && VK_SUCCESS == result; i++)
+    {
+        CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[i];
+
+        shader_module_all[i] = renderer->vk.shader_module_all[i];
+
+        if (reload_shader->rebuild_is)
+        {
+            VkShaderModuleCreateInfo shader_module_create_info;
+            shader_module_create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            shader_module_create_info.pNext = NULL;
+            shader_module_create_info.flags = 0;
+            shader_module_create_info.codeSize = reload_shader->size;
+            shader_module_create_info.pCode = (const uint32_t*)reload_shader->data;
+
+            result = vkCreateShaderModule(renderer->vk.device, &shader_module_create_info, NULL, &reload_shader->shader_module);
+
+            shader_module_all[i] = reload_shader->shader_module;
+        }
+    }
+
+    for (uint32_t i = 0; i < renderer->vk.reload_variant_count && VK_SUCCESS == result; i++)
+    {
+        const CNVX_Vulkan_Pipeline_Key_PRIVATE* const key = &renderer->vk.pipeline_variant_all[i].key;
+
+        if (canvas_vulkan_reload_affected_is_PRIVATE(renderer, key->shader_set))
+        {
+            result = canvas_vulkan_pipeline_variant_build(renderer, key, shader_module_all, &renderer->vk.reload_pipeline_all[i]);
+        }
+    }
+
+    renderer->vk.reload_result = result;
+
+    free(shader_module_all);
+}
+
+//nothing of the rebuild was ever recorded, so it is destroyed immediately
+void canvas_vulkan_reload_discard_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < renderer->vk.reload_variant_count; i++)
+    {
+        vkDestroyPipeline(renderer->vk.device, renderer->vk.reload_pipeline_all[i], NULL);
+    }
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[i];
+
+        if (reload_shader->rebuild_is)
+        {
+            vkDestroyShaderModule(renderer->vk.device, reload_shader->shader_module, NULL);
+            free(reload_shader->data);
+
+            reload_shader->data = NULL;
+            reload_shader->rebuild_is = false;
+        }
+    }
+
+    renderer->vk.reload_pending_is = false;
+}
+
+void canvas_vulkan_reload_swap_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (VK_SUCCESS != renderer->vk.reload_result)
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: shader rebuild failed with %d, keeping the previous shaders", (int)renderer->vk.reload_result);
+
+        canvas_vulkan_reload_discard_PRIVATE(renderer);
+        return;
+    }
+
+    //variants requested meanwhile may still be compiling from the old modules
+    canvas_vulkan_pipeline_variant_wait(renderer);
+
+    uint32_t pipeline_count = 0;
+
+    for (uint32_t i = 0; i < renderer->vk.reload_variant_count; i++)
+    {
+        CNVX_Vulkan_Pipeline_Variant_PRIVATE* const pipeline_variant = &renderer->vk.pipeline_variant_all[i];
+
+        if (VK_NULL_HANDLE != renderer->vk.reload_pipeline_all[i])
+        {
+            //frames in flight may still use the old pipeline
+            if (VK_NULL_HANDLE != pipeline_variant->pipeline)
+            {
+                canvas_vulkan_deferred_pipeline_release(renderer, pipeline_variant->pipeline);
+            }
+
+            pipeline_variant->pipeline = renderer->vk.reload_pipeline_all[i];
+            pipeline_count++;
+        }
+    }
+
+    uint32_t shader_count = 0;
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[i];
+
+        if (reload_shader->rebuild_is)
+        {
+            CNVX_Renderer_Shader_PRIVATE* const shader = SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE);
+
+            //pipelines do not reference their modules after creation, so the old one goes right away
+            vkDestroyShaderModule(renderer->vk.device, renderer->vk.shader_module_all[i], NULL);
+            renderer->vk.shader_module_all[i] = reload_shader->shader_module;
+
+            if (shader->owned_is)
+            {
+                free((char*)shader->data);
+            }
+
+            shader->data = reload_shader->data;
+            shader->size = reload_shader->size;
+            shader->owned_is = true;
+
+            reload_shader->data = NULL;
+            shader_count++;
+        }
+    }
+
+    //requested while the rebuild ran and therefore built from the old code, rare enough to rebuild in place
+    for (uint32_t i = renderer->vk.reload_variant_count; i < renderer->vk.pipeline_variant_count; i++)
+    {
+        CNVX_Vulkan_Pipeline_Variant_PRIVATE* const pipeline_variant = &renderer->vk.pipeline_variant_all[i];
+
+        if (canvas_vulkan_reload_affected_is_PRIVATE(renderer, pipeline_variant->key.shader_set))
+        {
+            const VkPipeline pipeline = pipeline_variant->pipeline;
+
+            const VkResult result = canvas_vulkan_pipeline_variant_build(renderer, &pipeline_variant->key, renderer->vk.shader_module_all, &pipeline_variant->pipeline);
+
+            if (VK_SUCCESS != result)
+            {
+                CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_ERROR, spore_string_substr(renderer->name, 7), "vulkan: rebuilding pipeline variant %u failed with %d, its draws are dropped", i, (int)result);
+            }
+
+            if (VK_NULL_HANDLE != pipeline)
+            {
+                canvas_vulkan_deferred_pipeline_release(renderer, pipeline);
+            }
+
+            pipeline_count++;
+        }
+    }
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        renderer->vk.reload_shader_all[i].rebuild_is = false;
+    }
+
+    renderer->vk.reload_pending_is = false;
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: reloaded %u shaders and %u pipelines", shader_count, pipeline_count);
+}
+
+void canvas_vulkan_reload_submit_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    bool rebuild_is = false;
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[i];
+
+        if (reload_shader->changed_is)
+        {
+            reload_shader->changed_is = false;
+            reload_shader->rebuild_is = canvas_vulkan_reload_shader_read_PRIVATE(renderer, i);
+            reload_shader->shader_module = VK_NULL_HANDLE;
+
+            rebuild_is |= reload_shader->rebuild_is;
+        }
+    }
+
+    if (!rebuild_is)
+    {
+        return;
+    }
+
+    //the rebuild reads the modules of the unchanged shaders
+    canvas_vulkan_shader_wait(renderer);
+
+    //variants appended from now on are rebuilt by the swap
+    renderer->vk.reload_variant_count = renderer->vk.pipeline_variant_count;
+
+    for (uint32_t i = 0; i < renderer->vk.reload_variant_count; i++)
+    {
+        renderer->vk.reload_pipeline_all[i] = VK_NULL_HANDLE;
+    }
+
+    renderer->vk.reload_result = VK_SUCCESS;
+    renderer->vk.reload_pending_is = true;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: shader rebuild started");
+
+    canvas_worker_submit(renderer->worker, &renderer->vk.reload_job, canvas_vulkan_reload_rebuild_PRIVATE, renderer, 0);
+}
+
+void canvas_vulkan_reload_poll_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+#ifdef __linux__
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //a read returns whole events only, the union keeps them aligned
+    union
+    {
+        struct inotify_event event;
+        char byte_all[CNVX_VULKAN_RELOAD_EVENT_BUFFER_SIZE];
+    } buffer;
+
+    //the descriptor is non-blocking, an empty queue ends the loop
+    for (ssize_t size = read(renderer->vk.reload_fd, buffer.byte_all, sizeof(buffer)); 0 < size; size = read(renderer->vk.reload_fd, buffer.byte_all, sizeof(buffer)))
+    {
+        for (ssize_t offset = 0; offset < size;)
+        {
+            const struct inotify_event* const event = (const struct inotify_event*)(buffer.byte_all + offset);
+            offset += sizeof(*event) + event->len;
+
+            //lost events could have been anything, so everything is reloaded
+            const bool overflow_is = 0 != (IN_Q_OVERFLOW & event->mask);
+
+            for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+            {
+                CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[i];
+
+                if (overflow_is || (event->wd == reload_shader->watch && 0 != event->len && 0 == strcmp(event->name, canvas_vulkan_reload_name_get_PRIVATE(spore_string_cstr(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->path)))))
+                {
+                    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: shader_%u changed", i);
+
+                    reload_shader->changed_is = true;
+                }
+            }
+        }
+    }
+#endif // __linux__
+}
+
+void canvas_vulkan_reload_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    renderer->vk.reload_fd = -1;
+    renderer->vk.reload_shader_all = NULL;
+    renderer->vk.reload_pending_is = false;
+    renderer->vk.reload_variant_count = 0;
+
+    if (!renderer->settings.shader_reload_is)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    renderer->vk.reload_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (0 > renderer->vk.reload_fd)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: inotify is unavailable, shader reload disabled");
+        return;
+    }
+
+    renderer->vk.reload_shader_all = malloc(sizeof(*renderer->vk.reload_shader_all) * SPRX_MAX(renderer->vk.shader_module_count, 1));
+    SPRX_ASSERT(NULL != renderer->vk.reload_shader_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    for (uint32_t i = 0; i < renderer->vk.shader_module_count; i++)
+    {
+        CNVX_Vulkan_Reload_Shader_PRIVATE* const reload_shader = &renderer->vk.reload_shader_all[i];
+        reload_shader->changed_is = false;
+        reload_shader->rebuild_is = false;
+        reload_shader->size = 0;
+        reload_shader->data = NULL;
+        reload_shader->shader_module = VK_NULL_HANDLE;
+
+        const char* const path = spore_string_cstr(SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE)->path);
+        const char* const name = canvas_vulkan_reload_name_get_PRIVATE(path);
+
+        //editors and compilers often replace the file by renaming a temporary over it, so its directory is watched
+        const size_t directory_size = path != name ? SPRX_MAX((size_t)(name - path) - 1, 1) : 0;
+
+        char* const directory = malloc(directory_size + 2);
+        SPRX_ASSERT(NULL != directory, CNVX_VULKAN_ERROR_ALLOCATION);
+
+        if (0 == directory_size)
+        {
+            strcpy(directory, ".");
+        }
+        else
+        {
+            memcpy(directory, path, directory_size);
+            directory[directory_size] = '\0';
+        }
+
+        //watching the same directory twice returns the same watch
+        reload_shader->watch = inotify_add_watch(renderer->vk.reload_fd, directory, IN_CLOSE_WRITE | IN_MOVED_TO);
+
+        if (0 > reload_shader->watch)
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: failed to watch %s, shader_%u is not reloaded", directory, i);
+        }
+
+        free(directory);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: watching %u shaders for reload", renderer->vk.shader_module_count);
+#else
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: shader reload needs inotify and is not available on this platform");
+#endif // __linux__
+}
+
+void canvas_vulkan_reload_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (0 > renderer->vk.reload_fd)
+    {
+        return;
+    }
+
+    if (renderer->vk.reload_pending_is)
+    {
+        canvas_worker_wait(renderer->worker, &renderer->vk.reload_job);
+
+        canvas_vulkan_reload_discard_PRIVATE(renderer);
+    }
+
+    free(renderer->vk.reload_shader_all);
+    renderer->vk.reload_shader_all = NULL;
+
+#ifdef __linux__
+    //closing the instance removes its watches
+    close(renderer->vk.reload_fd);
+#endif // __linux__
+
+    renderer->vk.reload_fd = -1;
+}
+
+void canvas_vulkan_reload_update(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (0 > renderer->vk.reload_fd)
+    {
+        return;
+    }
+
+    canvas_vulkan_reload_poll_PRIVATE(renderer);
+
+    if (renderer->vk.reload_pending_is)
+    {
+        //the frame never waits for a rebuild, the old shaders keep drawing until it is done
+        if (!canvas_worker_done_is(renderer->worker, &renderer->vk.reload_job))
+        {
+            return;
+        }
+
+        canvas_vulkan_reload_swap_PRIVATE(renderer);
+    }
+
+    canvas_vulkan_reload_submit_PRIVATE(renderer);
+}
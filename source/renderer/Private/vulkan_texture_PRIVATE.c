@@ -0,0 +1,507 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/atlas_PRIVATE.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_descriptor_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_texture_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_transfer_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/container/vector.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+void canvas_vulkan_texture_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: texture creation");
+
+    //a texture shares its index with its bindless slot
+    renderer->vk.texture_all = calloc(SPRX_MAX(renderer->vk.descriptor_count_all[CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE], 1), sizeof(*renderer->vk.texture_all));
+    SPRX_ASSERT(NULL != renderer->vk.texture_all, CNVX_VULKAN_ERROR_ALLOCATION);
+
+    renderer->vk.texture_upload_vec = spore_vector_new_c(sizeof(CNVX_Vulkan_Texture_Upload_PRIVATE), CNVX_VULKAN_TEXTURE_UPLOAD_GROWTH);
+
+    VkFormatProperties format_properties;
+    vkGetPhysicalDeviceFormatProperties(renderer->vk.physical_device_all[renderer->vk.physical_device_use_index], CNVX_VULKAN_TEXTURE_FORMAT, &format_properties);
+
+    SPRX_ASSERT(VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT & format_properties.optimalTilingFeatures, CNVX_VULKAN_ERROR_LOGIC("failed to create textures", "format can not be sampled", NULL));
+
+    const VkFormatFeatureFlags mip_feature = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+    renderer->vk.texture_mip_is = mip_feature == (mip_feature & format_properties.optimalTilingFeatures);
+
+    if (!renderer->vk.texture_mip_is)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: texture format can not be blitted with linear filtering, mip chains are not generated");
+    }
+
+    canvas_atlas_create(&renderer->atlas, CNVX_RENDERER_ATLAS_PAGE_SIZE);
+}
+
+void canvas_vulkan_texture_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t texture_count = renderer->vk.descriptor_count_all[CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE];
+
+    for (uint32_t i = 0; i < texture_count; i++)
+    {
+        if (renderer->vk.texture_all[i].live_is)
+        {
+            canvas_vulkan_texture_delete(renderer, i);
+        }
+    }
+
+    canvas_atlas_destroy(&renderer->atlas);
+
+    spore_vector_delete(renderer->vk.texture_upload_vec);
+
+    free(renderer->vk.texture_all);
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: texture destruction");
+}
+
+//x and y address the cell, the pixels are written padding texels inside and their borders are extruded into it
+void canvas_vulkan_texture_upload_PRIVATE(void* const renderer_, const uint32_t texture_index_, const uint32_t x_, const uint32_t y_, const void* const pixel_all_, const uint32_t width_, const uint32_t height_, const uint32_t padding_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != pixel_all_, CNVX_VULKAN_ERROR_NULL("pixel_all"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Vulkan_Texture_PRIVATE* const texture = &renderer->vk.texture_all[texture_index_];
+
+    const uint32_t cell_width = width_ + 2 * padding_;
+    const uint32_t cell_height = height_ + 2 * padding_;
+
+    SPRX_ASSERT(texture->width >= x_ + cell_width && texture->height >= y_ + cell_height, CNVX_VULKAN_ERROR_ARGUMENT("upload has to fit into the texture"));
+
+    const unsigned char* const pixel_all = pixel_all_;
+    unsigned char* cell = NULL;
+
+    if (0 != padding_)
+    {
+        cell = malloc((size_t)cell_width * cell_height * 4);
+        SPRX_ASSERT(NULL != cell, CNVX_VULKAN_ERROR_ALLOCATION);
+
+        for (uint32_t i = 0; i < cell_height; i++)
+        {
+            const uint32_t row = i < padding_ ? 0 : SPRX_MIN(i - padding_, height_ - 1);
+
+            const unsigned char* const source = pixel_all + (size_t)row * width_ * 4;
+            unsigned char* const destination = cell + (size_t)i * cell_width * 4;
+
+            for (uint32_t k = 0; k < padding_; k++)
+            {
+                memcpy(destination + (size_t)k * 4, source, 4);
+                memcpy(destination + (size_t)(padding_ + width_ + k) * 4, source + (size_t)(width_ - 1) * 4, 4);
+            }
+
+            memcpy(destination + (size_t)padding_ * 4, source, (size_t)width_ * 4);
+        }
+    }
+
+    const void* const data = NULL != cell ? (const void*)cell : pixel_all_;
+
+    if (texture->shared_is)
+    {
+        //the packer never overlaps regions and evicts only pages no frame in flight draws, the copy needs nothing from the graphics queue
+        canvas_vulkan_transfer_image_upload(renderer, texture->image, texture->mip_count, texture->defined_is ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, false, x_, y_, cell_width, cell_height, 4, data);
+
+        texture->defined_is = true;
+    }
+    else
+    {
+        SPRX_ASSERT(!texture->defined_is, CNVX_VULKAN_ERROR_LOGIC("failed to upload texture", "only shared textures are written more than once", NULL));
+
+        //handed over to the graphics queue, which builds the mip chain
+        canvas_vulkan_transfer_image_upload(renderer, texture->image, texture->mip_count, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, true, x_, y_, cell_width, cell_height, 4, data);
+
+        CNVX_Vulkan_Texture_Upload_PRIVATE upload;
+        upload.texture_index = texture_index_;
+        upload.image = texture->image;
+
+        spore_vector_push_back_grow(renderer->vk.texture_upload_vec, CNVX_VULKAN_TEXTURE_UPLOAD_GROWTH, &upload);
+    }
+
+    free(cell);
+}
+
+uint32_t canvas_vulkan_texture_new(void* const renderer_, const void* const pixel_all_, const uint32_t width_, const uint32_t height_, const bool mip_is_, const CNVX_Renderer_Texture_Filter filter_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(0 != width_ && 0 != height_, CNVX_VULKAN_ERROR_ARGUMENT("width and height have to be >0"));
+    SPRX_ASSERT(___CNVX_RENDERER_TEXTURE_FILTER_MAX > filter_, CNVX_VULKAN_ERROR_ARGUMENT("filter has to be <___CNVX_RENDERER_TEXTURE_FILTER_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //=NULL leaves the contents to later uploads into regions, as atlas pages get them while frames sample the rest
+    const bool shared_is = NULL == pixel_all_;
+
+    //floor(log2(max(width, height))) + 1 levels down to 1x1
+    uint32_t mip_count = 1;
+
+    if (mip_is_ && renderer->vk.texture_mip_is && !shared_is)
+    {
+        while (SPRX_MAX(width_, height_) >> mip_count)
+        {
+            mip_count++;
+        }
+    }
+
+    VkImageCreateInfo image_create_info;
+    image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    image_create_info.pNext = NULL;
+    image_create_info.flags = 0;
+    image_create_info.imageType = VK_IMAGE_TYPE_2D;
+    image_create_info.format = CNVX_VULKAN_TEXTURE_FORMAT;
+    image_create_info.extent.width = width_;
+    image_create_info.extent.height = height_;
+    image_create_info.extent.depth = 1;
+    image_create_info.mipLevels = mip_count;
+    image_create_info.arrayLayers = 1;
+    image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    image_create_info.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | (1 < mip_count ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
+    image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE; //handed from the transfer to the graphics queue once
+    image_create_info.queueFamilyIndexCount = 0;
+    image_create_info.pQueueFamilyIndices = NULL;
+    image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    uint32_t queue_family_index_all[2];
+
+    if (shared_is)
+    {
+        const uint32_t queue_family_index_count = canvas_vulkan_transfer_queue_family_indices_get(renderer, queue_family_index_all);
+
+        image_create_info.sharingMode = 1 < queue_family_index_count ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+        image_create_info.queueFamilyIndexCount = queue_family_index_count;
+        image_create_info.pQueueFamilyIndices = queue_family_index_all;
+    }
+
+    VkImage image = VK_NULL_HANDLE;
+
+    VkResult result = vkCreateImage(renderer->vk.device, &image_create_info, NULL, &image);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateImage texture");
+
+    VkMemoryRequirements memory_requirements;
+    vkGetImageMemoryRequirements(renderer->vk.device, image, &memory_requirements);
+
+    CNVX_Vulkan_Allocation_PRIVATE allocation;
+    canvas_vulkan_memory_allocate(renderer, &memory_requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, 0, false, &allocation);
+
+    result = vkBindImageMemory(renderer->vk.device, image, allocation.memory, allocation.offset);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkBindImageMemory texture");
+
+    VkImageViewCreateInfo image_view_create_info;
+    image_view_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    image_view_create_info.pNext = NULL;
+    image_view_create_info.flags = 0;
+    image_view_create_info.image = image;
+    image_view_create_info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    image_view_create_info.format = CNVX_VULKAN_TEXTURE_FORMAT;
+    image_view_create_info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+    image_view_create_info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_view_create_info.subresourceRange.baseMipLevel = 0;
+    image_view_create_info.subresourceRange.levelCount = mip_count;
+    image_view_create_info.subresourceRange.baseArrayLayer = 0;
+    image_view_create_info.subresourceRange.layerCount = 1;
+
+    VkImageView image_view = VK_NULL_HANDLE;
+
+    result = vkCreateImageView(renderer->vk.device, &image_view_create_info, NULL, &image_view);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateImageView texture");
+
+    const CNVX_Vulkan_Descriptor_Sampler_PRIVATE sampler = CNVX_RENDERER_TEXTURE_FILTER_NEAREST == filter_ ? CNVX_VULKAN_DESCRIPTOR_SAMPLER_NEAREST : CNVX_VULKAN_DESCRIPTOR_SAMPLER_LINEAR;
+
+    const uint32_t texture_index = canvas_vulkan_descriptor_texture_register(renderer, image_view, shared_is ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, renderer->vk.descriptor_sampler_all[sampler]);
+
+    CNVX_Vulkan_Texture_PRIVATE* const texture = &renderer->vk.texture_all[texture_index];
+    texture->live_is = true;
+    texture->defined_is = false;
+    texture->shared_is = shared_is;
+    texture->image = image;
+    texture->image_view = image_view;
+    texture->allocation = allocation;
+    texture->width = width_;
+    texture->height = height_;
+    texture->mip_count = mip_count;
+
+    if (!shared_is)
+    {
+        canvas_vulkan_texture_upload_PRIVATE(renderer, texture_index, 0, 0, pixel_all_, width_, height_, 0);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: texture %u of %ux%u with %u mips", texture_index, width_, height_, mip_count);
+
+    return texture_index;
+}
+
+void canvas_vulkan_texture_delete(void* const renderer_, const uint32_t texture_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->vk.descriptor_count_all[CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE] > texture_index_, CNVX_VULKAN_ERROR_ARGUMENT("texture_index has to be <texture count"));
+
+    CNVX_Vulkan_Texture_PRIVATE* const texture = &renderer->vk.texture_all[texture_index_];
+
+    SPRX_ASSERT(texture->live_is, CNVX_VULKAN_ERROR_LOGIC("failed to delete texture", "texture is not alive", NULL));
+
+    //pending uploads notice the cleared image and are skipped
+    canvas_vulkan_deferred_image_view_release(renderer, texture->image_view);
+    canvas_vulkan_deferred_image_release(renderer, texture->image, &texture->allocation);
+    canvas_vulkan_descriptor_release(renderer, CNVX_VULKAN_DESCRIPTOR_BINDING_TEXTURE, texture_index_);
+
+    memset(texture, 0, sizeof(*texture));
+}
+
+void canvas_vulkan_texture_atlas_region_PRIVATE(void* const renderer_, const CNVX_Atlas_Entry_PRIVATE* const entry_, CNVX_Renderer_Atlas_Region* const region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != entry_, CNVX_VULKAN_ERROR_NULL("entry"));
+    SPRX_ASSERT(NULL != region_, CNVX_VULKAN_ERROR_NULL("region"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Atlas_Page_PRIVATE* const page = &renderer->atlas.page_all[entry_->page];
+
+    //drawn by the frame being built, which protects the page from eviction
+    page->use_serial = renderer->vk.frame_serial + 1;
+
+    const float scale = 1.0f / (float)renderer->atlas.page_size;
+
+    region_->texture_index = page->texture_index;
+    region_->uv[0] = (float)(entry_->x + CNVX_ATLAS_PADDING) * scale;
+    region_->uv[1] = (float)(entry_->y + CNVX_ATLAS_PADDING) * scale;
+    region_->uv[2] = (float)(entry_->x + entry_->width - CNVX_ATLAS_PADDING) * scale;
+    region_->uv[3] = (float)(entry_->y + entry_->height - CNVX_ATLAS_PADDING) * scale;
+}
+
+bool canvas_vulkan_texture_atlas_insert(void* const renderer_, const uint64_t key_, const void* const pixel_all_, const uint32_t width_, const uint32_t height_, CNVX_Renderer_Atlas_Region* const region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != pixel_all_, CNVX_VULKAN_ERROR_NULL("pixel_all"));
+    SPRX_ASSERT(0 != width_ && 0 != height_, CNVX_VULKAN_ERROR_ARGUMENT("width and height have to be >0"));
+    SPRX_ASSERT(NULL != region_, CNVX_VULKAN_ERROR_NULL("region"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+    CNVX_Atlas_PRIVATE* const atlas = &renderer->atlas;
+
+    if (canvas_vulkan_texture_atlas_get(renderer, key_, region_))
+    {
+        return true;
+    }
+
+    const uint32_t cell_width = width_ + 2 * CNVX_ATLAS_PADDING;
+    const uint32_t cell_height = height_ + 2 * CNVX_ATLAS_PADDING;
+
+    if (cell_width > atlas->page_size || cell_height > atlas->page_size)
+    {
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: atlas image of %ux%u does not fit into a page", width_, height_);
+
+        return false;
+    }
+
+    uint32_t page = atlas->page_count;
+    uint32_t x = 0;
+    uint32_t y = 0;
+
+    for (uint32_t i = 0; i < atlas->page_count; i++)
+    {
+        if (canvas_atlas_page_pack(atlas, i, cell_width, cell_height, &x, &y))
+        {
+            page = i;
+            break;
+        }
+    }
+
+    if (atlas->page_count == page && CNVX_RENDERER_ATLAS_PAGE_COUNT_MAX > atlas->page_count)
+    {
+        atlas->page_all[page].live_is = true;
+        atlas->page_all[page].texture_index = canvas_vulkan_texture_new(renderer, NULL, atlas->page_size, atlas->page_size, false, CNVX_RENDERER_TEXTURE_FILTER_LINEAR);
+        atlas->page_count++;
+
+        canvas_atlas_page_pack(atlas, page, cell_width, cell_height, &x, &y);
+    }
+    else if (atlas->page_count == page)
+    {
+        //the transfer queue is not ordered behind the graphics queue, so only pages no frame in flight draws can be overwritten
+        uint64_t serial_done = 0;
+
+        for (uint32_t i = 0; i < CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX; i++)
+        {
+            serial_done = SPRX_MAX(serial_done, renderer->vk.frame_serial_done_all[i]);
+        }
+
+        for (uint32_t i = 0; i < atlas->page_count; i++)
+        {
+            if (serial_done >= atlas->page_all[i].use_serial && (atlas->page_count == page || atlas->page_all[page].use_serial > atlas->page_all[i].use_serial))
+            {
+                page = i;
+            }
+        }
+
+        if (atlas->page_count == page)
+        {
+            CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "vulkan: atlas is full with pages all drawn by frames in flight");
+
+            return false;
+        }
+
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: atlas evicts page %u", page);
+
+        canvas_atlas_page_evict(atlas, page);
+        canvas_atlas_page_pack(atlas, page, cell_width, cell_height, &x, &y);
+    }
+
+    const CNVX_Atlas_Entry_PRIVATE* const entry = canvas_atlas_insert(atlas, key_, page, x, y, cell_width, cell_height);
+
+    canvas_vulkan_texture_upload_PRIVATE(renderer, atlas->page_all[page].texture_index, x, y, pixel_all_, width_, height_, CNVX_ATLAS_PADDING);
+    canvas_vulkan_texture_atlas_region_PRIVATE(renderer, entry, region_);
+
+    return true;
+}
+
+bool canvas_vulkan_texture_atlas_get(void* const renderer_, const uint64_t key_, CNVX_Renderer_Atlas_Region* const region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != region_, CNVX_VULKAN_ERROR_NULL("region"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const CNVX_Atlas_Entry_PRIVATE* const entry = canvas_atlas_find(&renderer->atlas, key_);
+
+    if (NULL == entry)
+    {
+        return false;
+    }
+
+    canvas_vulkan_texture_atlas_region_PRIVATE(renderer, entry, region_);
+
+    return true;
+}
+
+void canvas_vulkan_texture_barrier_PRIVATE(const VkCommandBuffer commandbuffer_, const VkImage image_, const uint32_t mip_first_, const uint32_t mip_count_, const VkImageLayout layout_old_, const VkImageLayout layout_new_, const VkAccessFlags access_src_, const VkAccessFlags access_dst_, const VkPipelineStageFlags stage_src_, const VkPipelineStageFlags stage_dst_)
+{
+    VkImageMemoryBarrier image_memory_barrier;
+    image_memory_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_memory_barrier.pNext = NULL;
+    image_memory_barrier.srcAccessMask = access_src_;
+    image_memory_barrier.dstAccessMask = access_dst_;
+    image_memory_barrier.oldLayout = layout_old_;
+    image_memory_barrier.newLayout = layout_new_;
+    image_memory_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_memory_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    image_memory_barrier.image = image_;
+    image_memory_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_memory_barrier.subresourceRange.baseMipLevel = mip_first_;
+    image_memory_barrier.subresourceRange.levelCount = mip_count_;
+    image_memory_barrier.subresourceRange.baseArrayLayer = 0;
+    image_memory_barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandbuffer_, stage_src_, stage_dst_, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
+}
+
+void canvas_vulkan_texture_record(void* const renderer_, const VkCommandBuffer commandbuffer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const size_t upload_count = spore_vector_size(renderer->vk.texture_upload_vec);
+
+    const VkPipelineStageFlags stage_shader = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
+    for (size_t i = 0; i < upload_count; i++)
+    {
+        const CNVX_Vulkan_Texture_Upload_PRIVATE* const upload = SPRX_VECTOR_AT(renderer->vk.texture_upload_vec, i, CNVX_Vulkan_Texture_Upload_PRIVATE);
+        CNVX_Vulkan_Texture_PRIVATE* const texture = &renderer->vk.texture_all[upload->texture_index];
+
+        if (texture->image != upload->image)
+        {
+            continue;
+        }
+
+        //mip 0 was copied by the transfer queue, the submission waits for it
+        canvas_vulkan_transfer_image_acquire(renderer, commandbuffer_, texture->image, texture->mip_count, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+        //every level is blitted from the one above, which then becomes readable by the shaders
+        for (uint32_t k = 1; k < texture->mip_count; k++)
+        {
+            canvas_vulkan_texture_barrier_PRIVATE(commandbuffer_, texture->image, k - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+
+            VkImageBlit image_blit;
+            image_blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            image_blit.srcSubresource.mipLevel = k - 1;
+            image_blit.srcSubresource.baseArrayLayer = 0;
+            image_blit.srcSubresource.layerCount = 1;
+            image_blit.srcOffsets[0] = (VkOffset3D){ 0, 0, 0 };
+            image_blit.srcOffsets[1] = (VkOffset3D){ (int32_t)SPRX_MAX(texture->width >> (k - 1), 1u), (int32_t)SPRX_MAX(texture->height >> (k - 1), 1u), 1 };
+            image_blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            image_blit.dstSubresource.mipLevel = k;
+            image_blit.dstSubresource.baseArrayLayer = 0;
+            image_blit.dstSubresource.layerCount = 1;
+            image_blit.dstOffsets[0] = (VkOffset3D){ 0, 0, 0 };
+            image_blit.dstOffsets[1] = (VkOffset3D){ (int32_t)SPRX_MAX(texture->width >> k, 1u), (int32_t)SPRX_MAX(texture->height >> k, 1u), 1 };
+
+            vkCmdBlitImage(commandbuffer_, texture->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, texture->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &image_blit, VK_FILTER_LINEAR);
+
+            canvas_vulkan_texture_barrier_PRIVATE(commandbuffer_, texture->image, k - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_READ_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, stage_shader);
+        }
+
+        canvas_vulkan_texture_barrier_PRIVATE(commandbuffer_, texture->image, texture->mip_count - 1, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, stage_shader);
+
+        texture->defined_is = true;
+    }
+}
+
+void canvas_vulkan_texture_submitted(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_vector_clear_reserve(renderer->vk.texture_upload_vec, CNVX_VULKAN_TEXTURE_UPLOAD_GROWTH);
+}
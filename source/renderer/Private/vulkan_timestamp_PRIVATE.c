@@ -0,0 +1,324 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_timestamp_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/container/vector.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+void canvas_vulkan_timestamp_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: timestamp creation");
+
+    renderer->vk.timestamp_querypool = VK_NULL_HANDLE;
+    memset(renderer->vk.timestamp_history_all, 0, sizeof(renderer->vk.timestamp_history_all));
+    canvas_vulkan_timestamp_region_clear(renderer);
+
+    const uint32_t valid_bits = renderer->vk.queue_family_properties[renderer->vk.queue_family_use_index].timestampValidBits;
+
+    if (0 == valid_bits)
+    {
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_INFO, spore_string_substr(renderer->name, 7), "vulkan: graphics queue does not support timestamps");
+        return;
+    }
+
+    renderer->vk.timestamp_mask = 64 <= valid_bits ? UINT64_MAX : (((uint64_t)1 << valid_bits) - 1);
+    renderer->vk.timestamp_period = renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index].limits.timestampPeriod;
+
+    VkQueryPoolCreateInfo query_pool_create_info;
+    query_pool_create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    query_pool_create_info.pNext = NULL;
+    query_pool_create_info.flags = 0;
+    query_pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    query_pool_create_info.queryCount = renderer->vk.frame_count * ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX;
+    query_pool_create_info.pipelineStatistics = 0;
+
+    VkResult result = vkCreateQueryPool(renderer->vk.device, &query_pool_create_info, NULL, &renderer->vk.timestamp_querypool);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateQueryPool");
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: timestamp period is %fns with %u valid bits", renderer->vk.timestamp_period, valid_bits);
+}
+
+void canvas_vulkan_timestamp_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (VK_NULL_HANDLE != renderer->vk.timestamp_querypool)
+    {
+        vkDestroyQueryPool(renderer->vk.device, renderer->vk.timestamp_querypool, NULL);
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyQueryPool");
+
+        renderer->vk.timestamp_querypool = VK_NULL_HANDLE;
+    }
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: timestamp destruction");
+}
+
+void canvas_vulkan_timestamp_reset(void* const renderer_, const VkCommandBuffer commandbuffer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (VK_NULL_HANDLE == renderer->vk.timestamp_querypool)
+    {
+        return;
+    }
+
+    vkCmdResetQueryPool(commandbuffer_, renderer->vk.timestamp_querypool, renderer->vk.frame_index * ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX, ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX);
+}
+
+void canvas_vulkan_timestamp_write(void* const renderer_, const VkCommandBuffer commandbuffer_, const CNVX_Vulkan_Timestamp_Query_PRIVATE query_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(___CNVX_VULKAN_TIMESTAMP_QUERY_MAX > query_, CNVX_VULKAN_ERROR_ARGUMENT("invalid value of query"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (VK_NULL_HANDLE == renderer->vk.timestamp_querypool)
+    {
+        return;
+    }
+
+    const VkPipelineStageFlagBits stage = 0 == query_ % 2 ? VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+
+    vkCmdWriteTimestamp(commandbuffer_, stage, renderer->vk.timestamp_querypool, renderer->vk.frame_index * ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX + query_);
+}
+
+void canvas_vulkan_timestamp_region_write(void* const renderer_, const VkCommandBuffer commandbuffer_, const size_t draw_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (0 == renderer->vk.timestamp_region_ended_mask || VK_NULL_HANDLE == renderer->vk.timestamp_querypool)
+    {
+        return;
+    }
+
+    //only closed regions are written, so every query of a region is written exactly once
+    for (uint32_t i = 0; i < CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX; i++)
+    {
+        if (!((1u << i) & renderer->vk.timestamp_region_ended_mask))
+        {
+            continue;
+        }
+
+        if (draw_index_ == renderer->vk.timestamp_region_draw_first_all[i])
+        {
+            canvas_vulkan_timestamp_write(renderer, commandbuffer_, CNVX_VULKAN_TIMESTAMP_QUERY_REGION_FIRST + 2 * i);
+        }
+
+        if (draw_index_ == renderer->vk.timestamp_region_draw_last_all[i])
+        {
+            canvas_vulkan_timestamp_write(renderer, commandbuffer_, CNVX_VULKAN_TIMESTAMP_QUERY_REGION_FIRST + 2 * i + 1);
+        }
+    }
+}
+
+void canvas_vulkan_timestamp_history_push_PRIVATE(CNVX_Vulkan_Timestamp_History_PRIVATE* const history_, const float sample_)
+{
+    SPRX_ASSERT(NULL != history_, CNVX_VULKAN_ERROR_NULL("history"));
+
+    history_->sample_all[history_->sample_index] = sample_;
+    history_->sample_index = (history_->sample_index + 1) % CNVX_RENDERER_TIMESTAMP_HISTORY_COUNT;
+    history_->sample_count = SPRX_MIN(history_->sample_count + 1, CNVX_RENDERER_TIMESTAMP_HISTORY_COUNT);
+}
+
+void canvas_vulkan_timestamp_collect(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //nothing was recorded into this slot yet
+    if (VK_NULL_HANDLE == renderer->vk.timestamp_querypool || 0 == renderer->vk.frame_serial_submitted_all[renderer->vk.frame_index])
+    {
+        return;
+    }
+
+    //value and availability per query, regions not used in that frame stay unavailable
+    uint64_t result_all[___CNVX_VULKAN_TIMESTAMP_QUERY_MAX][2];
+
+    const VkResult result = vkGetQueryPoolResults(renderer->vk.device, renderer->vk.timestamp_querypool, renderer->vk.frame_index * ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX, ___CNVX_VULKAN_TIMESTAMP_QUERY_MAX, sizeof(result_all), result_all, sizeof(result_all[0]), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (VK_NOT_READY != result)
+    {
+        CNVX_VULKAN_QASSERT(renderer, result, "vkGetQueryPoolResults");
+    }
+
+    for (uint32_t i = 0; i < CNVX_VULKAN_TIMESTAMP_SERIES_COUNT; i++)
+    {
+        const uint64_t* const begin = result_all[2 * i];
+        const uint64_t* const end = result_all[2 * i + 1];
+
+        if (0 == begin[1] || 0 == end[1])
+        {
+            continue;
+        }
+
+        const uint64_t tick_count = (end[0] - begin[0]) & renderer->vk.timestamp_mask;
+
+        canvas_vulkan_timestamp_history_push_PRIVATE(&renderer->vk.timestamp_history_all[i], (float)((double)tick_count * renderer->vk.timestamp_period * 1e-6));
+    }
+}
+
+void canvas_vulkan_timestamp_region_begin(void* const renderer_, const uint32_t region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX > region_, CNVX_VULKAN_ERROR_ARGUMENT("region has to be <CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(!((1u << region_) & renderer->vk.timestamp_region_begun_mask), CNVX_VULKAN_ERROR_LOGIC("failed to begin region", "region can only be used once per frame", NULL));
+
+    renderer->vk.timestamp_region_draw_first_all[region_] = spore_vector_size(renderer->draw_vec);
+    renderer->vk.timestamp_region_begun_mask |= 1u << region_;
+}
+
+void canvas_vulkan_timestamp_region_end(void* const renderer_, const uint32_t region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX > region_, CNVX_VULKAN_ERROR_ARGUMENT("region has to be <CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT((1u << region_) & renderer->vk.timestamp_region_begun_mask, CNVX_VULKAN_ERROR_LOGIC("failed to end region", "region has to be begun", NULL));
+    SPRX_ASSERT(!((1u << region_) & renderer->vk.timestamp_region_ended_mask), CNVX_VULKAN_ERROR_LOGIC("failed to end region", "region can only be used once per frame", NULL));
+
+    renderer->vk.timestamp_region_draw_last_all[region_] = spore_vector_size(renderer->draw_vec);
+    renderer->vk.timestamp_region_ended_mask |= 1u << region_;
+}
+
+void canvas_vulkan_timestamp_region_clear(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    renderer->vk.timestamp_region_begun_mask = 0;
+    renderer->vk.timestamp_region_ended_mask = 0;
+}
+
+bool canvas_vulkan_timestamp_region_boundary_is(void* const renderer_, const size_t draw_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    for (uint32_t i = 0; i < CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX; i++)
+    {
+        if ((1u << i) & renderer->vk.timestamp_region_begun_mask && draw_index_ == renderer->vk.timestamp_region_draw_first_all[i])
+        {
+            return true;
+        }
+
+        if ((1u << i) & renderer->vk.timestamp_region_ended_mask && draw_index_ == renderer->vk.timestamp_region_draw_last_all[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int canvas_vulkan_timestamp_sample_compare_PRIVATE(const void* const a_, const void* const b_)
+{
+    const float a = *(const float*)a_;
+    const float b = *(const float*)b_;
+
+    return (a > b) - (a < b);
+}
+
+CNVX_Renderer_Timestamp_Series_Stats canvas_vulkan_timestamp_series_stats_get_PRIVATE(const CNVX_Vulkan_Timestamp_History_PRIVATE* const history_)
+{
+    SPRX_ASSERT(NULL != history_, CNVX_VULKAN_ERROR_NULL("history"));
+
+    CNVX_Renderer_Timestamp_Series_Stats stats;
+    memset(&stats, 0, sizeof(stats));
+
+    stats.sample_count = history_->sample_count;
+
+    if (0 == history_->sample_count)
+    {
+        return stats;
+    }
+
+    float sample_all[CNVX_RENDERER_TIMESTAMP_HISTORY_COUNT];
+    memcpy(sample_all, history_->sample_all, sizeof(*sample_all) * history_->sample_count);
+
+    qsort(sample_all, history_->sample_count, sizeof(*sample_all), canvas_vulkan_timestamp_sample_compare_PRIVATE);
+
+    double sum = 0.0;
+
+    for (uint32_t i = 0; i < history_->sample_count; i++)
+    {
+        sum += sample_all[i];
+    }
+
+    //nearest rank, with few samples the p99 is simply the maximum
+    const size_t rank = (99 * (size_t)history_->sample_count + 99) / 100;
+
+    stats.min = sample_all[0];
+    stats.avg = sum / history_->sample_count;
+    stats.p99 = sample_all[rank - 1];
+
+    return stats;
+}
+
+CNVX_Renderer_Timestamp_Stats canvas_vulkan_timestamp_stats_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Renderer_Timestamp_Stats stats;
+    stats.supported_is = VK_NULL_HANDLE != renderer->vk.timestamp_querypool;
+    stats.frame = canvas_vulkan_timestamp_series_stats_get_PRIVATE(&renderer->vk.timestamp_history_all[0]);
+    stats.pass = canvas_vulkan_timestamp_series_stats_get_PRIVATE(&renderer->vk.timestamp_history_all[1]);
+
+    for (uint32_t i = 0; i < CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX; i++)
+    {
+        stats.region_all[i] = canvas_vulkan_timestamp_series_stats_get_PRIVATE(&renderer->vk.timestamp_history_all[2 + i]);
+    }
+
+    return stats;
+}
@@ -0,0 +1,561 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_transfer_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+#define CNVX_VULKAN_TRANSFER_STAGING_ALIGNMENT 16
+
+void canvas_vulkan_transfer_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: transfer creation");
+
+    VkCommandPoolCreateInfo command_pool_create_info;
+    command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_create_info.pNext = NULL;
+    command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    command_pool_create_info.queueFamilyIndex = renderer->vk.queue_family_transfer_index;
+
+    VkResult result = vkCreateCommandPool(renderer->vk.device, &command_pool_create_info, NULL, &renderer->vk.transfer_commandpool);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateCommandPool");
+
+    VkCommandBufferAllocateInfo command_buffer_allocate_info;
+    command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_allocate_info.pNext = NULL;
+    command_buffer_allocate_info.commandPool = renderer->vk.transfer_commandpool;
+    command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_allocate_info.commandBufferCount = 1;
+
+    VkFenceCreateInfo fence_create_info;
+    fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fence_create_info.pNext = NULL;
+    fence_create_info.flags = 0;
+
+    for (uint32_t i = 0; i < CNVX_VULKAN_TRANSFER_BATCH_COUNT; i++)
+    {
+        result = vkAllocateCommandBuffers(renderer->vk.device, &command_buffer_allocate_info, &renderer->vk.transfer_batch_all[i].commandbuffer);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkAllocateCommandBuffers (%u/%u)", i + 1, CNVX_VULKAN_TRANSFER_BATCH_COUNT);
+
+        result = vkCreateFence(renderer->vk.device, &fence_create_info, NULL, &renderer->vk.transfer_batch_all[i].fence);
+        CNVX_VULKAN_ASSERTF(renderer, result, "vkCreateFence (%u/%u)", i + 1, CNVX_VULKAN_TRANSFER_BATCH_COUNT);
+
+        renderer->vk.transfer_batch_all[i].staging_size = 0;
+        renderer->vk.transfer_batch_all[i].pending_is = false;
+    }
+
+    renderer->vk.transfer_batch_index = 0;
+    renderer->vk.transfer_batch_retire_index = 0;
+    renderer->vk.transfer_batch_open_is = false;
+
+    renderer->vk.transfer_semaphore = VK_NULL_HANDLE;
+    renderer->vk.transfer_value = 0;
+    renderer->vk.transfer_value_waited = 0;
+
+    if (renderer->vk.transfer_dedicated_is)
+    {
+        VkSemaphoreTypeCreateInfo semaphore_type_create_info;
+        semaphore_type_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+        semaphore_type_create_info.pNext = NULL;
+        semaphore_type_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        semaphore_type_create_info.initialValue = 0;
+
+        VkSemaphoreCreateInfo semaphore_create_info;
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+        semaphore_create_info.pNext = &semaphore_type_create_info;
+        semaphore_create_info.flags = 0;
+
+        result = vkCreateSemaphore(renderer->vk.device, &semaphore_create_info, NULL, &renderer->vk.transfer_semaphore);
+        CNVX_VULKAN_ASSERT(renderer, result, "vkCreateSemaphore");
+    }
+
+    renderer->vk.transfer_staging_size = 0 != renderer->settings.transfer_staging_size ? renderer->settings.transfer_staging_size : CNVX_RENDERER_TRANSFER_STAGING_SIZE_DEFAULT;
+    renderer->vk.transfer_staging_head = 0;
+    renderer->vk.transfer_staging_used = 0;
+
+    VkBufferCreateInfo buffer_create_info;
+    buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    buffer_create_info.pNext = NULL;
+    buffer_create_info.flags = 0;
+    buffer_create_info.size = renderer->vk.transfer_staging_size;
+    buffer_create_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    buffer_create_info.queueFamilyIndexCount = 0;
+    buffer_create_info.pQueueFamilyIndices = NULL;
+
+    result = vkCreateBuffer(renderer->vk.device, &buffer_create_info, NULL, &renderer->vk.transfer_staging_buffer);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateBuffer");
+
+    VkMemoryRequirements memory_requirements;
+    vkGetBufferMemoryRequirements(renderer->vk.device, renderer->vk.transfer_staging_buffer, &memory_requirements);
+
+    //the allocator keeps host visible memory mapped for the lifetime of the renderer
+    canvas_vulkan_memory_allocate(renderer, &memory_requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0, true, &renderer->vk.transfer_staging_allocation);
+
+    result = vkBindBufferMemory(renderer->vk.device, renderer->vk.transfer_staging_buffer, renderer->vk.transfer_staging_allocation.memory, renderer->vk.transfer_staging_allocation.offset);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkBindBufferMemory");
+
+    renderer->vk.transfer_staging_data = renderer->vk.transfer_staging_allocation.data;
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: %lluKiB staging ring, uploads on %s", (unsigned long long)(renderer->vk.transfer_staging_size >> 10), renderer->vk.transfer_dedicated_is ? "dedicated transfer queue" : "graphics queue");
+}
+
+//returns false if the oldest batch is still in flight and wait_is is not set
+bool canvas_vulkan_transfer_batch_retire_PRIVATE(void* const renderer_, const bool wait_is)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Vulkan_Transfer_Batch_PRIVATE* const batch = &renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_retire_index];
+
+    if (!batch->pending_is)
+    {
+        return false;
+    }
+
+    if (wait_is)
+    {
+        VkResult result = vkWaitForFences(renderer->vk.device, 1, &batch->fence, VK_TRUE, UINT64_MAX);
+        CNVX_VULKAN_QASSERT(renderer, result, "vkWaitForFences");
+    }
+    else if (VK_SUCCESS != vkGetFenceStatus(renderer->vk.device, batch->fence))
+    {
+        return false;
+    }
+
+    VkResult result = vkResetFences(renderer->vk.device, 1, &batch->fence);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkResetFences");
+
+    renderer->vk.transfer_staging_used -= batch->staging_size;
+
+    batch->staging_size = 0;
+    batch->pending_is = false;
+
+    renderer->vk.transfer_batch_retire_index = (renderer->vk.transfer_batch_retire_index + 1) % CNVX_VULKAN_TRANSFER_BATCH_COUNT;
+
+    return true;
+}
+
+void canvas_vulkan_transfer_batch_open_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (renderer->vk.transfer_batch_open_is)
+    {
+        return;
+    }
+
+    CNVX_Vulkan_Transfer_Batch_PRIVATE* const batch = &renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index];
+
+    //all batches are in flight, the oldest one is the one about to be reused
+    while (batch->pending_is)
+    {
+        canvas_vulkan_transfer_batch_retire_PRIVATE(renderer, true);
+    }
+
+    VkCommandBufferBeginInfo command_buffer_begin_info;
+    command_buffer_begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    command_buffer_begin_info.pNext = NULL;
+    command_buffer_begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    command_buffer_begin_info.pInheritanceInfo = NULL;
+
+    VkResult result = vkBeginCommandBuffer(batch->commandbuffer, &command_buffer_begin_info);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkBeginCommandBuffer");
+
+    renderer->vk.transfer_batch_open_is = true;
+}
+
+//returns false if the ring has no contiguous range of size bytes left
+bool canvas_vulkan_transfer_staging_allocate_PRIVATE(void* const renderer_, const VkDeviceSize size_, VkDeviceSize* const offset_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != offset_, CNVX_VULKAN_ERROR_NULL("offset"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const VkDeviceSize capacity = renderer->vk.transfer_staging_size;
+
+    if (0 == renderer->vk.transfer_staging_used)
+    {
+        renderer->vk.transfer_staging_head = 0;
+    }
+
+    if (renderer->vk.transfer_staging_used + size_ > capacity)
+    {
+        return false;
+    }
+
+    const VkDeviceSize head = renderer->vk.transfer_staging_head;
+    const VkDeviceSize tail = (head + capacity - renderer->vk.transfer_staging_used) % capacity;
+
+    VkDeviceSize waste = 0;
+
+    if (head >= tail)
+    {
+        if (capacity - head < size_)
+        {
+            if (tail < size_)
+            {
+                return false;
+            }
+
+            //the remainder at the end is skipped and freed together with this batch
+            waste = capacity - head;
+        }
+    }
+    else if (tail - head < size_)
+    {
+        return false;
+    }
+
+    *offset_ = (head + waste) % capacity;
+
+    const VkDeviceSize consumed = SPRX_MIN(waste + (size_ + CNVX_VULKAN_TRANSFER_STAGING_ALIGNMENT - 1) / CNVX_VULKAN_TRANSFER_STAGING_ALIGNMENT * CNVX_VULKAN_TRANSFER_STAGING_ALIGNMENT, capacity - renderer->vk.transfer_staging_used);
+
+    renderer->vk.transfer_staging_head = (head + consumed) % capacity;
+    renderer->vk.transfer_staging_used += consumed;
+    renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index].staging_size += consumed;
+
+    return true;
+}
+
+void* canvas_vulkan_transfer_staging_reserve_PRIVATE(void* const renderer_, const VkDeviceSize size_, VkDeviceSize* const offset_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_transfer_batch_open_PRIVATE(renderer);
+
+    while (!canvas_vulkan_transfer_staging_allocate_PRIVATE(renderer, size_, offset_))
+    {
+        if (0 != renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index].staging_size)
+        {
+            //the open batch holds the range we are short of
+            canvas_vulkan_transfer_flush(renderer);
+            canvas_vulkan_transfer_batch_open_PRIVATE(renderer);
+        }
+        else
+        {
+            canvas_vulkan_transfer_batch_retire_PRIVATE(renderer, true);
+        }
+    }
+
+    return (char*)renderer->vk.transfer_staging_data + *offset_;
+}
+
+void canvas_vulkan_transfer_buffer_upload(void* const renderer_, const VkBuffer buffer_, const VkDeviceSize offset_, const void* const data_, const VkDeviceSize size_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != data_, CNVX_VULKAN_ERROR_NULL("data"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //half the ring per chunk keeps the other half free for the batch in flight
+    const VkDeviceSize chunk_size_max = SPRX_MAX(renderer->vk.transfer_staging_size / 2, CNVX_VULKAN_TRANSFER_STAGING_ALIGNMENT);
+
+    VkDeviceSize done = 0;
+
+    while (done < size_)
+    {
+        const VkDeviceSize chunk_size = SPRX_MIN(size_ - done, chunk_size_max);
+
+        VkDeviceSize staging_offset = 0;
+        void* const staging = canvas_vulkan_transfer_staging_reserve_PRIVATE(renderer, chunk_size, &staging_offset);
+
+        memcpy(staging, (const char*)data_ + done, chunk_size);
+
+        VkBufferCopy buffer_copy;
+        buffer_copy.srcOffset = staging_offset;
+        buffer_copy.dstOffset = offset_ + done;
+        buffer_copy.size = chunk_size;
+
+        vkCmdCopyBuffer(renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index].commandbuffer, renderer->vk.transfer_staging_buffer, buffer_, 1, &buffer_copy);
+
+        done += chunk_size;
+    }
+}
+
+void canvas_vulkan_transfer_image_barrier_PRIVATE(const VkCommandBuffer commandbuffer_, const VkImage image_, const uint32_t mip_count_, const VkImageLayout layout_old_, const VkImageLayout layout_new_, const VkAccessFlags access_src_, const VkAccessFlags access_dst_, const VkPipelineStageFlags stage_src_, const VkPipelineStageFlags stage_dst_, const uint32_t queue_family_src_, const uint32_t queue_family_dst_)
+{
+    VkImageMemoryBarrier image_memory_barrier;
+    image_memory_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    image_memory_barrier.pNext = NULL;
+    image_memory_barrier.srcAccessMask = access_src_;
+    image_memory_barrier.dstAccessMask = access_dst_;
+    image_memory_barrier.oldLayout = layout_old_;
+    image_memory_barrier.newLayout = layout_new_;
+    image_memory_barrier.srcQueueFamilyIndex = queue_family_src_;
+    image_memory_barrier.dstQueueFamilyIndex = queue_family_dst_;
+    image_memory_barrier.image = image_;
+    image_memory_barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    image_memory_barrier.subresourceRange.baseMipLevel = 0;
+    image_memory_barrier.subresourceRange.levelCount = mip_count_;
+    image_memory_barrier.subresourceRange.baseArrayLayer = 0;
+    image_memory_barrier.subresourceRange.layerCount = 1;
+
+    vkCmdPipelineBarrier(commandbuffer_, stage_src_, stage_dst_, 0, 0, NULL, 0, NULL, 1, &image_memory_barrier);
+}
+
+void canvas_vulkan_transfer_image_upload(void* const renderer_, const VkImage image_, const uint32_t mip_count_, const VkImageLayout layout_old_, const VkImageLayout layout_, const bool release_is_, const uint32_t x_, const uint32_t y_, const uint32_t width_, const uint32_t height_, const uint32_t texel_size_, const void* const data_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != data_, CNVX_VULKAN_ERROR_NULL("data"));
+    SPRX_ASSERT(0 != width_ && 0 != height_ && 0 != texel_size_, CNVX_VULKAN_ERROR_ARGUMENT("width, height and texel_size have to be >0"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const VkDeviceSize row_size = (VkDeviceSize)width_ * texel_size_;
+
+    SPRX_ASSERT(renderer->vk.transfer_staging_size >= row_size, CNVX_VULKAN_ERROR_ARGUMENT("a row has to fit into the staging ring"));
+
+    //whole rows per chunk, at most half the ring unless a single row is larger
+    const uint32_t chunk_row_count = (uint32_t)SPRX_MIN(SPRX_MAX(renderer->vk.transfer_staging_size / 2 / row_size, 1), height_);
+
+    canvas_vulkan_transfer_batch_open_PRIVATE(renderer);
+
+    //orders behind earlier copies into the image on this queue, undefined discards the old contents
+    canvas_vulkan_transfer_image_barrier_PRIVATE(renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index].commandbuffer, image_, mip_count_, layout_old_, layout_, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED);
+
+    uint32_t done = 0;
+
+    while (done < height_)
+    {
+        const uint32_t row_count = SPRX_MIN(height_ - done, chunk_row_count);
+
+        VkDeviceSize staging_offset = 0;
+        void* const staging = canvas_vulkan_transfer_staging_reserve_PRIVATE(renderer, row_count * row_size, &staging_offset);
+
+        memcpy(staging, (const char*)data_ + done * row_size, row_count * row_size);
+
+        VkBufferImageCopy buffer_image_copy;
+        buffer_image_copy.bufferOffset = staging_offset;
+        buffer_image_copy.bufferRowLength = 0;
+        buffer_image_copy.bufferImageHeight = 0;
+        buffer_image_copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        buffer_image_copy.imageSubresource.mipLevel = 0;
+        buffer_image_copy.imageSubresource.baseArrayLayer = 0;
+        buffer_image_copy.imageSubresource.layerCount = 1;
+        buffer_image_copy.imageOffset.x = (int32_t)x_;
+        buffer_image_copy.imageOffset.y = (int32_t)(y_ + done);
+        buffer_image_copy.imageOffset.z = 0;
+        buffer_image_copy.imageExtent.width = width_;
+        buffer_image_copy.imageExtent.height = row_count;
+        buffer_image_copy.imageExtent.depth = 1;
+
+        //a full ring may have flushed the batch the barrier went into, the queue keeps them in order
+        vkCmdCopyBufferToImage(renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index].commandbuffer, renderer->vk.transfer_staging_buffer, image_, layout_, 1, &buffer_image_copy);
+
+        done += row_count;
+    }
+
+    if (release_is_ && renderer->vk.transfer_dedicated_is)
+    {
+        canvas_vulkan_transfer_image_barrier_PRIVATE(renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index].commandbuffer, image_, mip_count_, layout_, layout_, VK_ACCESS_TRANSFER_WRITE_BIT, 0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, renderer->vk.queue_family_transfer_index, renderer->vk.queue_family_use_index);
+    }
+}
+
+void canvas_vulkan_transfer_image_acquire(void* const renderer_, const VkCommandBuffer commandbuffer_, const VkImage image_, const uint32_t mip_count_, const VkImageLayout layout_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //the flush orders the copies before the frame with a memory barrier on the shared queue
+    if (!renderer->vk.transfer_dedicated_is)
+    {
+        return;
+    }
+
+    //the semaphore wait of the submission covers the release, the layouts have to match it
+    canvas_vulkan_transfer_image_barrier_PRIVATE(commandbuffer_, image_, mip_count_, layout_, layout_, 0, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, renderer->vk.queue_family_transfer_index, renderer->vk.queue_family_use_index);
+}
+
+void canvas_vulkan_transfer_flush(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //retire what finished since the last flush so the ring does not fill up
+    while (canvas_vulkan_transfer_batch_retire_PRIVATE(renderer, false))
+    {
+    }
+
+    if (!renderer->vk.transfer_batch_open_is)
+    {
+        return;
+    }
+
+    CNVX_Vulkan_Transfer_Batch_PRIVATE* const batch = &renderer->vk.transfer_batch_all[renderer->vk.transfer_batch_index];
+
+    if (!renderer->vk.transfer_dedicated_is)
+    {
+        //same queue as rendering, submission order plus this barrier makes the copies visible to later frames
+        VkMemoryBarrier memory_barrier;
+        memory_barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memory_barrier.pNext = NULL;
+        memory_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memory_barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+        vkCmdPipelineBarrier(batch->commandbuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memory_barrier, 0, NULL, 0, NULL);
+    }
+
+    VkResult result = vkEndCommandBuffer(batch->commandbuffer);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkEndCommandBuffer");
+
+    VkSubmitInfo submit_info;
+    submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submit_info.pNext = NULL;
+    submit_info.waitSemaphoreCount = 0;
+    submit_info.pWaitSemaphores = NULL;
+    submit_info.pWaitDstStageMask = NULL;
+    submit_info.commandBufferCount = 1;
+    submit_info.pCommandBuffers = &batch->commandbuffer;
+    submit_info.signalSemaphoreCount = 0;
+    submit_info.pSignalSemaphores = NULL;
+
+    VkTimelineSemaphoreSubmitInfo timeline_semaphore_submit_info;
+
+    if (renderer->vk.transfer_dedicated_is)
+    {
+        renderer->vk.transfer_value++;
+
+        timeline_semaphore_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        timeline_semaphore_submit_info.pNext = NULL;
+        timeline_semaphore_submit_info.waitSemaphoreValueCount = 0;
+        timeline_semaphore_submit_info.pWaitSemaphoreValues = NULL;
+        timeline_semaphore_submit_info.signalSemaphoreValueCount = 1;
+        timeline_semaphore_submit_info.pSignalSemaphoreValues = &renderer->vk.transfer_value;
+
+        submit_info.pNext = &timeline_semaphore_submit_info;
+        submit_info.signalSemaphoreCount = 1;
+        submit_info.pSignalSemaphores = &renderer->vk.transfer_semaphore;
+    }
+
+    result = vkQueueSubmit(renderer->vk.queue_transfer, 1, &submit_info, batch->fence);
+    CNVX_VULKAN_QASSERT(renderer, result, "vkQueueSubmit");
+
+    batch->pending_is = true;
+
+    renderer->vk.transfer_batch_open_is = false;
+    renderer->vk.transfer_batch_index = (renderer->vk.transfer_batch_index + 1) % CNVX_VULKAN_TRANSFER_BATCH_COUNT;
+}
+
+bool canvas_vulkan_transfer_wait_get(void* const renderer_, VkSemaphore* const semaphore_, uint64_t* const value_, VkPipelineStageFlags* const stage_mask_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != semaphore_, CNVX_VULKAN_ERROR_NULL("semaphore"));
+    SPRX_ASSERT(NULL != value_, CNVX_VULKAN_ERROR_NULL("value"));
+    SPRX_ASSERT(NULL != stage_mask_, CNVX_VULKAN_ERROR_NULL("stage_mask"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (!renderer->vk.transfer_dedicated_is || renderer->vk.transfer_value == renderer->vk.transfer_value_waited)
+    {
+        return false;
+    }
+
+    *semaphore_ = renderer->vk.transfer_semaphore;
+    *value_ = renderer->vk.transfer_value;
+    *stage_mask_ = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+
+    //a timeline wait covers every smaller value, later frames are ordered behind this one
+    renderer->vk.transfer_value_waited = renderer->vk.transfer_value;
+
+    return true;
+}
+
+uint32_t canvas_vulkan_transfer_queue_family_indices_get(void* const renderer_, uint32_t* const queue_family_index_all_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != queue_family_index_all_, CNVX_VULKAN_ERROR_NULL("queue_family_index_all"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    queue_family_index_all_[0] = renderer->vk.queue_family_use_index;
+
+    if (renderer->vk.queue_family_transfer_index == renderer->vk.queue_family_use_index)
+    {
+        return 1;
+    }
+
+    queue_family_index_all_[1] = renderer->vk.queue_family_transfer_index;
+
+    return 2;
+}
+
+void canvas_vulkan_transfer_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_transfer_flush(renderer);
+
+    for (uint32_t i = 0; i < CNVX_VULKAN_TRANSFER_BATCH_COUNT; i++)
+    {
+        canvas_vulkan_transfer_batch_retire_PRIVATE(renderer, true);
+    }
+
+    vkDestroyBuffer(renderer->vk.device, renderer->vk.transfer_staging_buffer, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyBuffer");
+
+    canvas_vulkan_memory_free(renderer, &renderer->vk.transfer_staging_allocation);
+
+    if (VK_NULL_HANDLE != renderer->vk.transfer_semaphore)
+    {
+        vkDestroySemaphore(renderer->vk.device, renderer->vk.transfer_semaphore, NULL);
+        CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroySemaphore");
+    }
+
+    for (uint32_t i = 0; i < CNVX_VULKAN_TRANSFER_BATCH_COUNT; i++)
+    {
+        vkDestroyFence(renderer->vk.device, renderer->vk.transfer_batch_all[i].fence, NULL);
+        CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyFence (%u/%u)", i + 1, CNVX_VULKAN_TRANSFER_BATCH_COUNT);
+    }
+
+    vkDestroyCommandPool(renderer->vk.device, renderer->vk.transfer_commandpool, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyCommandPool");
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: transfer destruction");
+}
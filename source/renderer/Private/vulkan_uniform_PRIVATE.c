@@ -0,0 +1,249 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/renderer_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_uniform_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+#include <string.h>
+
+#define CNVX_VULKAN_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("vulkan", NULL, NULL)
+#define CNVX_VULKAN_ERROR_LOGIC(what, info, care) SPRX_ERROR_LOGIC(what, "vulkan", info, care)
+#define CNVX_VULKAN_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("vulkan", NULL, care)
+#define CNVX_VULKAN_ERROR_NULL(info) SPRX_ERROR_NULL("vulkan", info)
+
+void canvas_vulkan_uniform_create(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: uniform creation");
+
+    const VkPhysicalDeviceLimits* const limits = &renderer->vk.physical_device_properties_all[renderer->vk.physical_device_use_index].limits;
+
+    SPRX_ASSERT(CNVX_RENDERER_UNIFORM_SIZE_MAX <= limits->maxUniformBufferRange, CNVX_VULKAN_ERROR_LOGIC("failed to create uniforms", "maxUniformBufferRange is too small", NULL));
+
+    renderer->vk.uniform_alignment = SPRX_MAX(limits->minUniformBufferOffsetAlignment, 16);
+
+    //identity transform until the application sets its own
+    memset(&renderer->vk.uniform_frame, 0, sizeof(renderer->vk.uniform_frame));
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        renderer->vk.uniform_frame.transform[i * 5] = 1.0f;
+    }
+
+    renderer->vk.uniform_frame_data = NULL;
+    renderer->vk.uniform_frame_offset = 0;
+    renderer->vk.uniform_draw_offset = CNVX_VULKAN_UNIFORM_OFFSET_NONE;
+
+    VkDescriptorSetLayoutBinding descriptor_set_layout_binding_all[___CNVX_VULKAN_UNIFORM_BINDING_MAX];
+
+    for (uint32_t i = 0; i < ___CNVX_VULKAN_UNIFORM_BINDING_MAX; i++)
+    {
+        descriptor_set_layout_binding_all[i].binding = i;
+        descriptor_set_layout_binding_all[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptor_set_layout_binding_all[i].descriptorCount = 1;
+        descriptor_set_layout_binding_all[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        descriptor_set_layout_binding_all[i].pImmutableSamplers = NULL;
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info;
+    descriptor_set_layout_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptor_set_layout_create_info.pNext = NULL;
+    descriptor_set_layout_create_info.flags = 0;
+    descriptor_set_layout_create_info.bindingCount = ___CNVX_VULKAN_UNIFORM_BINDING_MAX;
+    descriptor_set_layout_create_info.pBindings = descriptor_set_layout_binding_all;
+
+    VkResult result = vkCreateDescriptorSetLayout(renderer->vk.device, &descriptor_set_layout_create_info, NULL, &renderer->vk.uniform_set_layout);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDescriptorSetLayout uniform");
+
+    VkDescriptorPoolSize descriptor_pool_size;
+    descriptor_pool_size.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptor_pool_size.descriptorCount = ___CNVX_VULKAN_UNIFORM_BINDING_MAX * renderer->vk.frame_count;
+
+    VkDescriptorPoolCreateInfo descriptor_pool_create_info;
+    descriptor_pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_create_info.pNext = NULL;
+    descriptor_pool_create_info.flags = 0;
+    descriptor_pool_create_info.maxSets = renderer->vk.frame_count;
+    descriptor_pool_create_info.poolSizeCount = 1;
+    descriptor_pool_create_info.pPoolSizes = &descriptor_pool_size;
+
+    result = vkCreateDescriptorPool(renderer->vk.device, &descriptor_pool_create_info, NULL, &renderer->vk.uniform_pool);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkCreateDescriptorPool uniform");
+
+    VkDescriptorSetLayout descriptor_set_layout_all[CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX];
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        descriptor_set_layout_all[i] = renderer->vk.uniform_set_layout;
+    }
+
+    VkDescriptorSetAllocateInfo descriptor_set_allocate_info;
+    descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    descriptor_set_allocate_info.pNext = NULL;
+    descriptor_set_allocate_info.descriptorPool = renderer->vk.uniform_pool;
+    descriptor_set_allocate_info.descriptorSetCount = renderer->vk.frame_count;
+    descriptor_set_allocate_info.pSetLayouts = descriptor_set_layout_all;
+
+    result = vkAllocateDescriptorSets(renderer->vk.device, &descriptor_set_allocate_info, renderer->vk.uniform_set_all);
+    CNVX_VULKAN_ASSERT(renderer, result, "vkAllocateDescriptorSets uniform");
+
+    for (uint32_t i = 0; i < renderer->vk.frame_count; i++)
+    {
+        //the arena buffer has CNVX_RENDERER_UNIFORM_SIZE_MAX bytes of slack, so every offset inside the arena is valid
+        VkDescriptorBufferInfo descriptor_buffer_info;
+        descriptor_buffer_info.buffer = renderer->vk.memory_linear_buffer_all[i];
+        descriptor_buffer_info.offset = 0;
+        descriptor_buffer_info.range = CNVX_RENDERER_UNIFORM_SIZE_MAX;
+
+        VkWriteDescriptorSet write_descriptor_set_all[___CNVX_VULKAN_UNIFORM_BINDING_MAX];
+
+        for (uint32_t k = 0; k < ___CNVX_VULKAN_UNIFORM_BINDING_MAX; k++)
+        {
+            write_descriptor_set_all[k].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write_descriptor_set_all[k].pNext = NULL;
+            write_descriptor_set_all[k].dstSet = renderer->vk.uniform_set_all[i];
+            write_descriptor_set_all[k].dstBinding = k;
+            write_descriptor_set_all[k].dstArrayElement = 0;
+            write_descriptor_set_all[k].descriptorCount = 1;
+            write_descriptor_set_all[k].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+            write_descriptor_set_all[k].pImageInfo = NULL;
+            write_descriptor_set_all[k].pBufferInfo = &descriptor_buffer_info;
+            write_descriptor_set_all[k].pTexelBufferView = NULL;
+        }
+
+        vkUpdateDescriptorSets(renderer->vk.device, ___CNVX_VULKAN_UNIFORM_BINDING_MAX, write_descriptor_set_all, 0, NULL);
+    }
+
+    CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: uniform slices aligned to %lluB", (unsigned long long)renderer->vk.uniform_alignment);
+}
+
+void canvas_vulkan_uniform_destroy(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //destroying the pool frees the sets
+    vkDestroyDescriptorPool(renderer->vk.device, renderer->vk.uniform_pool, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyDescriptorPool uniform");
+
+    vkDestroyDescriptorSetLayout(renderer->vk.device, renderer->vk.uniform_set_layout, NULL);
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "vulkan: vkDestroyDescriptorSetLayout uniform");
+
+    CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "vulkan: uniform destruction");
+}
+
+void* canvas_vulkan_uniform_allocate(void* const renderer_, const size_t size_, uint32_t* const offset_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != offset_, CNVX_VULKAN_ERROR_NULL("offset"));
+    SPRX_ASSERT(CNVX_RENDERER_UNIFORM_SIZE_MAX >= size_, CNVX_VULKAN_ERROR_ARGUMENT("size has to be <=CNVX_RENDERER_UNIFORM_SIZE_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+
+    void* const data = canvas_vulkan_memory_linear_allocate(renderer, SPRX_MAX(size_, 1), renderer->vk.uniform_alignment, &buffer, &offset);
+
+    *offset_ = (uint32_t)offset;
+
+    return data;
+}
+
+void canvas_vulkan_uniform_frame_reset(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //first in the empty arena, so it can not fail
+    renderer->vk.uniform_frame_data = canvas_vulkan_uniform_allocate(renderer, sizeof(renderer->vk.uniform_frame), &renderer->vk.uniform_frame_offset);
+    renderer->vk.uniform_draw_offset = CNVX_VULKAN_UNIFORM_OFFSET_NONE;
+}
+
+void canvas_vulkan_uniform_frame_write(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(NULL != renderer->vk.uniform_frame_data, CNVX_VULKAN_ERROR_LOGIC("failed to write frame uniform", "frame has to be begun", NULL));
+
+    renderer->vk.uniform_frame.viewport[0] = 0.0f;
+    renderer->vk.uniform_frame.viewport[1] = 0.0f;
+    renderer->vk.uniform_frame.viewport[2] = (float)renderer->width;
+    renderer->vk.uniform_frame.viewport[3] = (float)renderer->height;
+
+    //persistently mapped and coherent, a plain copy is all it takes
+    memcpy(renderer->vk.uniform_frame_data, &renderer->vk.uniform_frame, sizeof(renderer->vk.uniform_frame));
+}
+
+void canvas_vulkan_uniform_draw_set(void* const renderer_, const void* const data_, const size_t size_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != data_ || 0 == size_, CNVX_VULKAN_ERROR_NULL("data"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_frame_begin(renderer);
+
+    uint32_t offset = 0;
+
+    void* const data = canvas_vulkan_uniform_allocate(renderer, size_, &offset);
+
+    //a full arena drops the draws as well, so they never read a stale block
+    if (NULL == data)
+    {
+        renderer->vk.uniform_draw_offset = CNVX_VULKAN_UNIFORM_OFFSET_INVALID;
+
+        return;
+    }
+
+    memcpy(data, data_, size_);
+
+    renderer->vk.uniform_draw_offset = offset;
+}
+
+void canvas_vulkan_uniform_bind(void* const renderer_, const VkCommandBuffer commandbuffer_, const uint32_t offset_draw_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_VULKAN_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    const uint32_t offset_all[___CNVX_VULKAN_UNIFORM_BINDING_MAX] = {
+        renderer->vk.uniform_frame_offset,
+        CNVX_VULKAN_UNIFORM_OFFSET_NONE != offset_draw_ ? offset_draw_ : renderer->vk.uniform_frame_offset,
+    };
+
+    vkCmdBindDescriptorSets(commandbuffer_, VK_PIPELINE_BIND_POINT_GRAPHICS, renderer->vk.pipeline_layout, CNVX_VULKAN_UNIFORM_SET, 1, &renderer->vk.uniform_set_all[renderer->vk.frame_index], ___CNVX_VULKAN_UNIFORM_BINDING_MAX, offset_all);
+}
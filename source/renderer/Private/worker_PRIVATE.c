@@ -0,0 +1,287 @@
+/************************************************************************************
+*                                                                                   *
+*   canvas - https://github.com/fkoppe/canvas                                       *
+*   ************************************************************************        *
+*                                                                                   *
+*   Copyright (C) 2022 - 2023 Felix Koppe <fkoppe@web.de>                           *
+*                                                                                   *
+*   This program is free software: you can redistribute it and/or modify            *
+*   it under the terms of the GNU Affero General Public License as published        *
+*   by the Free Software Foundation, either version 3 of the License, or            *
+*   (at your option) any later version.                                             *
+*                                                                                   *
+*   This program is distributed in the hope that it will be useful,                 *
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of                  *
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                   *
+*   GNU Affero General Public License for more details.                             *
+*                                                                                   *
+*   You should have received a copy of the GNU Affero General Public License        *
+*   along with this program.  If not, see <https://www.gnu.org/licenses/>.          *
+*                                                                                   *
+************************************************************************************/
+
+#include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/worker_PRIVATE.h"
+
+#include "sprx/container/string.h"
+#include "sprx/core/assert.h"
+#include "sprx/core/core.h"
+
+//the pool waits on condition variables from pthreads, other platforms run every job on submission
+#if defined(__linux__)
+    #include <pthread.h>
+    #include <unistd.h>
+#endif // __linux__
+
+#define CNVX_WORKER_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("worker", NULL, NULL)
+#define CNVX_WORKER_ERROR_RUNTIME(what, info, care) SPRX_ERROR_RUNTIME(what, "worker", info, care)
+#define CNVX_WORKER_ERROR_ARGUMENT(care) SPRX_ERROR_ARGUMENT("worker", NULL, care)
+#define CNVX_WORKER_ERROR_NULL(info) SPRX_ERROR_NULL("worker", info)
+
+typedef struct CNVX_Worker_PRIVATE
+{
+    size_t id;
+    void* name;
+    void* logger;
+    size_t thread_count;
+#if defined(__linux__)
+    pthread_t* thread_all;
+    pthread_mutex_t mutex;
+    pthread_cond_t condition_job;
+    pthread_cond_t condition_done;
+#endif // __linux__
+    CNVX_Worker_Job_PRIVATE* head;
+    CNVX_Worker_Job_PRIVATE* tail;
+    bool quit_is;
+} CNVX_Worker_PRIVATE;
+
+#if defined(__linux__)
+//has to be called with the mutex locked, returns with the mutex locked
+void canvas_worker_job_run_PRIVATE(void* const worker_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+    CNVX_Worker_Job_PRIVATE* const job = worker->head;
+
+    worker->head = job->next;
+    if (NULL == worker->head)
+    {
+        worker->tail = NULL;
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    job->function(job->argument, job->index);
+
+    pthread_mutex_lock(&worker->mutex);
+
+    job->done_is = true;
+    pthread_cond_broadcast(&worker->condition_done);
+}
+
+void* canvas_worker_thread_PRIVATE(void* const worker_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    while (true)
+    {
+        while (NULL == worker->head && !worker->quit_is)
+        {
+            pthread_cond_wait(&worker->condition_job, &worker->mutex);
+        }
+
+        if (NULL == worker->head)
+        {
+            break;
+        }
+
+        canvas_worker_job_run_PRIVATE(worker);
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+
+    return NULL;
+}
+#endif // __linux__
+
+void* canvas_worker_new(const size_t thread_count_, const size_t id_, void* const logger_)
+{
+    //logger is allowed to be =NULL
+
+    SPRX_ASSERT(CNVX_WORKER_THREAD_COUNT_MAX >= thread_count_, CNVX_WORKER_ERROR_ARGUMENT("thread_count has to be <=CNVX_WORKER_THREAD_COUNT_MAX"));
+
+    CNVX_Worker_PRIVATE* const worker = malloc(sizeof(*worker));
+    SPRX_ASSERT(NULL != worker, CNVX_WORKER_ERROR_ALLOCATION);
+
+    worker->id = id_;
+    worker->name = spore_string_new_f("canvas_worker_%llu", worker->id);
+    worker->logger = logger_;
+    worker->thread_count = thread_count_;
+    worker->head = NULL;
+    worker->tail = NULL;
+    worker->quit_is = false;
+
+#if defined(__linux__)
+    if (0 == worker->thread_count)
+    {
+        const long processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+        worker->thread_count = SPRX_MIN(SPRX_MAX(processor_count, 1), CNVX_WORKER_THREAD_COUNT_MAX);
+    }
+
+    SPRX_ASSERT(0 == pthread_mutex_init(&worker->mutex, NULL), CNVX_WORKER_ERROR_RUNTIME("failed to create worker", "pthread_mutex_init failed", NULL));
+    SPRX_ASSERT(0 == pthread_cond_init(&worker->condition_job, NULL), CNVX_WORKER_ERROR_RUNTIME("failed to create worker", "pthread_cond_init failed", NULL));
+    SPRX_ASSERT(0 == pthread_cond_init(&worker->condition_done, NULL), CNVX_WORKER_ERROR_RUNTIME("failed to create worker", "pthread_cond_init failed", NULL));
+
+    worker->thread_all = malloc(sizeof(*worker->thread_all) * worker->thread_count);
+    SPRX_ASSERT(NULL != worker->thread_all, CNVX_WORKER_ERROR_ALLOCATION);
+
+    for (size_t i = 0; i < worker->thread_count; i++)
+    {
+        SPRX_ASSERT(0 == pthread_create(&worker->thread_all[i], NULL, canvas_worker_thread_PRIVATE, worker), CNVX_WORKER_ERROR_RUNTIME("failed to create worker", "pthread_create failed", NULL));
+    }
+
+    CNVX_NLOGF(worker->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(worker->name, 7), "started %llu threads", (unsigned long long)worker->thread_count);
+#else
+    //the submitting thread is the only one, which keeps per thread resources sized for one
+    worker->thread_count = 1;
+
+    CNVX_NLOG(worker->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(worker->name, 7), "no threads on this platform, jobs run on submission");
+#endif // __linux__
+
+    return worker;
+}
+
+void canvas_worker_delete(void* const worker_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+#if defined(__linux__)
+    //queued jobs are still drained before the threads exit
+    pthread_mutex_lock(&worker->mutex);
+    worker->quit_is = true;
+    pthread_cond_broadcast(&worker->condition_job);
+    pthread_mutex_unlock(&worker->mutex);
+
+    for (size_t i = 0; i < worker->thread_count; i++)
+    {
+        pthread_join(worker->thread_all[i], NULL);
+    }
+
+    CNVX_NLOGF(worker->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(worker->name, 7), "joined %llu threads", (unsigned long long)worker->thread_count);
+
+    free(worker->thread_all);
+
+    pthread_cond_destroy(&worker->condition_done);
+    pthread_cond_destroy(&worker->condition_job);
+    pthread_mutex_destroy(&worker->mutex);
+#endif // __linux__
+
+    spore_string_delete(worker->name);
+
+    free(worker);
+}
+
+size_t canvas_worker_thread_count_get(void* const worker_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+    return worker->thread_count;
+}
+
+void canvas_worker_submit(void* const worker_, CNVX_Worker_Job_PRIVATE* const job_, const CNVX_Worker_Function_PRIVATE function_, void* const argument_, const size_t index_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+    SPRX_ASSERT(NULL != job_, CNVX_WORKER_ERROR_NULL("job"));
+    SPRX_ASSERT(NULL != function_, CNVX_WORKER_ERROR_NULL("function"));
+
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+    job_->function = function_;
+    job_->argument = argument_;
+    job_->index = index_;
+    job_->done_is = false;
+    job_->next = NULL;
+
+#if defined(__linux__)
+    pthread_mutex_lock(&worker->mutex);
+
+    SPRX_ASSERT(!worker->quit_is, CNVX_WORKER_ERROR_RUNTIME("failed to submit job", "worker is shutting down", NULL));
+
+    if (NULL == worker->tail)
+    {
+        worker->head = job_;
+    }
+    else
+    {
+        worker->tail->next = job_;
+    }
+
+    worker->tail = job_;
+
+    pthread_cond_signal(&worker->condition_job);
+    pthread_mutex_unlock(&worker->mutex);
+#else
+    SPRX_ASSERT(!worker->quit_is, CNVX_WORKER_ERROR_RUNTIME("failed to submit job", "worker is shutting down", NULL));
+
+    job_->function(job_->argument, job_->index);
+    job_->done_is = true;
+#endif // __linux__
+}
+
+bool canvas_worker_done_is(void* const worker_, CNVX_Worker_Job_PRIVATE* const job_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+    SPRX_ASSERT(NULL != job_, CNVX_WORKER_ERROR_NULL("job"));
+
+#if defined(__linux__)
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+    pthread_mutex_lock(&worker->mutex);
+    const bool done_is = job_->done_is;
+    pthread_mutex_unlock(&worker->mutex);
+
+    return done_is;
+#else
+    return job_->done_is;
+#endif // __linux__
+}
+
+void canvas_worker_wait(void* const worker_, CNVX_Worker_Job_PRIVATE* const job_)
+{
+    SPRX_ASSERT(NULL != worker_, CNVX_WORKER_ERROR_NULL("worker"));
+    SPRX_ASSERT(NULL != job_, CNVX_WORKER_ERROR_NULL("job"));
+
+#if defined(__linux__)
+    CNVX_Worker_PRIVATE* const worker = worker_;
+
+    pthread_mutex_lock(&worker->mutex);
+
+    while (!job_->done_is)
+    {
+        if (NULL != worker->head)
+        {
+            canvas_worker_job_run_PRIVATE(worker);
+        }
+        else
+        {
+            pthread_cond_wait(&worker->condition_done, &worker->mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&worker->mutex);
+#else
+    //jobs already ran on submission
+    SPRX_ASSERT(job_->done_is, CNVX_WORKER_ERROR_RUNTIME("failed to wait for job", "job was never submitted", NULL));
+#endif // __linux__
+}
@@ -21,8 +21,14 @@
 ************************************************************************************/
 
 #include "cnvx/logger/logger.h"
+#include "cnvx/renderer/Private/pacer_PRIVATE.h"
 #include "cnvx/renderer/Private/renderer_PRIVATE.h"
 #include "cnvx/renderer/Private/vulkan_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_deferred_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_memory_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_reload_PRIVATE.h"
+#include "cnvx/renderer/Private/vulkan_transfer_PRIVATE.h"
+#include "cnvx/renderer/Private/worker_PRIVATE.h"
 #include "cnvx/window/window.h"
 
 #include "sprx/container/string.h"
@@ -30,6 +36,7 @@
 #include "sprx/core/assert.h"
 #include "sprx/core/core.h"
 #include "sprx/file/file.h"
+#include "sprx/thread/mutex.h"
 
 #define CNVX_RENDERER_ERROR_ALLOCATION SPRX_ERROR_ALLOCATION("renderer", NULL, NULL)
 #define CNVX_RENDERER_ERROR_RUNTIME(what, info, care) SPRX_ERROR_RUNTIME(what, "renderer", info, care)
@@ -38,12 +45,51 @@
 #define CNVX_RENDERER_ERROR_NULL(info) SPRX_ERROR_NULL("renderer", info)
 #define CNVX_RENDERER_ERROR_ENUM(info) SPRX_ERROR_ENUM("renderer", info, NULL)
 
+void canvas_renderer_frame_pacing_update_PRIVATE(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    int64_t period = 0;
+
+    if (renderer->settings.frame_pacing_is)
+    {
+        if (0 != renderer->settings.frame_pacing_time_us)
+        {
+            period = (int64_t)renderer->settings.frame_pacing_time_us * 1000;
+        }
+        else if (NULL != renderer->window)
+        {
+            //the window may have moved to another monitor, so this is queried again on every resize
+            const double refresh_rate = canvas_window_refresh_rate_get(renderer->window);
+
+            period = 0.0 < refresh_rate ? (int64_t)(1e9 / refresh_rate) : 0;
+        }
+
+        if (0 == period)
+        {
+            CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_WARN, spore_string_substr(renderer->name, 7), "frame pacing disabled, refresh rate unknown");
+        }
+        else
+        {
+            CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "frame pacing targets %lluus", (unsigned long long)(period / 1000));
+        }
+    }
+
+    canvas_pacer_period_set(&renderer->pacer, period);
+}
+
 void* canvas_renderer_new(const CNVX_Renderer_Settings settings_, const char* const app_name_, const SPRX_VERSION app_version_, const char* const engine_name_, const SPRX_VERSION engine_version_, const size_t id_, void* const logger_)
 {
     //logger is allowed to be =NULL
 
     SPRX_ASSERT(NULL != app_name_, CNVX_RENDERER_ERROR_NULL("app_name"));
     SPRX_ASSERT(NULL != engine_name_, CNVX_RENDERER_ERROR_NULL("engine_name"));
+    SPRX_ASSERT(!settings_.headless_is || 0 != settings_.headless_width * settings_.headless_height, CNVX_RENDERER_ERROR_ARGUMENT("settings.headless_width and settings.headless_height have to be >0 in headless mode"));
+    SPRX_ASSERT(___CNVX_RENDERER_PRESENT_MODE_MAX > settings_.present_mode, CNVX_RENDERER_ERROR_ARGUMENT("settings.present_mode has to be <___CNVX_RENDERER_PRESENT_MODE_MAX"));
+    SPRX_ASSERT(0 == settings_.swapchain_buffer_count || (CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_MIN <= settings_.swapchain_buffer_count && CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_MAX >= settings_.swapchain_buffer_count), CNVX_RENDERER_ERROR_ARGUMENT("settings.swapchain_buffer_count has to be =0 or within [CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_MIN, CNVX_RENDERER_SWAPCHAIN_BUFFER_COUNT_MAX]"));
+    SPRX_ASSERT(CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX >= settings_.frame_in_flight_count, CNVX_RENDERER_ERROR_ARGUMENT("settings.frame_in_flight_count has to be <=CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX"));
 
     CNVX_Renderer_PRIVATE* const renderer = malloc(sizeof(*renderer));
     SPRX_ASSERT(NULL != renderer, CNVX_RENDERER_ERROR_ALLOCATION);
@@ -57,17 +103,37 @@ void* canvas_renderer_new(const CNVX_Renderer_Settings settings_, const char* co
     renderer->width = 0;
     renderer->height = 0;
     renderer->shader_vec = spore_vector_new(sizeof(CNVX_Renderer_Shader_PRIVATE));
+    renderer->draw_vec = spore_vector_new_c(sizeof(CNVX_Renderer_Draw_PRIVATE), CNVX_RENDERER_DRAW_GROWTH);
     renderer->logger = logger_;
     renderer->window = NULL;
+    renderer->worker = canvas_worker_new(settings_.worker_count, id_, logger_);
     renderer->started_is = false;
     renderer->prepared_is = false;
     renderer->settings = settings_;
 
+    canvas_pacer_reset(&renderer->pacer, 0);
+
     renderer->vk.swapchain = VK_NULL_HANDLE;
+    renderer->vk.swapchain_image_all_count = 0;
+    renderer->vk.present_mode_use = CNVX_RENDERER_PRESENT_MODE_FIFO;
+    //asserted above, clamped anyway so the narrowing to the vulkan side can never wrap
+    renderer->vk.frame_count = 0 != settings_.frame_in_flight_count ? (uint32_t)SPRX_MIN(settings_.frame_in_flight_count, (size_t)CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_MAX) : CNVX_RENDERER_FRAME_IN_FLIGHT_COUNT_DEFAULT;
+    renderer->vk.frame_index = 0;
+    renderer->vk.frame_begun_is = false;
+    renderer->vk.pipeline_draw_state = (CNVX_Renderer_Draw_State){ CNVX_RENDERER_BLEND_ALPHA, CNVX_RENDERER_TOPOLOGY_TRIANGLE_LIST, CNVX_RENDERER_CULL_BACK };
 
     canvas_vulkan_instance_create(renderer);
     canvas_vulkan_physical_devices_enumerate(renderer);
+    canvas_vulkan_physical_device_select(renderer);
     canvas_vulkan_device_create(renderer);
+    canvas_vulkan_pipeline_cache_create(renderer);
+    canvas_vulkan_memory_create(renderer);
+    canvas_vulkan_deferred_create(renderer);
+    canvas_vulkan_descriptor_create(renderer);
+    canvas_vulkan_uniform_create(renderer);
+    canvas_vulkan_texture_create(renderer);
+    canvas_vulkan_transfer_create(renderer);
+    canvas_vulkan_quad_create(renderer);
 
     return renderer;
 }
@@ -78,10 +144,33 @@ void canvas_renderer_delete(void* const renderer_)
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
+    canvas_vulkan_texture_destroy(renderer);
+    canvas_vulkan_transfer_destroy(renderer);
+    canvas_vulkan_quad_destroy(renderer);
+    canvas_vulkan_deferred_destroy(renderer);
+    canvas_vulkan_descriptor_destroy(renderer);
+    canvas_vulkan_uniform_destroy(renderer);
+    canvas_vulkan_memory_destroy(renderer);
+    canvas_vulkan_pipeline_cache_destroy(renderer);
     canvas_vulkan_device_destroy(renderer);
     canvas_vulkan_physical_devices_denumerate(renderer);
     canvas_vulkan_instance_destroy(renderer);
 
+    canvas_worker_delete(renderer->worker);
+
+    for (size_t i = 0; i < spore_vector_size(renderer->shader_vec); i++)
+    {
+        CNVX_Renderer_Shader_PRIVATE* const shader = SPRX_VECTOR_AT(renderer->shader_vec, i, CNVX_Renderer_Shader_PRIVATE);
+
+        if (shader->owned_is)
+        {
+            free((char*)shader->data);
+        }
+
+        spore_string_delete(shader->path);
+    }
+
+    spore_vector_delete(renderer->draw_vec);
     spore_vector_delete(renderer->shader_vec);
     spore_string_delete(renderer->name);
 
@@ -91,9 +180,11 @@ void canvas_renderer_delete(void* const renderer_)
 void canvas_renderer_start(void* const renderer_, void* const window_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
-    SPRX_ASSERT(NULL != window_, CNVX_RENDERER_ERROR_NULL("window"));
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->settings.headless_is || NULL != window_, CNVX_RENDERER_ERROR_NULL("window"));
+
     renderer->window = window_;
 
     if (!renderer->started_is)
@@ -102,22 +193,45 @@ void canvas_renderer_start(void* const renderer_, void* const window_)
 
         renderer->started_is = true;
 
-        SPRX_ASSERT(canvas_window_open_is(renderer->window), CNVX_RENDERER_ERROR_LOGIC("failed to start renderer", "window is not opened", NULL));
+        if (renderer->settings.headless_is)
+        {
+            renderer->width = renderer->settings.headless_width;
+            renderer->height = renderer->settings.headless_height;
+
+            canvas_vulkan_headless_create(renderer);
+        }
+        else
+        {
+            SPRX_ASSERT(canvas_window_open_is(renderer->window), CNVX_RENDERER_ERROR_LOGIC("failed to start renderer", "window is not opened", NULL));
 
-        canvas_vulkan_surface_create(renderer);
+            canvas_vulkan_surface_create(renderer);
 
-        canvas_window_framebuffer_size_get(renderer->window, &renderer->width, &renderer->height);
+            canvas_window_framebuffer_size_get(renderer->window, &renderer->width, &renderer->height);
+
+            canvas_vulkan_swapchain_create(renderer);
+        }
 
-        canvas_vulkan_swapchain_create(renderer);
         canvas_vulkan_imageviews_create(renderer);
         canvas_vulkan_shader_create(renderer);
         canvas_vulkan_pipeline_create(renderer);
+        canvas_vulkan_reload_create(renderer);
         canvas_vulkan_framebuffer_create(renderer);
         canvas_vulkan_commandpool_create(renderer);
         canvas_vulkan_commandbuffer_create(renderer);
-        canvas_vulkan_commandbuffer_record(renderer);
         canvas_vulkan_semaphore_create(renderer);
 
+        if (!renderer->settings.headless_is)
+        {
+            canvas_vulkan_semaphore_rendering_done_create(renderer);
+        }
+
+        canvas_vulkan_fence_create(renderer);
+        canvas_vulkan_readback_create(renderer);
+        canvas_vulkan_timestamp_create(renderer);
+        canvas_vulkan_frame_graph_create(renderer);
+
+        canvas_renderer_frame_pacing_update_PRIVATE(renderer);
+
         renderer->prepared_is = true;
 
         CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "finish initialisation");
@@ -137,25 +251,47 @@ void canvas_renderer_stop(void* const renderer_)
 
         vkDeviceWaitIdle(renderer->vk.device);
 
-        canvas_vulkan_semaphore_destroy(renderer);
+        canvas_vulkan_frame_graph_destroy(renderer);
+
+        canvas_vulkan_deferred_collect(renderer, true);
+
+        canvas_vulkan_timestamp_destroy(renderer);
+        canvas_vulkan_readback_destroy(renderer);
+        canvas_vulkan_fence_destroy(renderer);
+        canvas_vulkan_commandbuffer_destroy(renderer);
+        canvas_vulkan_commandpool_destroy(renderer);
 
         if (renderer->prepared_is)
         {
-            canvas_vulkan_commandbuffer_destroy(renderer);
-            canvas_vulkan_commandpool_destroy(renderer);
+            if (!renderer->settings.headless_is)
+            {
+                canvas_vulkan_semaphore_rendering_done_destroy(renderer);
+            }
+
             canvas_vulkan_framebuffer_destroy(renderer);
         }
 
+        canvas_vulkan_semaphore_destroy(renderer);
+        canvas_vulkan_reload_destroy(renderer);
         canvas_vulkan_pipeline_destroy(renderer);
         canvas_vulkan_shader_destroy(renderer);
 
         if (renderer->prepared_is)
         {
             canvas_vulkan_imageviews_destroy(renderer);
-            canvas_vulkan_swapchain_destroy(renderer);
         }
 
-        canvas_vulkan_surface_destroy(renderer);
+        if (renderer->settings.headless_is)
+        {
+            canvas_vulkan_headless_destroy(renderer);
+        }
+        else
+        {
+            //the swapchain outlives the per image resources while minimized
+            canvas_vulkan_swapchain_destroy(renderer);
+
+            canvas_vulkan_surface_destroy(renderer);
+        }
 
         renderer->prepared_is = false;
         renderer->started_is = false;
@@ -172,6 +308,40 @@ void canvas_renderer_update(void* const renderer_)
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
     canvas_vulkan_frame_draw(renderer);
+
+    //the next frame starts here, so the input polled after the return is as fresh as the pacing allows
+    if (renderer->started_is && renderer->prepared_is)
+    {
+        canvas_pacer_wait(&renderer->pacer);
+    }
+}
+
+void canvas_renderer_frame_begin(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (renderer->started_is && renderer->prepared_is)
+    {
+        //returns right away if the last frame_end or update already waited
+        canvas_pacer_wait(&renderer->pacer);
+        canvas_vulkan_frame_begin(renderer);
+    }
+}
+
+void canvas_renderer_frame_end(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    canvas_vulkan_frame_draw(renderer);
+
+    if (renderer->started_is && renderer->prepared_is)
+    {
+        canvas_pacer_wait(&renderer->pacer);
+    }
 }
 
 void canvas_renderer_resize(void* const renderer_)
@@ -180,18 +350,15 @@ void canvas_renderer_resize(void* const renderer_)
 
     CNVX_Renderer_PRIVATE* const renderer = renderer_;
 
-    if (renderer->started_is)
+    //headless images keep the size requested in the settings
+    if (renderer->started_is && !renderer->settings.headless_is)
     {
         CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "start resize");
 
-        vkDeviceWaitIdle(renderer->vk.device);
-
+        //frames in flight keep using the retired resources, they are destroyed once their fences signaled
         if (renderer->prepared_is)
         {
-            canvas_vulkan_commandbuffer_destroy(renderer);
-            canvas_vulkan_commandpool_destroy(renderer);
-            canvas_vulkan_framebuffer_destroy(renderer);
-            canvas_vulkan_imageviews_destroy(renderer);
+            canvas_vulkan_swapchain_retire(renderer);
 
             renderer->prepared_is = false;
         }
@@ -199,25 +366,26 @@ void canvas_renderer_resize(void* const renderer_)
         CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "starting swapchain recreation");
         canvas_window_framebuffer_size_get(renderer->window, &renderer->width, &renderer->height);
 
-        VkSwapchainKHR swapchain_old = renderer->vk.swapchain;
-
         if (renderer->width * renderer->height)
         {
+            //the old swapchain is handed over as oldSwapchain and retired as well
             canvas_vulkan_swapchain_create(renderer);
 
-            vkDestroySwapchainKHR(renderer->vk.device, swapchain_old, NULL);
             CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "finish swapchain recreation");
             CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_TRACE, spore_string_substr(renderer->name, 7), "swapchain recreation");
 
             canvas_vulkan_imageviews_create(renderer);
             canvas_vulkan_framebuffer_create(renderer);
-            canvas_vulkan_commandpool_create(renderer);
-            canvas_vulkan_commandbuffer_create(renderer);
-            canvas_vulkan_commandbuffer_record(renderer);
+            canvas_vulkan_semaphore_rendering_done_create(renderer);
+
+            //transient images follow the new extent
+            canvas_vulkan_graph_allocate(renderer);
 
             renderer->prepared_is = true;
         }
 
+        canvas_renderer_frame_pacing_update_PRIVATE(renderer);
+
         canvas_vulkan_frame_draw(renderer);
 
         CNVX_NLOG(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "finish resize");
@@ -225,6 +393,128 @@ void canvas_renderer_resize(void* const renderer_)
     }
 }
 
+void canvas_renderer_present_mode_set(void* const renderer_, const CNVX_Renderer_Present_Mode present_mode_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(___CNVX_RENDERER_PRESENT_MODE_MAX > present_mode_, CNVX_RENDERER_ERROR_ARGUMENT("present_mode has to be <___CNVX_RENDERER_PRESENT_MODE_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (present_mode_ != renderer->settings.present_mode)
+    {
+        renderer->settings.present_mode = present_mode_;
+
+        //the present mode is fixed at swapchain creation
+        canvas_renderer_resize(renderer);
+    }
+}
+
+CNVX_Renderer_Present_Mode canvas_renderer_present_mode_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    return renderer->vk.present_mode_use;
+}
+
+size_t canvas_renderer_swapchain_image_count_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    return renderer->started_is ? renderer->vk.swapchain_image_all_count : 0;
+}
+
+void canvas_renderer_readback_request(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    renderer->vk.readback_requested_is = true;
+}
+
+bool canvas_renderer_readback_get(void* const renderer_, CNVX_Renderer_Readback* const readback_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != readback_, CNVX_RENDERER_ERROR_NULL("readback"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (!renderer->started_is)
+    {
+        return false;
+    }
+
+    return canvas_vulkan_readback_get(renderer, readback_);
+}
+
+void canvas_renderer_readback_release(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    if (renderer->started_is)
+    {
+        canvas_vulkan_readback_release(renderer);
+    }
+}
+
+CNVX_Renderer_Pipeline_Cache_Stats canvas_renderer_pipeline_cache_stats_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.pipeline_cache_mutex);
+    const CNVX_Renderer_Pipeline_Cache_Stats stats = renderer->vk.pipeline_cache_stats;
+    spore_mutex_unlock(renderer->vk.pipeline_cache_mutex);
+
+    return stats;
+}
+
+CNVX_Renderer_Timestamp_Stats canvas_renderer_timestamp_stats_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to get timestamp stats", "renderer has to be started", NULL));
+
+    return canvas_vulkan_timestamp_stats_get(renderer);
+}
+
+CNVX_Renderer_Frame_Pacing_Stats canvas_renderer_frame_pacing_stats_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    CNVX_Renderer_Frame_Pacing_Stats stats;
+    stats.frame_time = renderer->pacer.period * 1e-6;
+    stats.work_time = renderer->pacer.work_estimate * 1e-6;
+    stats.frame_count = renderer->pacer.frame_count;
+    stats.missed_count = renderer->pacer.missed_count;
+
+    return stats;
+}
+
+CNVX_Renderer_Memory_Stats canvas_renderer_memory_stats_get(void* const renderer_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    spore_mutex_lock(renderer->vk.memory_mutex);
+    const CNVX_Renderer_Memory_Stats stats = renderer->vk.memory_stats;
+    spore_mutex_unlock(renderer->vk.memory_mutex);
+
+    return stats;
+}
+
 void canvas_renderer_shader_load(void* const renderer_, const CNVX_Renderer_Shader_Type shader_type_, const char* const path_)
 {
     SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
@@ -243,6 +533,8 @@ void canvas_renderer_shader_load(void* const renderer_, const CNVX_Renderer_Shad
 
     CNVX_Renderer_Shader_PRIVATE shader;
     shader.type = shader_type_;
+    shader.path = spore_string_new_cstr(path_);
+    shader.owned_is = false;
 
     size_t size = 0;
     SPRX_ASSERT(SPRX_FILE_RESULT_SUCCESS == spore_file_size_get(file, &size), CNVX_RENDERER_ERROR_RUNTIME("failed to load shader", "could not get file size", NULL));
@@ -258,3 +550,149 @@ void canvas_renderer_shader_load(void* const renderer_, const CNVX_Renderer_Shad
 
     CNVX_NLOGF(renderer->logger, CNVX_LOGGER_LEVEL_DEBUG, spore_string_substr(renderer->name, 7), "successfully loaded shader_%llu", spore_vector_size(renderer->shader_vec) - 1);
 }
+
+void canvas_renderer_frame_uniform_set(void* const renderer_, const CNVX_Renderer_Frame_Uniform* const uniform_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != uniform_, CNVX_RENDERER_ERROR_NULL("uniform"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    renderer->vk.uniform_frame = *uniform_;
+}
+
+void canvas_renderer_draw_uniform_set(void* const renderer_, const void* const data_, const size_t size_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != data_, CNVX_RENDERER_ERROR_NULL("data"));
+    SPRX_ASSERT(CNVX_RENDERER_UNIFORM_SIZE_MAX >= size_, CNVX_RENDERER_ERROR_ARGUMENT("size has to be <=CNVX_RENDERER_UNIFORM_SIZE_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to set draw uniform", "renderer has to be started", NULL));
+
+    canvas_vulkan_uniform_draw_set(renderer, data_, size_);
+}
+
+void canvas_renderer_draw_state_set(void* const renderer_, const CNVX_Renderer_Draw_State* const state_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != state_, CNVX_RENDERER_ERROR_NULL("state"));
+    SPRX_ASSERT(___CNVX_RENDERER_BLEND_MAX > state_->blend, CNVX_RENDERER_ERROR_ENUM("invalid value of blend"));
+    SPRX_ASSERT(___CNVX_RENDERER_TOPOLOGY_MAX > state_->topology, CNVX_RENDERER_ERROR_ENUM("invalid value of topology"));
+    SPRX_ASSERT(___CNVX_RENDERER_CULL_MAX > state_->cull, CNVX_RENDERER_ERROR_ENUM("invalid value of cull"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    //the variant is looked up on submission, so nothing is built for states that are never drawn with
+    renderer->vk.pipeline_draw_state = *state_;
+}
+
+uint32_t canvas_renderer_texture_create(void* const renderer_, const void* const pixel_all_, const size_t width_, const size_t height_, const bool mip_is_, const CNVX_Renderer_Texture_Filter filter_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != pixel_all_, CNVX_RENDERER_ERROR_NULL("pixel_all"));
+    SPRX_ASSERT(0 != width_ && UINT32_MAX >= width_, CNVX_RENDERER_ERROR_ARGUMENT("width has to be >0"));
+    SPRX_ASSERT(0 != height_ && UINT32_MAX >= height_, CNVX_RENDERER_ERROR_ARGUMENT("height has to be >0"));
+    SPRX_ASSERT(___CNVX_RENDERER_TEXTURE_FILTER_MAX > filter_, CNVX_RENDERER_ERROR_ENUM("invalid value of texture filter"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to create texture", "renderer has to be started", NULL));
+
+    return canvas_vulkan_texture_new(renderer, pixel_all_, (uint32_t)width_, (uint32_t)height_, mip_is_, filter_);
+}
+
+void canvas_renderer_texture_destroy(void* const renderer_, const uint32_t texture_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+
+    canvas_vulkan_texture_delete(renderer_, texture_index_);
+}
+
+bool canvas_renderer_atlas_insert(void* const renderer_, const uint64_t key_, const void* const pixel_all_, const size_t width_, const size_t height_, CNVX_Renderer_Atlas_Region* const region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != pixel_all_, CNVX_RENDERER_ERROR_NULL("pixel_all"));
+    SPRX_ASSERT(0 != width_ && UINT32_MAX >= width_, CNVX_RENDERER_ERROR_ARGUMENT("width has to be >0"));
+    SPRX_ASSERT(0 != height_ && UINT32_MAX >= height_, CNVX_RENDERER_ERROR_ARGUMENT("height has to be >0"));
+    SPRX_ASSERT(NULL != region_, CNVX_RENDERER_ERROR_NULL("region"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to insert into atlas", "renderer has to be started", NULL));
+
+    return canvas_vulkan_texture_atlas_insert(renderer, key_, pixel_all_, (uint32_t)width_, (uint32_t)height_, region_);
+}
+
+bool canvas_renderer_atlas_get(void* const renderer_, const uint64_t key_, CNVX_Renderer_Atlas_Region* const region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != region_, CNVX_RENDERER_ERROR_NULL("region"));
+
+    return canvas_vulkan_texture_atlas_get(renderer_, key_, region_);
+}
+
+void canvas_renderer_geometry_submit(void* const renderer_, const CNVX_Renderer_Vertex* const vertex_all_, const size_t vertex_count_, const uint32_t* const index_all_, const size_t index_count_)
+{
+    canvas_renderer_geometry_textured_submit(renderer_, vertex_all_, vertex_count_, index_all_, index_count_, 0);
+}
+
+void canvas_renderer_geometry_textured_submit(void* const renderer_, const CNVX_Renderer_Vertex* const vertex_all_, const size_t vertex_count_, const uint32_t* const index_all_, const size_t index_count_, const uint32_t texture_index_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != vertex_all_ || 0 == vertex_count_, CNVX_RENDERER_ERROR_NULL("vertex_all"));
+    SPRX_ASSERT(NULL != index_all_ || 0 == index_count_, CNVX_RENDERER_ERROR_NULL("index_all"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to submit geometry", "renderer has to be started", NULL));
+
+    if (0 == vertex_count_ || (NULL != index_all_ && 0 == index_count_))
+    {
+        return;
+    }
+
+    canvas_vulkan_geometry_submit(renderer, vertex_all_, vertex_count_, index_all_, index_count_, texture_index_);
+}
+
+void canvas_renderer_quad_submit(void* const renderer_, const CNVX_Renderer_Quad* const quad_all_, const size_t quad_count_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(NULL != quad_all_ || 0 == quad_count_, CNVX_RENDERER_ERROR_NULL("quad_all"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to submit quads", "renderer has to be started", NULL));
+
+    if (0 == quad_count_)
+    {
+        return;
+    }
+
+    canvas_vulkan_quad_submit(renderer, quad_all_, quad_count_);
+}
+
+void canvas_renderer_timestamp_region_begin(void* const renderer_, const uint32_t region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX > region_, CNVX_RENDERER_ERROR_ARGUMENT("region has to be <CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to begin timestamp region", "renderer has to be started", NULL));
+
+    canvas_vulkan_timestamp_region_begin(renderer, region_);
+}
+
+void canvas_renderer_timestamp_region_end(void* const renderer_, const uint32_t region_)
+{
+    SPRX_ASSERT(NULL != renderer_, CNVX_RENDERER_ERROR_NULL("renderer"));
+    SPRX_ASSERT(CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX > region_, CNVX_RENDERER_ERROR_ARGUMENT("region has to be <CNVX_RENDERER_TIMESTAMP_REGION_COUNT_MAX"));
+
+    CNVX_Renderer_PRIVATE* const renderer = renderer_;
+
+    SPRX_ASSERT(renderer->started_is, CNVX_RENDERER_ERROR_LOGIC("failed to end timestamp region", "renderer has to be started", NULL));
+
+    canvas_vulkan_timestamp_region_end(renderer, region_);
+}
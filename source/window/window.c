@@ -577,6 +577,52 @@ void canvas_window_framebuffer_size_get(void* const window_, size_t* const width
     }
 }
 
+double canvas_window_refresh_rate_get(void* const window_)
+{
+    SPRX_ASSERT(NULL != window_, CNVX_WINDOW_ERROR_NULL("window"));
+
+    CNVX_Window_PRIVATE* const window = window_;
+
+    //fullscreen windows know their monitor, windowed ones are matched by position
+    GLFWmonitor* monitor = glfwGetWindowMonitor(window->handle);
+
+    if (NULL == monitor)
+    {
+        int x = 0;
+        int y = 0;
+        glfwGetWindowPos(window->handle, &x, &y);
+
+        const int center_x = x + (int)window->width / 2;
+        const int center_y = y + (int)window->height / 2;
+
+        int monitor_count = 0;
+        GLFWmonitor** const monitor_all = glfwGetMonitors(&monitor_count);
+
+        for (int i = 0; i < monitor_count && NULL == monitor; i++)
+        {
+            const GLFWvidmode* const mode = glfwGetVideoMode(monitor_all[i]);
+
+            int monitor_x = 0;
+            int monitor_y = 0;
+            glfwGetMonitorPos(monitor_all[i], &monitor_x, &monitor_y);
+
+            if (NULL != mode && center_x >= monitor_x && center_x < monitor_x + mode->width && center_y >= monitor_y && center_y < monitor_y + mode->height)
+            {
+                monitor = monitor_all[i];
+            }
+        }
+    }
+
+    if (NULL == monitor)
+    {
+        monitor = glfwGetPrimaryMonitor();
+    }
+
+    const GLFWvidmode* const mode = NULL != monitor ? glfwGetVideoMode(monitor) : NULL;
+
+    return NULL != mode ? mode->refreshRate : 0.0;
+}
+
 void canvas_window_position_get(void* const window_, size_t* const x_dest_, size_t* const y_dest_)
 {
     SPRX_ASSERT(NULL != window_, CNVX_WINDOW_ERROR_NULL("window"));